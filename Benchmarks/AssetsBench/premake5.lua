@@ -0,0 +1,52 @@
+project "AssetsBench"
+	kind "ConsoleApp"
+
+	targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+
+	-- Relative paths (baseline.json and the sandbox assets) resolve against the project folder when started from the IDE
+	debugdir "%{prj.location}"
+
+	apply_simd_flags()
+
+	defines
+	{
+		"TRACY_ENABLE",
+		"TRACY_ON_DEMAND",
+		"TRACY_CALLSTACK=10"
+	}
+
+	files
+	{
+		"src/**.h",
+		"src/**.hpp",
+		"src/**.cpp"
+	}
+
+	includedirs
+	{
+		"src",
+		"%{wks.location}/CommonUtilities/src",
+		"%{wks.location}/vendor",
+		"%{wks.location}/vendor/spdlog/include",
+		"%{wks.location}/vendor/tracy/tracy",
+		"%{wks.location}/vendor/yaml-cpp/include",
+		"%{wks.location}/vendor/assimp/include",
+		"%{wks.location}/Epoch/Core/src",
+		"%{wks.location}/Epoch/DataTypes/src",
+		"%{wks.location}/Epoch/Assets/src",
+		"%{wks.location}/Benchmarks/BenchmarkCore/src",
+	}
+
+	links
+	{
+		"EpochAssets",
+		"EpochDataTypes",
+		"BenchmarkCore",
+	}
+
+	filter "configurations:Debug"
+		postbuildcommands { "{COPYFILE} %{wks.location}vendor/assimp/bin/Debug/assimp-vc143-mtd.dll %{wks.location}bin/" .. outputdir .. "/%{prj.name}" }
+
+	filter "configurations:Release or configurations:Dist"
+		postbuildcommands { "{COPYFILE} %{wks.location}vendor/assimp/bin/Release/assimp-vc143-mt.dll %{wks.location}bin/" .. outputdir .. "/%{prj.name}" }
@@ -0,0 +1,262 @@
+#include "Benchmarks.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <EpochCore/JobSystem.h>
+#include <EpochAssets/AssetManager.h>
+#include <EpochAssets/Assets/TextureAsset.h>
+
+namespace AssetsBench
+{
+	namespace
+	{
+		using Epoch::AssetHandle;
+		using Epoch::Assets::Asset;
+		using Epoch::Assets::EditorAssetManager;
+		using Epoch::Assets::TextureAsset;
+		using Epoch::Core::JobSystem;
+
+		// Memory only assets looked up by the benchmarks, about what a level keeps loaded
+		constexpr uint32_t AssetCount = 4096;
+		constexpr uint32_t LookupCount = 1 << 16;
+		// One lookup in this many adds and removes a sub asset in the benchmark with a writer
+		constexpr uint32_t WriteInterval = 1024;
+
+		// Textures spread over nested folders, each with a .meta, like a project opened before
+		constexpr uint32_t RegisterFolderCount = 32;
+		constexpr uint32_t RegisterFilesPerFolder = 64;
+
+		constexpr uint32_t StressThreadCount = 8;
+		constexpr uint32_t StressFileCount = 64;
+		constexpr uint32_t StressRounds = 16;
+
+		// A white 1x1 texture, decoding it is quick so the stress test is about the manager
+		constexpr uint8_t PixelPNG[] =
+		{
+			0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x01,
+			0x00, 0x00, 0x00, 0x01, 0x08, 0x06, 0x00, 0x00, 0x00, 0x1f, 0x15, 0xc4, 0x89, 0x00, 0x00, 0x00, 0x0b, 0x49, 0x44, 0x41,
+			0x54, 0x78, 0xda, 0x63, 0xf8, 0x0f, 0x04, 0x00, 0x09, 0xfb, 0x03, 0xfd, 0x68, 0xfa, 0x1c, 0xcc, 0x00, 0x00, 0x00, 0x00,
+			0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+		};
+
+		// 1, 2, 4 and so on up to the core count, which is always included
+		std::vector<uint32_t> GetThreadCounts()
+		{
+			const uint32_t coreCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+			std::vector<uint32_t> threadCounts;
+			for (uint32_t count = 1; count < coreCount; count *= 2)
+			{
+				threadCounts.emplace_back(count);
+			}
+			threadCounts.emplace_back(coreCount);
+			return threadCounts;
+		}
+
+		void WritePNG(const std::filesystem::path& aPath)
+		{
+			std::ofstream stream(aPath, std::ios::binary);
+			stream.write(reinterpret_cast<const char*>(PixelPNG), sizeof(PixelPNG));
+		}
+	}
+
+	bool RunAssetManagerStressTest()
+	{
+		const std::filesystem::path directory = std::filesystem::temp_directory_path() / "EpochAssetsBench";
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+
+		for (uint32_t i = 0; i < StressFileCount; ++i)
+		{
+			WritePNG(directory / ("Registered" + std::to_string(i) + ".png"));
+		}
+
+		JobSystem::Initialize(std::max(std::thread::hardware_concurrency(), 4u));
+
+		auto assetManager = std::make_shared<EditorAssetManager>();
+		Epoch::Assets::AssetManager::SetActiveAssetManager(assetManager);
+		assetManager->Init(directory);
+
+		// Imported by every thread at once, only one handle per file may come out of it
+		for (uint32_t i = 0; i < StressFileCount; ++i)
+		{
+			WritePNG(directory / ("Imported" + std::to_string(i) + ".png"));
+		}
+
+		std::vector<AssetHandle> registered(StressFileCount);
+		for (uint32_t i = 0; i < StressFileCount; ++i)
+		{
+			registered[i] = assetManager->GetMetadata(directory / ("Registered" + std::to_string(i) + ".png")).Handle;
+		}
+
+		std::atomic<uint32_t> failures = 0;
+		std::vector<std::vector<AssetHandle>> imported(StressThreadCount, std::vector<AssetHandle>(StressFileCount));
+		std::vector<std::vector<std::shared_ptr<Asset>>> loaded(StressThreadCount, std::vector<std::shared_ptr<Asset>>(StressFileCount));
+
+		// Every thread imports, loads, and adds and removes sub assets, in its own order so they collide on different assets
+		std::vector<std::thread> threads;
+		for (uint32_t thread = 0; thread < StressThreadCount; ++thread)
+		{
+			threads.emplace_back([&, thread]()
+				{
+					for (uint32_t round = 0; round < StressRounds; ++round)
+					{
+						for (uint32_t j = 0; j < StressFileCount; ++j)
+						{
+							const uint32_t i = (j + thread * 7) % StressFileCount;
+
+							if (round == 0)
+							{
+								imported[thread][i] = assetManager->ImportAsset(directory / ("Imported" + std::to_string(i) + ".png"));
+								assetManager->GetAssetAsync(imported[thread][i]);
+							}
+
+							auto asset = assetManager->GetAsset(registered[i]);
+							if (!asset || (loaded[thread][i] && loaded[thread][i] != asset)) failures.fetch_add(1);
+							loaded[thread][i] = asset;
+
+							auto subAsset = std::make_shared<TextureAsset>(AssetHandle());
+							assetManager->AddSubAsset(registered[i], subAsset, "Stress");
+							if (assetManager->GetAsset(subAsset->GetHandle()) != subAsset) failures.fetch_add(1);
+
+							assetManager->RemoveAsset(subAsset->GetHandle());
+							if (assetManager->GetAsset(subAsset->GetHandle())) failures.fetch_add(1);
+						}
+					}
+				});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		for (uint32_t i = 0; i < StressFileCount; ++i)
+		{
+			for (uint32_t thread = 0; thread < StressThreadCount; ++thread)
+			{
+				if (imported[thread][i] != imported[0][i] || imported[thread][i] == 0) failures.fetch_add(1);
+				if (loaded[thread][i] != loaded[0][i]) failures.fetch_add(1);
+			}
+
+			if (!assetManager->GetAsset(imported[0][i])) failures.fetch_add(1);
+			if (!assetManager->GetSubAssets(registered[i]).empty()) failures.fetch_add(1);
+		}
+
+		Epoch::Assets::AssetManager::SetActiveAssetManager(nullptr);
+		assetManager.reset();
+		JobSystem::Shutdown();
+
+		std::filesystem::remove_all(directory);
+
+		std::printf("AssetManager stress test: %u threads, %u failures\n", StressThreadCount, failures.load());
+		return failures.load() == 0;
+	}
+
+	void RunAssetManagerBenchmarks(Bench::Runner& aRunner)
+	{
+		EditorAssetManager assetManager;
+
+		std::vector<AssetHandle> handles;
+		for (uint32_t i = 0; i < AssetCount; ++i)
+		{
+			auto asset = std::make_shared<TextureAsset>(AssetHandle());
+			handles.emplace_back(asset->GetHandle());
+			assetManager.AddMemoryOnlyAsset(asset, "Texture");
+		}
+
+		for (uint32_t threadCount : GetThreadCounts())
+		{
+			JobSystem::Initialize(threadCount);
+			const std::string threads = std::to_string(threadCount) + "Threads";
+
+			// Compare the same benchmark between thread counts for the contention
+			aRunner.Run("AssetManager/GetAsset/Loaded/64K/Spread/" + threads, [&]()
+				{
+					JobSystem::ParallelFor(LookupCount, [&](uint32_t aBegin, uint32_t aEnd)
+						{
+							for (uint32_t i = aBegin; i < aEnd; ++i)
+							{
+								Bench::DoNotOptimize(assetManager.GetAsset(handles[(i * 2654435761u) % AssetCount]));
+							}
+						}, 1024);
+				}, LookupCount);
+
+			// Every thread on the same shard and the same reference count
+			aRunner.Run("AssetManager/GetAsset/Loaded/64K/SameAsset/" + threads, [&]()
+				{
+					JobSystem::ParallelFor(LookupCount, [&](uint32_t aBegin, uint32_t aEnd)
+						{
+							for (uint32_t i = aBegin; i < aEnd; ++i)
+							{
+								Bench::DoNotOptimize(assetManager.GetAsset(handles[0]));
+							}
+						}, 1024);
+				}, LookupCount);
+
+			// Lookups while sub assets come and go, like models importing on other threads
+			aRunner.Run("AssetManager/GetAsset/Loaded/64K/WhileAdding/" + threads, [&]()
+				{
+					JobSystem::ParallelFor(LookupCount, [&](uint32_t aBegin, uint32_t aEnd)
+						{
+							for (uint32_t i = aBegin; i < aEnd; ++i)
+							{
+								if (i % WriteInterval == 0)
+								{
+									auto subAsset = std::make_shared<TextureAsset>(AssetHandle());
+									assetManager.AddSubAsset(handles[i % AssetCount], subAsset, "Texture");
+									assetManager.RemoveAsset(subAsset->GetHandle());
+								}
+
+								Bench::DoNotOptimize(assetManager.GetAsset(handles[(i * 2654435761u) % AssetCount]));
+							}
+						}, 1024);
+				}, LookupCount);
+
+			JobSystem::Shutdown();
+		}
+	}
+
+	void RunAssetRegistrationBenchmarks(Bench::Runner& aRunner)
+	{
+		const std::filesystem::path directory = std::filesystem::temp_directory_path() / "EpochAssetsBenchProject";
+		std::filesystem::remove_all(directory);
+
+		for (uint32_t folder = 0; folder < RegisterFolderCount; ++folder)
+		{
+			const std::filesystem::path folderPath = directory / ("Folder" + std::to_string(folder % 4)) / ("Textures" + std::to_string(folder));
+			std::filesystem::create_directories(folderPath);
+
+			for (uint32_t i = 0; i < RegisterFilesPerFolder; ++i)
+			{
+				WritePNG(folderPath / ("Texture" + std::to_string(i) + ".png"));
+			}
+		}
+
+		constexpr uint32_t fileCount = RegisterFolderCount * RegisterFilesPerFolder;
+
+		for (uint32_t threadCount : GetThreadCounts())
+		{
+			JobSystem::Initialize(threadCount);
+			const std::string threads = std::to_string(threadCount) + "Threads";
+
+			// The first registration writes the .meta files, the benchmark reads them like every later startup
+			aRunner.Run("AssetManager/RegisterAssets/2K/" + threads, [&]()
+				{
+					auto assetManager = std::make_shared<EditorAssetManager>();
+					Epoch::Assets::AssetManager::SetActiveAssetManager(assetManager);
+					assetManager->Init(directory);
+					Epoch::Assets::AssetManager::SetActiveAssetManager(nullptr);
+				}, fileCount);
+
+			JobSystem::Shutdown();
+		}
+
+		std::filesystem::remove_all(directory);
+	}
+}
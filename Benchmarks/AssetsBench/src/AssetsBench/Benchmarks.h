@@ -0,0 +1,12 @@
+#pragma once
+#include <BenchmarkCore/Benchmark.h>
+
+namespace AssetsBench
+{
+	void RunMeshBVHBenchmarks(Bench::Runner& aRunner);
+	void RunAssetManagerBenchmarks(Bench::Runner& aRunner);
+	void RunAssetRegistrationBenchmarks(Bench::Runner& aRunner);
+
+	// Checks the asset manager's results while many threads use it at once, false if any were wrong
+	bool RunAssetManagerStressTest();
+}
@@ -0,0 +1,20 @@
+#include "Benchmarks.h"
+#include <EpochCore/Log.h>
+
+int main(int argc, char** argv)
+{
+	Bench::Runner runner(argc, argv);
+
+	// The asset manager logs while registering, only warnings are worth printing between the results
+	Epoch::Log::Init();
+	Epoch::Log::GetLogger()->set_level(spdlog::level::warn);
+
+	const bool stressTestPassed = AssetsBench::RunAssetManagerStressTest();
+
+	AssetsBench::RunMeshBVHBenchmarks(runner);
+	AssetsBench::RunAssetManagerBenchmarks(runner);
+	AssetsBench::RunAssetRegistrationBenchmarks(runner);
+
+	const int result = runner.Finish();
+	return stressTestPassed ? result : 1;
+}
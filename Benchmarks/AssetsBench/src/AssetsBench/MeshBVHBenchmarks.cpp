@@ -0,0 +1,188 @@
+#include "Benchmarks.h"
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <CommonUtilities/Math/Geometry/AABB.h>
+#include <EpochDataTypes/MeshBVH.h>
+
+namespace AssetsBench
+{
+	namespace
+	{
+		using Epoch::DataTypes::MeshBVH;
+		using Epoch::DataTypes::MeshData;
+
+		const std::filesystem::path MeshDirectory = "../../Editor/Sandbox/Assets/Meshes";
+
+		// Cast per iteration of the raycast benchmarks
+		constexpr size_t RayCount = 1024;
+
+		struct TestRay
+		{
+			CU::Vector3f Origin;
+			CU::Vector3f Direction;
+		};
+
+		// Every mesh in the file combined into one, like a model imported with FlattenHierarchy
+		MeshData LoadMeshData(const std::filesystem::path& aPath)
+		{
+			MeshData data;
+
+			Assimp::Importer importer;
+			const aiScene* scene = importer.ReadFile(aPath.string(), aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_PreTransformVertices);
+			if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE)
+			{
+				std::printf("Failed to load %s: %s\n", aPath.string().c_str(), importer.GetErrorString());
+				return data;
+			}
+
+			for (uint32_t i = 0; i < scene->mNumMeshes; ++i)
+			{
+				const aiMesh* mesh = scene->mMeshes[i];
+				const uint32_t vertexOffset = static_cast<uint32_t>(data.Vertices.size());
+				const uint32_t indexOffset = static_cast<uint32_t>(data.Indices.size());
+
+				for (uint32_t v = 0; v < mesh->mNumVertices; ++v)
+				{
+					data.Vertices.emplace_back().Position = { mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z };
+				}
+
+				for (uint32_t f = 0; f < mesh->mNumFaces; ++f)
+				{
+					const aiFace& face = mesh->mFaces[f];
+					if (face.mNumIndices != 3) continue;
+
+					data.Indices.push_back(vertexOffset + face.mIndices[0]);
+					data.Indices.push_back(vertexOffset + face.mIndices[1]);
+					data.Indices.push_back(vertexOffset + face.mIndices[2]);
+				}
+
+				data.SubMeshes.push_back({ indexOffset, static_cast<uint32_t>(data.Indices.size()) - indexOffset });
+			}
+
+			return data;
+		}
+
+		// From random points around the mesh towards random points inside its bounds, so some miss and some graze the silhouette
+		std::vector<TestRay> GenerateRays(const MeshData& aData)
+		{
+			CU::AABB bounds;
+			for (const auto& vertex : aData.Vertices)
+			{
+				bounds.Encapsulate(vertex.Position);
+			}
+
+			const CU::Vector3f center = bounds.GetCenter();
+			const CU::Vector3f extents = bounds.GetExtents();
+
+			std::mt19937 engine(1337);
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+			std::vector<TestRay> rays(RayCount);
+			for (auto& ray : rays)
+			{
+				const CU::Vector3f around(unit(engine), unit(engine), unit(engine));
+				const CU::Vector3f inside(unit(engine), unit(engine), unit(engine));
+
+				ray.Origin = center + around.GetNormalized() * extents.Length() * 2.0f;
+				ray.Direction = (center + CU::Vector3f(inside.x * extents.x, inside.y * extents.y, inside.z * extents.z) - ray.Origin).GetNormalized();
+			}
+			return rays;
+		}
+
+		// What an exact raycast against a mesh costs without the BVH
+		bool RaycastBruteForce(const MeshData& aData, const TestRay& aRay, float& outDistance)
+		{
+			bool found = false;
+			outDistance = FLT_MAX;
+
+			for (size_t i = 0; i + 2 < aData.Indices.size(); i += 3)
+			{
+				const CU::Vector3f& vertex0 = aData.Vertices[aData.Indices[i + 0]].Position;
+				const CU::Vector3f edge1 = aData.Vertices[aData.Indices[i + 1]].Position - vertex0;
+				const CU::Vector3f edge2 = aData.Vertices[aData.Indices[i + 2]].Position - vertex0;
+
+				const CU::Vector3f p = aRay.Direction.Cross(edge2);
+				const float determinant = edge1.Dot(p);
+				if (determinant == 0.0f) continue;
+
+				const float inverseDeterminant = 1.0f / determinant;
+				const CU::Vector3f s = aRay.Origin - vertex0;
+				const float u = s.Dot(p) * inverseDeterminant;
+				if (u < 0.0f || u > 1.0f) continue;
+
+				const CU::Vector3f q = s.Cross(edge1);
+				const float v = aRay.Direction.Dot(q) * inverseDeterminant;
+				if (v < 0.0f || u + v > 1.0f) continue;
+
+				const float distance = edge2.Dot(q) * inverseDeterminant;
+				if (distance < 0.0f || distance >= outDistance) continue;
+
+				outDistance = distance;
+				found = true;
+			}
+
+			return found;
+		}
+
+		void RunMeshBenchmarks(Bench::Runner& aRunner, const std::string& aMeshName, const MeshData& aData)
+		{
+			if (!aData.IsValid()) return;
+
+			const size_t triangleCount = aData.Indices.size() / 3;
+			const std::string prefix = "MeshBVH/";
+
+			aRunner.Run(prefix + "Build/" + aMeshName + "/Binary", [&]()
+				{
+					MeshBVH bvh(aData, MeshBVH::Layout::Binary);
+					Bench::DoNotOptimize(bvh.GetNodeCount());
+				}, triangleCount);
+
+			aRunner.Run(prefix + "Build/" + aMeshName + "/Wide", [&]()
+				{
+					MeshBVH bvh(aData, MeshBVH::Layout::Wide);
+					Bench::DoNotOptimize(bvh.GetNodeCount());
+				}, triangleCount);
+
+			const std::vector<TestRay> rays = GenerateRays(aData);
+			const MeshBVH binary(aData, MeshBVH::Layout::Binary);
+			const MeshBVH wide(aData, MeshBVH::Layout::Wide);
+
+			auto raycast = [&rays](const MeshBVH& aBVH)
+				{
+					size_t hits = 0;
+					for (const TestRay& ray : rays)
+					{
+						MeshBVH::Hit hit;
+						hits += aBVH.Raycast(ray.Origin, ray.Direction, FLT_MAX, hit) ? 1 : 0;
+					}
+					Bench::DoNotOptimize(hits);
+				};
+
+			aRunner.Run(prefix + "Raycast/" + aMeshName + "/Binary", [&]() { raycast(binary); }, RayCount);
+			aRunner.Run(prefix + "Raycast/" + aMeshName + "/Wide", [&]() { raycast(wide); }, RayCount);
+
+			aRunner.Run(prefix + "Raycast/" + aMeshName + "/BruteForce", [&]()
+				{
+					size_t hits = 0;
+					for (const TestRay& ray : rays)
+					{
+						float distance;
+						hits += RaycastBruteForce(aData, ray, distance) ? 1 : 0;
+					}
+					Bench::DoNotOptimize(hits);
+				}, RayCount);
+		}
+	}
+
+	void RunMeshBVHBenchmarks(Bench::Runner& aRunner)
+	{
+		RunMeshBenchmarks(aRunner, "Raccoon", LoadMeshData(MeshDirectory / "raccoon.fbx"));
+		RunMeshBenchmarks(aRunner, "SM_Chest", LoadMeshData(MeshDirectory / "SM_Chest.fbx"));
+	}
+}
@@ -0,0 +1,25 @@
+project "BenchmarkCore"
+	kind "StaticLib"
+
+	targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+
+	apply_simd_flags()
+
+	files
+	{
+		"src/**.h",
+		"src/**.hpp",
+		"src/**.cpp"
+	}
+
+	includedirs
+	{
+		"src",
+		"%{wks.location}/vendor/yaml-cpp/include",
+	}
+
+	links
+	{
+		"yaml-cpp",
+	}
@@ -0,0 +1,290 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <yaml-cpp/yaml.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace Bench
+{
+	namespace
+	{
+		std::string GetCPUName()
+		{
+			int registers[12] = {};
+#if defined(_MSC_VER)
+			__cpuid(registers + 0, 0x80000002);
+			__cpuid(registers + 4, 0x80000003);
+			__cpuid(registers + 8, 0x80000004);
+#else
+			for (unsigned i = 0; i < 3; ++i)
+			{
+				unsigned* values = reinterpret_cast<unsigned*>(registers + i * 4);
+				__get_cpuid(0x80000002 + i, values + 0, values + 1, values + 2, values + 3);
+			}
+#endif
+			char name[sizeof(registers) + 1] = {};
+			std::memcpy(name, registers, sizeof(registers));
+
+			std::string result = name;
+			result.erase(0, result.find_first_not_of(' '));
+			result.erase(result.find_last_not_of(' ') + 1);
+			return result;
+		}
+
+		const char* GetConfiguration()
+		{
+#if defined(_DEBUG)
+			return "Debug";
+#elif defined(_RELEASE)
+			return "Release";
+#elif defined(_DIST)
+			return "Dist";
+#else
+			return "Unknown";
+#endif
+		}
+
+		std::string EscapeJSON(std::string_view aString)
+		{
+			std::string result;
+			result.reserve(aString.size());
+			for (char c : aString)
+			{
+				if (c == '"' || c == '\\')
+				{
+					result += '\\';
+				}
+				result += c;
+			}
+			return result;
+		}
+
+		bool WriteJSON(const std::string& aPath, const std::vector<Result>& aResults)
+		{
+			std::ofstream file(aPath);
+			if (!file)
+			{
+				return false;
+			}
+
+			file << "{\n";
+			file << "\t\"cpu\": \"" << EscapeJSON(GetCPUName()) << "\",\n";
+			file << "\t\"configuration\": \"" << GetConfiguration() << "\",\n";
+			file << "\t\"results\":\n\t[\n";
+
+			char buffer[512];
+			for (size_t i = 0; i < aResults.size(); ++i)
+			{
+				const Result& result = aResults[i];
+				std::snprintf(buffer, sizeof(buffer),
+					"\t\t{ \"name\": \"%s\", \"ns\": %.4f, \"min_ns\": %.4f, \"rel_stddev\": %.4f, \"iterations\": %llu, \"items\": %llu }%s\n",
+					EscapeJSON(result.Name).c_str(), result.NanosecondsPerItem, result.MinNanosecondsPerItem, result.RelativeStdDev,
+					static_cast<unsigned long long>(result.Iterations), static_cast<unsigned long long>(result.ItemsPerIteration),
+					i + 1 < aResults.size() ? "," : "");
+				file << buffer;
+			}
+
+			file << "\t]\n}\n";
+			return true;
+		}
+
+		bool LoadBaseline(const std::string& aPath, YAML::Node& outBaseline)
+		{
+			try
+			{
+				// JSON is valid YAML, so the baseline is read with yaml-cpp
+				outBaseline = YAML::LoadFile(aPath);
+			}
+			catch (const YAML::Exception&)
+			{
+				return false;
+			}
+
+			return outBaseline.IsMap();
+		}
+
+		// Entries without a name are skipped, missing or malformed values are 0
+		std::vector<Result> ReadResults(const YAML::Node& aBaseline)
+		{
+			std::vector<Result> results;
+
+			const YAML::Node entries = aBaseline["results"];
+			if (!entries.IsSequence())
+			{
+				return results;
+			}
+
+			for (const YAML::Node& entry : entries)
+			{
+				std::string name = entry.IsMap() ? entry["name"].as<std::string>("") : "";
+				if (name.empty())
+				{
+					continue;
+				}
+
+				Result& result = results.emplace_back();
+				result.Name = std::move(name);
+				result.NanosecondsPerItem = entry["ns"].as<double>(0.0);
+				result.MinNanosecondsPerItem = entry["min_ns"].as<double>(0.0);
+				result.RelativeStdDev = entry["rel_stddev"].as<double>(0.0);
+				result.Iterations = entry["iterations"].as<uint64_t>(0);
+				result.ItemsPerIteration = entry["items"].as<uint64_t>(1);
+			}
+			return results;
+		}
+	}
+
+	Runner::Runner(int aArgc, char** aArgv)
+	{
+		for (int i = 1; i < aArgc; ++i)
+		{
+			const std::string_view argument = aArgv[i];
+			const bool hasValue = i + 1 < aArgc;
+
+			if (argument == "--filter" && hasValue) mySettings.Filter = aArgv[++i];
+			else if (argument == "--out" && hasValue) mySettings.OutputPath = aArgv[++i];
+			else if (argument == "--baseline" && hasValue) mySettings.BaselinePath = aArgv[++i];
+			else if (argument == "--tolerance" && hasValue) mySettings.Tolerance = std::atof(aArgv[++i]);
+			else if (argument == "--samples" && hasValue) mySettings.Samples = std::max(1, std::atoi(aArgv[++i]));
+			else if (argument == "--update-baseline") mySettings.UpdateBaseline = true;
+			else std::printf("Unknown argument '%s'\n", aArgv[i]);
+		}
+
+		std::printf("%s, %s\n\n", GetCPUName().c_str(), GetConfiguration());
+		std::printf("%-48s %12s %12s %8s\n", "Benchmark", "ns/item", "min", "stddev");
+	}
+
+	bool Runner::IsFiltered(std::string_view aName) const
+	{
+		return !mySettings.Filter.empty() && aName.find(mySettings.Filter) == std::string_view::npos;
+	}
+
+	void Runner::AddResult(std::string_view aName, std::vector<double>& aSampleNanoseconds, uint64_t aIterations, uint64_t aItemsPerIteration)
+	{
+		const double scale = 1.0 / static_cast<double>(aIterations * aItemsPerIteration);
+		for (double& sample : aSampleNanoseconds)
+		{
+			sample *= scale;
+		}
+
+		std::sort(aSampleNanoseconds.begin(), aSampleNanoseconds.end());
+
+		double mean = 0.0;
+		for (double sample : aSampleNanoseconds)
+		{
+			mean += sample;
+		}
+		mean /= static_cast<double>(aSampleNanoseconds.size());
+
+		double variance = 0.0;
+		for (double sample : aSampleNanoseconds)
+		{
+			variance += (sample - mean) * (sample - mean);
+		}
+		variance /= static_cast<double>(aSampleNanoseconds.size());
+
+		Result& result = myResults.emplace_back();
+		result.Name = aName;
+		result.NanosecondsPerItem = aSampleNanoseconds[aSampleNanoseconds.size() / 2];
+		result.MinNanosecondsPerItem = aSampleNanoseconds.front();
+		result.RelativeStdDev = mean > 0.0 ? std::sqrt(variance) / mean : 0.0;
+		result.Iterations = aIterations;
+		result.ItemsPerIteration = aItemsPerIteration;
+
+		std::printf("%-48s %12.3f %12.3f %7.1f%%\n", result.Name.c_str(), result.NanosecondsPerItem, result.MinNanosecondsPerItem, result.RelativeStdDev * 100.0);
+	}
+
+	int Runner::Finish()
+	{
+		if (!WriteJSON(mySettings.OutputPath, myResults))
+		{
+			std::printf("\nFailed to write results to '%s'\n", mySettings.OutputPath.c_str());
+		}
+
+		YAML::Node baseline;
+		const bool hasBaseline = LoadBaseline(mySettings.BaselinePath, baseline);
+
+		if (mySettings.UpdateBaseline)
+		{
+			// Benchmarks that didn't run, like the ones left out by --filter, keep their old entry
+			std::vector<Result> merged = hasBaseline ? ReadResults(baseline) : std::vector<Result>();
+			for (const Result& result : myResults)
+			{
+				auto it = std::find_if(merged.begin(), merged.end(), [&result](const Result& aOld) { return aOld.Name == result.Name; });
+				if (it != merged.end())
+				{
+					*it = result;
+				}
+				else
+				{
+					merged.emplace_back(result);
+				}
+			}
+
+			if (!WriteJSON(mySettings.BaselinePath, merged))
+			{
+				std::printf("\nFailed to write baseline '%s'\n", mySettings.BaselinePath.c_str());
+				return 1;
+			}
+
+			std::printf("\nBaseline '%s' updated\n", mySettings.BaselinePath.c_str());
+			return 0;
+		}
+
+		if (!hasBaseline)
+		{
+			std::printf("\nNo baseline found at '%s', run with --update-baseline to create one\n", mySettings.BaselinePath.c_str());
+			return 0;
+		}
+
+		const std::string baselineCPU = baseline["cpu"].as<std::string>("");
+		const std::string baselineConfiguration = baseline["configuration"].as<std::string>("");
+		if (baselineCPU != GetCPUName() || baselineConfiguration != GetConfiguration())
+		{
+			std::printf("\nWarning: baseline was recorded on '%s' (%s), timings might not be comparable\n", baselineCPU.c_str(), baselineConfiguration.c_str());
+		}
+
+		std::unordered_map<std::string, double> baselineTimes;
+		for (const Result& result : ReadResults(baseline))
+		{
+			baselineTimes[result.Name] = result.NanosecondsPerItem;
+		}
+
+		std::printf("\n%-48s %12s %12s %8s\n", "Compared to baseline", "baseline", "current", "change");
+
+		int regressions = 0;
+		for (const Result& result : myResults)
+		{
+			auto it = baselineTimes.find(result.Name);
+			if (it == baselineTimes.end() || it->second <= 0.0)
+			{
+				std::printf("%-48s %12s %12.3f %8s\n", result.Name.c_str(), "-", result.NanosecondsPerItem, "new");
+				continue;
+			}
+
+			const double change = result.NanosecondsPerItem / it->second - 1.0;
+			const bool isRegression = change > mySettings.Tolerance;
+			regressions += isRegression ? 1 : 0;
+
+			std::printf("%-48s %12.3f %12.3f %+7.1f%%%s\n", result.Name.c_str(), it->second, result.NanosecondsPerItem, change * 100.0, isRegression ? "  REGRESSION" : "");
+		}
+
+		if (regressions > 0)
+		{
+			std::printf("\n%d benchmark(s) regressed by more than %.0f%%\n", regressions, mySettings.Tolerance * 100.0);
+			return 1;
+		}
+
+		std::printf("\nNo regressions (tolerance %.0f%%)\n", mySettings.Tolerance * 100.0);
+		return 0;
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+namespace Bench
+{
+	// Keeps the compiler from optimizing away a value that's computed but never used.
+	template<typename T>
+	inline void DoNotOptimize(const T& aValue)
+	{
+#if defined(_MSC_VER)
+		const volatile char* volatile sink = reinterpret_cast<const volatile char*>(&aValue);
+		(void)*sink;
+#else
+		asm volatile("" : : "r,m"(aValue) : "memory");
+#endif
+	}
+
+	struct Result
+	{
+		std::string Name;
+		double NanosecondsPerItem = 0.0; // Median of all samples
+		double MinNanosecondsPerItem = 0.0;
+		double RelativeStdDev = 0.0;
+		uint64_t Iterations = 0; // Per sample
+		uint64_t ItemsPerIteration = 1;
+	};
+
+	struct Settings
+	{
+		std::string Filter;
+		std::string OutputPath = "results.json";
+		std::string BaselinePath = "baseline.json";
+		double Tolerance = 0.1; // Allowed slowdown compared to the baseline, 0.1 = 10%
+		bool UpdateBaseline = false;
+
+		uint32_t Samples = 21;
+		std::chrono::milliseconds WarmupTime{ 50 };
+		std::chrono::milliseconds SampleTime{ 5 };
+	};
+
+	// Runs the benchmarks, writes them as JSON and compares them against the baseline.
+	// Command line: --filter <substring> --out <path> --baseline <path> --tolerance <fraction> --samples <count> --update-baseline
+	class Runner
+	{
+	public:
+		Runner(int aArgc, char** aArgv);
+		~Runner() = default;
+
+		// aFunction is one iteration, processing aItemsPerIteration items. Times are reported per item.
+		template<typename Function>
+		void Run(std::string_view aName, Function&& aFunction, uint64_t aItemsPerIteration = 1);
+
+		// Writes the results and compares them against the baseline, returns the process exit code (non-zero on regressions).
+		int Finish();
+
+		const Settings& GetSettings() const { return mySettings; }
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		bool IsFiltered(std::string_view aName) const;
+		void AddResult(std::string_view aName, std::vector<double>& aSampleNanoseconds, uint64_t aIterations, uint64_t aItemsPerIteration);
+
+	private:
+		Settings mySettings;
+		std::vector<Result> myResults;
+	};
+
+	template<typename Function>
+	inline void Runner::Run(std::string_view aName, Function&& aFunction, uint64_t aItemsPerIteration)
+	{
+		if (IsFiltered(aName))
+		{
+			return;
+		}
+
+		auto runIterations = [&aFunction](uint64_t aCount)
+			{
+				const auto start = Clock::now();
+				for (uint64_t i = 0; i < aCount; ++i)
+				{
+					aFunction();
+				}
+				return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+			};
+
+		// Warm up caches, branch predictors and clocks, and find how many iterations fill one sample.
+		uint64_t iterations = 1;
+		double elapsed = 0.0;
+		const auto warmupEnd = Clock::now() + mySettings.WarmupTime;
+		do
+		{
+			elapsed = runIterations(iterations);
+			if (elapsed < std::chrono::duration<double, std::nano>(mySettings.SampleTime).count())
+			{
+				iterations *= 2;
+			}
+		} while (Clock::now() < warmupEnd);
+
+		const double sampleNanoseconds = std::chrono::duration<double, std::nano>(mySettings.SampleTime).count();
+		const double nanosecondsPerIteration = elapsed / static_cast<double>(iterations);
+		iterations = std::max<uint64_t>(1, static_cast<uint64_t>(sampleNanoseconds / std::max(nanosecondsPerIteration, 0.01)));
+
+		std::vector<double> samples(mySettings.Samples);
+		for (double& sample : samples)
+		{
+			sample = runIterations(iterations);
+		}
+
+		AddResult(aName, samples, iterations, aItemsPerIteration);
+	}
+}
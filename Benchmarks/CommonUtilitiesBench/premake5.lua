@@ -0,0 +1,30 @@
+project "CommonUtilitiesBench"
+	kind "ConsoleApp"
+
+	targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+
+	-- Relative paths (baseline.json) resolve against the project folder when started from the IDE
+	debugdir "%{prj.location}"
+
+	apply_simd_flags()
+
+	files
+	{
+		"src/**.h",
+		"src/**.hpp",
+		"src/**.cpp"
+	}
+
+	includedirs
+	{
+		"src",
+		"%{wks.location}/CommonUtilities/src",
+		"%{wks.location}/Benchmarks/BenchmarkCore/src",
+	}
+
+	links
+	{
+		"CommonUtilities",
+		"BenchmarkCore",
+	}
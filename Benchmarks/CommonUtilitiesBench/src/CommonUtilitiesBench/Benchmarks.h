@@ -0,0 +1,19 @@
+#pragma once
+#include <BenchmarkCore/Benchmark.h>
+
+namespace CUBench
+{
+	// Inputs are generated up front and cycled through, so the work can't be constant folded.
+	constexpr size_t InputCount = 1024;
+
+	void RunMathBenchmarks(Bench::Runner& aRunner);
+	void RunColorBenchmarks(Bench::Runner& aRunner);
+	void RunRandomBenchmarks(Bench::Runner& aRunner);
+
+	// Compares the SIMD Matrix3x3f/Matrix4x4f specializations bit for bit against the generic code, false on any mismatch
+	bool RunMatrixBitExactnessCheck();
+	// Compares RSqrt and NormalizeVectors against double precision, including denormal inputs, false on any failure
+	bool RunMathBatchCheck();
+	// Checks the sRGB encoding error and the half float clamping documented in ColorConversion.h, false on any failure
+	bool RunColorConversionCheck();
+}
@@ -0,0 +1,145 @@
+#include "Benchmarks.h"
+#include <random>
+#include <vector>
+#include <CommonUtilities/Color.h>
+#include <CommonUtilities/ColorConversion.h>
+#include <CommonUtilities/Gradient.h>
+#include <CommonUtilities/Math/Vector/Vector.h>
+
+namespace CUBench
+{
+	void RunColorBenchmarks(Bench::Runner& aRunner)
+	{
+		std::mt19937 engine(1337);
+		std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+		std::vector<CU::Color> colors(InputCount);
+		std::vector<float> positions(InputCount);
+		std::vector<std::string> hexStrings(InputCount);
+		for (size_t i = 0; i < InputCount; ++i)
+		{
+			colors[i] = CU::Color(distribution(engine), distribution(engine), distribution(engine), distribution(engine));
+			positions[i] = distribution(engine);
+			hexStrings[i] = colors[i].GetHexString();
+		}
+
+		size_t index = 0;
+		auto next = [&index]() { index = (index + 1) & (InputCount - 1); return index; };
+
+		aRunner.Run("Color/GetHex", [&]()
+			{
+				Bench::DoNotOptimize(colors[next()].GetHex());
+			});
+
+		aRunner.Run("Color/GetABGRHex", [&]()
+			{
+				Bench::DoNotOptimize(colors[next()].GetABGRHex());
+			});
+
+		aRunner.Run("Color/GetHexString", [&]()
+			{
+				Bench::DoNotOptimize(colors[next()].GetHexString());
+			});
+
+		aRunner.Run("Color/FromHexString", [&]()
+			{
+				Bench::DoNotOptimize(CU::Color(hexStrings[next()]));
+			});
+
+		aRunner.Run("Color/GetVector4", [&]()
+			{
+				Bench::DoNotOptimize(colors[next()].GetVector4());
+			});
+
+		aRunner.Run("Color/Lerp", [&]()
+			{
+				const size_t i = next();
+				Bench::DoNotOptimize(CU::Color::Lerp(colors[i], colors[(i + 1) & (InputCount - 1)], positions[i]));
+			});
+
+		CU::Gradient gradient;
+		gradient.AddColorKey(0.25f, CU::Color::Red);
+		gradient.AddColorKey(0.5f, CU::Color::Green);
+		gradient.AddColorKey(0.75f, CU::Color::Blue);
+		gradient.AddAlphaKey(0.4f, 0.5f);
+
+		aRunner.Run("Gradient/GetColorAt", [&]()
+			{
+				Bench::DoNotOptimize(gradient.GetColorAt(positions[next()]));
+			});
+
+		std::vector<CU::Color> gradientColors(InputCount);
+		aRunner.Run("Gradient/EvaluateBatch", [&]()
+			{
+				gradient.Evaluate(positions, gradientColors);
+				Bench::DoNotOptimize(gradientColors.data());
+			}, InputCount);
+
+		aRunner.Run("Gradient/AddRemoveColorKey", [&]()
+			{
+				const size_t index = gradient.AddColorKey(positions[next()], CU::Color::Yellow);
+				gradient.RemoveColorKey(index);
+			});
+
+		// Pixel conversions, InputCount RGBA pixels per iteration
+		std::vector<float> pixels(InputCount * 4);
+		std::uniform_real_distribution<float> hdrDistribution(0.0f, 16.0f);
+		for (size_t i = 0; i < pixels.size(); ++i)
+		{
+			pixels[i] = (i & 3) == 3 ? distribution(engine) : hdrDistribution(engine) * distribution(engine) * distribution(engine);
+		}
+
+		std::vector<uint8_t> bytePixels(InputCount * 4);
+		std::vector<uint16_t> halfPixels(InputCount * 4);
+		std::vector<uint32_t> packedPixels(InputCount);
+		std::vector<float> floatPixels(InputCount * 4);
+
+		aRunner.Run("ColorConversion/RGBA32FToRGBA8", [&]()
+			{
+				CU::ConvertRGBA32FToRGBA8(pixels, bytePixels);
+				Bench::DoNotOptimize(bytePixels.data());
+			}, InputCount);
+
+		aRunner.Run("ColorConversion/RGBA32FToRGBA8SRGB", [&]()
+			{
+				CU::ConvertRGBA32FToRGBA8SRGB(pixels, bytePixels);
+				Bench::DoNotOptimize(bytePixels.data());
+			}, InputCount);
+
+		aRunner.Run("ColorConversion/RGBA8ToRGBA32F", [&]()
+			{
+				CU::ConvertRGBA8ToRGBA32F(bytePixels, floatPixels);
+				Bench::DoNotOptimize(floatPixels.data());
+			}, InputCount);
+
+		aRunner.Run("ColorConversion/RGBA8SRGBToRGBA32F", [&]()
+			{
+				CU::ConvertRGBA8SRGBToRGBA32F(bytePixels, floatPixels);
+				Bench::DoNotOptimize(floatPixels.data());
+			}, InputCount);
+
+		aRunner.Run("ColorConversion/RGBA32FToRGBA16F", [&]()
+			{
+				CU::ConvertRGBA32FToRGBA16F(pixels, halfPixels);
+				Bench::DoNotOptimize(halfPixels.data());
+			}, InputCount);
+
+		aRunner.Run("ColorConversion/RGBA16FToRGBA32F", [&]()
+			{
+				CU::ConvertRGBA16FToRGBA32F(halfPixels, floatPixels);
+				Bench::DoNotOptimize(floatPixels.data());
+			}, InputCount);
+
+		aRunner.Run("ColorConversion/RGBA32FToR11G11B10F", [&]()
+			{
+				CU::ConvertRGBA32FToR11G11B10F(pixels, packedPixels);
+				Bench::DoNotOptimize(packedPixels.data());
+			}, InputCount);
+
+		aRunner.Run("ColorConversion/R11G11B10FToRGBA32F", [&]()
+			{
+				CU::ConvertR11G11B10FToRGBA32F(packedPixels, floatPixels);
+				Bench::DoNotOptimize(floatPixels.data());
+			}, InputCount);
+	}
+}
@@ -0,0 +1,115 @@
+#include "Benchmarks.h"
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <vector>
+#include <CommonUtilities/ColorConversion.h>
+
+namespace CUBench
+{
+	namespace
+	{
+		// The bounds documented in ColorConversion.h
+		constexpr double SRGBMaxStepError = 0.005;
+		constexpr uint16_t MaxHalf = 0x7BFF;
+		constexpr uint32_t MaxPrintedFailures = 8;
+
+		class FailureCounter
+		{
+		public:
+			template<typename... Args>
+			void Fail(const char* aFormat, Args... aArgs)
+			{
+				if (++myCount <= MaxPrintedFailures)
+				{
+					std::printf(aFormat, aArgs...);
+				}
+			}
+
+			uint32_t GetCount() const { return myCount; }
+
+		private:
+			uint32_t myCount = 0;
+		};
+
+		// Every byte is within half a step plus the table error of the exact curve
+		void CheckSRGBEncoding(FailureCounter& aFailures)
+		{
+			constexpr size_t pixelCount = 1 << 18;
+			std::vector<float> pixels(pixelCount * 4);
+			for (size_t i = 0; i < pixels.size(); ++i)
+			{
+				pixels[i] = static_cast<float>(i) / static_cast<float>(pixels.size() - 1);
+			}
+
+			std::vector<uint8_t> bytes(pixelCount * 4);
+			CU::ConvertRGBA32FToRGBA8SRGB(pixels, bytes);
+
+			for (size_t i = 0; i < pixels.size(); ++i)
+			{
+				if ((i & 3) == 3) continue;
+
+				const double exact = static_cast<double>(CU::LinearToSRGB(pixels[i])) * 255.0;
+				const double error = std::abs(static_cast<double>(bytes[i]) - exact) - 0.5;
+				if (!(error < SRGBMaxStepError))
+				{
+					aFailures.Fail("ConvertRGBA32FToRGBA8SRGB(%.9g) = %u, exact %.6f\n", pixels[i], bytes[i], exact);
+				}
+			}
+		}
+
+		// Finite values round like FloatToHalf, overflow and infinity clamp to the largest finite half and NaN stays NaN.
+		// Enough pixels for the vector loops and the scalar tail.
+		void CheckHalfConversion(FailureCounter& aFailures)
+		{
+			const float infinity = std::numeric_limits<float>::infinity();
+			const std::vector<float> values =
+			{
+				0.0f, -0.0f, 1.0f, -2.5f, 6.1e-5f, 5.9e-8f, 1e-10f, 1000.3f,
+				65504.0f, 65519.0f, 65520.0f, 1e6f, -1e6f, infinity, -infinity, std::numeric_limits<float>::max(),
+				-65520.0f, 3.0f, std::numeric_limits<float>::quiet_NaN(), 70000.0f, -infinity, 0.5f, 65536.0f, 2.0f,
+				1e9f, infinity, -1.0f, 65504.0f, -65504.0f, 100000.0f, 0.25f, infinity, 1e30f, 65000.0f, -70000.0f, 8.0f
+			};
+
+			std::vector<uint16_t> halves(values.size());
+			CU::ConvertRGBA32FToRGBA16F(values, halves);
+
+			for (size_t i = 0; i < halves.size(); ++i)
+			{
+				const float value = values[i];
+				uint16_t expected = 0;
+				if (std::isnan(value))
+				{
+					if ((halves[i] & 0x7C00) != 0x7C00 || (halves[i] & 0x03FF) == 0)
+					{
+						aFailures.Fail("ConvertRGBA32FToRGBA16F(NaN) = 0x%04X, expected a NaN\n", halves[i]);
+					}
+					continue;
+				}
+				else if (std::abs(value) > 65504.0f)
+				{
+					expected = value > 0.0f ? MaxHalf : static_cast<uint16_t>(0x8000 | MaxHalf);
+				}
+				else
+				{
+					expected = CU::FloatToHalf(value);
+				}
+
+				if (halves[i] != expected)
+				{
+					aFailures.Fail("ConvertRGBA32FToRGBA16F(%g) = 0x%04X, expected 0x%04X\n", value, halves[i], expected);
+				}
+			}
+		}
+	}
+
+	bool RunColorConversionCheck()
+	{
+		FailureCounter failures;
+		CheckSRGBEncoding(failures);
+		CheckHalfConversion(failures);
+
+		std::printf("Color conversion check: sRGB encoding error and half float clamping, %u failures\n", failures.GetCount());
+		return failures.GetCount() == 0;
+	}
+}
@@ -0,0 +1,17 @@
+#include "Benchmarks.h"
+
+int main(int argc, char** argv)
+{
+	Bench::Runner runner(argc, argv);
+
+	const bool matricesPassed = CUBench::RunMatrixBitExactnessCheck();
+	const bool mathBatchPassed = CUBench::RunMathBatchCheck();
+	const bool colorConversionPassed = CUBench::RunColorConversionCheck();
+
+	CUBench::RunMathBenchmarks(runner);
+	CUBench::RunColorBenchmarks(runner);
+	CUBench::RunRandomBenchmarks(runner);
+
+	const int result = runner.Finish();
+	return matricesPassed && mathBatchPassed && colorConversionPassed ? result : 1;
+}
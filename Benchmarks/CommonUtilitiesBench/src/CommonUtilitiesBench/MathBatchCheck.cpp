@@ -0,0 +1,130 @@
+#include "Benchmarks.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+#include <CommonUtilities/Math/CommonMathBatch.h>
+
+namespace CUBench
+{
+	namespace
+	{
+		constexpr size_t CheckValueCount = 1 << 16;
+		// The bound documented in CommonMathBatch.h
+		constexpr double RSqrtMaxULP = 4.2;
+		constexpr float NormalizeTolerance = 1e-5f;
+		constexpr uint32_t MaxPrintedFailures = 8;
+
+		// The float ULP at the double precision result
+		double GetULP(double aValue)
+		{
+			const float value = static_cast<float>(aValue);
+			return static_cast<double>(std::nextafter(value, std::numeric_limits<float>::infinity())) - static_cast<double>(value);
+		}
+
+		class FailureCounter
+		{
+		public:
+			template<typename... Args>
+			void Fail(const char* aFormat, Args... aArgs)
+			{
+				if (++myCount <= MaxPrintedFailures)
+				{
+					std::printf(aFormat, aArgs...);
+				}
+			}
+
+			uint32_t GetCount() const { return myCount; }
+
+		private:
+			uint32_t myCount = 0;
+		};
+
+		// Normal values over the whole exponent range, the denormals and the exact special cases
+		void CheckRSqrt(FailureCounter& aFailures)
+		{
+			std::mt19937 engine(1337);
+			std::uniform_real_distribution<float> exponent(-126.0f, 127.0f);
+			std::uniform_real_distribution<float> denormal(std::numeric_limits<float>::denorm_min(), std::numeric_limits<float>::min());
+
+			std::vector<float> values(CheckValueCount);
+			for (size_t i = 0; i < CheckValueCount; ++i)
+			{
+				values[i] = (i % 4 == 0) ? denormal(engine) : std::exp2(exponent(engine));
+			}
+			values[0] = std::numeric_limits<float>::denorm_min();
+			values[1] = std::numeric_limits<float>::min();
+			values[2] = std::numeric_limits<float>::max();
+
+			std::vector<float> results(CheckValueCount);
+			CU::Math::RSqrt(values, results);
+
+			for (size_t i = 0; i < CheckValueCount; ++i)
+			{
+				const double expected = 1.0 / std::sqrt(static_cast<double>(values[i]));
+				const double error = std::abs(static_cast<double>(results[i]) - expected) / GetULP(expected);
+				if (!(error <= RSqrtMaxULP))
+				{
+					aFailures.Fail("RSqrt(%.9g) = %.9g, expected %.9g (%.1f ULP)\n", values[i], results[i], expected, error);
+				}
+			}
+
+			const float specials[] = { 0.0f, -0.0f, std::numeric_limits<float>::infinity() };
+			const float expectedSpecials[] = { std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), 0.0f };
+			float specialResults[3];
+			CU::Math::RSqrt(specials, specialResults);
+			for (size_t i = 0; i < 3; ++i)
+			{
+				if (specialResults[i] != expectedSpecials[i])
+				{
+					aFailures.Fail("RSqrt(%g) = %g, expected %g\n", specials[i], specialResults[i], expectedSpecials[i]);
+				}
+			}
+		}
+
+		// Vector3::Normalize, also for vectors so small their squared length is a denormal, and zero vectors stay zero
+		void CheckNormalizeVectors(FailureCounter& aFailures)
+		{
+			std::mt19937 engine(1337);
+			std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+			std::uniform_real_distribution<float> exponent(-60.0f, 60.0f);
+
+			std::vector<CU::Vector3f> vectors(CheckValueCount);
+			for (size_t i = 0; i < CheckValueCount; ++i)
+			{
+				const float scale = (i % 4 == 0) ? 1e-20f : std::exp2(exponent(engine));
+				vectors[i] = CU::Vector3f(component(engine), component(engine), component(engine)) * scale;
+			}
+			vectors[0] = CU::Vector3f::Zero;
+
+			std::vector<CU::Vector3f> normalized = vectors;
+			CU::Math::NormalizeVectors(normalized);
+
+			for (size_t i = 0; i < CheckValueCount; ++i)
+			{
+				CU::Vector3f expected = vectors[i];
+				expected.Normalize();
+
+				const CU::Vector3f& result = normalized[i];
+				const float error = std::max({ std::abs(result.x - expected.x), std::abs(result.y - expected.y), std::abs(result.z - expected.z) });
+				if (!(error <= NormalizeTolerance))
+				{
+					aFailures.Fail("NormalizeVectors(%g, %g, %g) = (%g, %g, %g), expected (%g, %g, %g)\n",
+						vectors[i].x, vectors[i].y, vectors[i].z, result.x, result.y, result.z, expected.x, expected.y, expected.z);
+				}
+			}
+		}
+	}
+
+	bool RunMathBatchCheck()
+	{
+		FailureCounter failures;
+		CheckRSqrt(failures);
+		CheckNormalizeVectors(failures);
+
+		std::printf("MathBatch check: RSqrt and NormalizeVectors including denormals, %u failures\n", failures.GetCount());
+		return failures.GetCount() == 0;
+	}
+}
@@ -0,0 +1,299 @@
+#include "Benchmarks.h"
+#include <cmath>
+#include <random>
+#include <vector>
+#include <CommonUtilities/Math/CommonMathBatch.h>
+#include <CommonUtilities/Math/CompactTransform.h>
+#include <CommonUtilities/Math/Transform.h>
+#include <CommonUtilities/Math/TransformBatch.h>
+#include <CommonUtilities/Math/Geometry/Intersection.h>
+
+namespace CUBench
+{
+	namespace
+	{
+		std::vector<CU::Transform> CreateTransforms(size_t aCount)
+		{
+			std::mt19937 engine(1337);
+			std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+			std::uniform_real_distribution<float> angle(-CU::Math::Pi, CU::Math::Pi);
+			std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+
+			std::vector<CU::Transform> transforms;
+			transforms.reserve(aCount);
+			for (size_t i = 0; i < aCount; ++i)
+			{
+				transforms.emplace_back(
+					CU::Vector3f(position(engine), position(engine), position(engine)),
+					CU::Vector3f(angle(engine), angle(engine), angle(engine)),
+					CU::Vector3f(scale(engine), scale(engine), scale(engine)));
+			}
+			return transforms;
+		}
+	}
+
+	void RunMathBenchmarks(Bench::Runner& aRunner)
+	{
+		std::vector<CU::Transform> transforms = CreateTransforms(InputCount);
+		std::vector<CU::Matrix4x4f> matrices(InputCount);
+		std::vector<CU::Quatf> rotations(InputCount);
+		for (size_t i = 0; i < InputCount; ++i)
+		{
+			matrices[i] = transforms[i].GetMatrix();
+			rotations[i] = transforms[i].GetRotationQuat();
+		}
+
+		size_t index = 0;
+		auto next = [&index]() { index = (index + 1) & (InputCount - 1); return index; };
+
+		aRunner.Run("Matrix4x4f/Multiply", [&]()
+			{
+				const size_t i = next();
+				Bench::DoNotOptimize(matrices[i] * matrices[(i + 1) & (InputCount - 1)]);
+			});
+
+		aRunner.Run("Matrix4x4f/Inverse", [&]()
+			{
+				Bench::DoNotOptimize(matrices[next()].GetInverse());
+			});
+
+		aRunner.Run("Matrix4x4f/FastInverse", [&]()
+			{
+				Bench::DoNotOptimize(matrices[next()].GetFastInverse());
+			});
+
+		aRunner.Run("Matrix4x4f/Transpose", [&]()
+			{
+				Bench::DoNotOptimize(matrices[next()].GetTranspose());
+			});
+
+		aRunner.Run("Matrix4x4f/DecomposeQuat", [&]()
+			{
+				CU::Vector3f position, scale;
+				CU::Quatf rotation;
+				matrices[next()].Decompose(position, rotation, scale);
+				Bench::DoNotOptimize(position);
+				Bench::DoNotOptimize(rotation);
+				Bench::DoNotOptimize(scale);
+			});
+
+		aRunner.Run("Matrix4x4f/DecomposeEuler", [&]()
+			{
+				CU::Vector3f position, rotation, scale;
+				matrices[next()].Decompose(position, rotation, scale);
+				Bench::DoNotOptimize(position);
+				Bench::DoNotOptimize(rotation);
+				Bench::DoNotOptimize(scale);
+			});
+
+		aRunner.Run("Matrix4x4f/TransformVector4", [&]()
+			{
+				const size_t i = next();
+				Bench::DoNotOptimize(CU::Vector4f(transforms[i].GetTranslation(), 1.0f) * matrices[i]);
+			});
+
+		aRunner.Run("Quaternion/Slerp", [&]()
+			{
+				const size_t i = next();
+				Bench::DoNotOptimize(CU::Quatf::Slerp(rotations[i], rotations[(i + 1) & (InputCount - 1)], 0.35f));
+			});
+
+		aRunner.Run("Quaternion/FromEuler", [&]()
+			{
+				Bench::DoNotOptimize(CU::Quatf(transforms[next()].GetRotation()));
+			});
+
+		aRunner.Run("Transform/GetMatrix", [&]()
+			{
+				// Marks the transform dirty so the matrix is rebuilt every time
+				CU::Transform& transform = transforms[next()];
+				transform.SetScale(transform.GetScale());
+				Bench::DoNotOptimize(transform.GetMatrix());
+			});
+
+		std::vector<CU::CompactTransform> compactTransforms(transforms.begin(), transforms.end());
+		aRunner.Run("CompactTransform/GetMatrix", [&]()
+			{
+				Bench::DoNotOptimize(compactTransforms[next()].GetMatrix());
+			});
+
+		{
+			std::vector<float> components[10];
+			for (std::vector<float>& component : components)
+			{
+				component.resize(InputCount);
+			}
+
+			for (size_t i = 0; i < InputCount; ++i)
+			{
+				const CU::Vector3f& translation = transforms[i].GetTranslation();
+				const CU::Quatf& rotation = transforms[i].GetRotationQuat();
+				const CU::Vector3f& scale = transforms[i].GetScale();
+
+				components[0][i] = translation.x;
+				components[1][i] = translation.y;
+				components[2][i] = translation.z;
+				components[3][i] = rotation.x;
+				components[4][i] = rotation.y;
+				components[5][i] = rotation.z;
+				components[6][i] = rotation.w;
+				components[7][i] = scale.x;
+				components[8][i] = scale.y;
+				components[9][i] = scale.z;
+			}
+
+			const CU::TransformBatch batch
+			{
+				components[0], components[1], components[2],
+				components[3], components[4], components[5], components[6],
+				components[7], components[8], components[9]
+			};
+
+			std::vector<CU::Matrix4x4f> output(InputCount);
+			aRunner.Run("TransformBatch/ComposeMatrices", [&]()
+				{
+					CU::ComposeMatrices(batch, output);
+					Bench::DoNotOptimize(output.data());
+				}, InputCount);
+
+			aRunner.Run("TransformBatch/ComposeWorldMatrices", [&]()
+				{
+					CU::ComposeMatrices(batch, matrices, output);
+					Bench::DoNotOptimize(output.data());
+				}, InputCount);
+		}
+
+		{
+			// The std loops are the per-element code the batch functions replace
+			std::mt19937 engine(1337);
+			std::uniform_real_distribution<float> angle(-CU::Math::Pi, CU::Math::Pi);
+			std::uniform_real_distribution<float> positive(0.001f, 100.0f);
+
+			std::vector<float> angles(InputCount);
+			std::vector<float> values(InputCount);
+			std::vector<float> otherValues(InputCount);
+			for (size_t i = 0; i < InputCount; ++i)
+			{
+				angles[i] = angle(engine);
+				values[i] = positive(engine);
+				otherValues[i] = angle(engine);
+			}
+
+			std::vector<float> output(InputCount);
+			std::vector<float> otherOutput(InputCount);
+
+			aRunner.Run("MathBatch/SinCos", [&]()
+				{
+					CU::Math::SinCos(angles, output, otherOutput);
+					Bench::DoNotOptimize(output.data());
+				}, InputCount);
+
+			aRunner.Run("MathBatch/SinCosStd", [&]()
+				{
+					for (size_t i = 0; i < InputCount; ++i)
+					{
+						output[i] = std::sin(angles[i]);
+						otherOutput[i] = std::cos(angles[i]);
+					}
+					Bench::DoNotOptimize(output.data());
+				}, InputCount);
+
+			aRunner.Run("MathBatch/RSqrt", [&]()
+				{
+					CU::Math::RSqrt(values, output);
+					Bench::DoNotOptimize(output.data());
+				}, InputCount);
+
+			aRunner.Run("MathBatch/Atan2", [&]()
+				{
+					CU::Math::Atan2(angles, otherValues, output);
+					Bench::DoNotOptimize(output.data());
+				}, InputCount);
+
+			aRunner.Run("MathBatch/Atan2Std", [&]()
+				{
+					for (size_t i = 0; i < InputCount; ++i)
+					{
+						output[i] = std::atan2(angles[i], otherValues[i]);
+					}
+					Bench::DoNotOptimize(output.data());
+				}, InputCount);
+
+			aRunner.Run("MathBatch/Exp", [&]()
+				{
+					CU::Math::Exp(angles, output);
+					Bench::DoNotOptimize(output.data());
+				}, InputCount);
+
+			aRunner.Run("MathBatch/Log", [&]()
+				{
+					CU::Math::Log(values, output);
+					Bench::DoNotOptimize(output.data());
+				}, InputCount);
+
+			std::vector<CU::Vector3f> eulerAngles(InputCount);
+			std::vector<CU::Vector3f> vectors(InputCount);
+			for (size_t i = 0; i < InputCount; ++i)
+			{
+				eulerAngles[i] = transforms[i].GetRotation();
+				vectors[i] = transforms[i].GetTranslation();
+			}
+
+			std::vector<CU::Vector3f> normalized(InputCount);
+			aRunner.Run("MathBatch/NormalizeVectors", [&]()
+				{
+					normalized = vectors;
+					CU::Math::NormalizeVectors(normalized);
+					Bench::DoNotOptimize(normalized.data());
+				}, InputCount);
+
+			aRunner.Run("MathBatch/NormalizeVectorsScalar", [&]()
+				{
+					normalized = vectors;
+					for (CU::Vector3f& vector : normalized)
+					{
+						vector.Normalize();
+					}
+					Bench::DoNotOptimize(normalized.data());
+				}, InputCount);
+
+			std::vector<CU::Quatf> quaternions(InputCount);
+			aRunner.Run("MathBatch/EulerToQuat", [&]()
+				{
+					CU::Math::EulerToQuat(eulerAngles, quaternions);
+					Bench::DoNotOptimize(quaternions.data());
+				}, InputCount);
+		}
+
+		{
+			const CU::Matrix4x4f viewProjection = matrices[0].GetFastInverse() * CU::Matrix4x4f::CreatePerspectiveProjection(80.0f * CU::Math::ToRad, 1.0f, 250.0f, 16.0f / 9.0f);
+			const CU::Frustum frustum(viewProjection);
+
+			std::vector<CU::AABB> boxes(InputCount);
+			std::vector<CU::Sphere> spheres(InputCount);
+			for (size_t i = 0; i < InputCount; ++i)
+			{
+				boxes[i] = CU::AABB::FromCenterExtents(transforms[i].GetTranslation(), transforms[i].GetScale());
+				spheres[i] = CU::Sphere::FromAABB(boxes[i]);
+			}
+
+			std::vector<uint64_t> visibility(CU::GetVisibilityMaskSize(InputCount));
+			aRunner.Run("Geometry/FrustumTestAABBs", [&]()
+				{
+					Bench::DoNotOptimize(CU::TestVisibility(frustum, boxes, visibility));
+				}, InputCount);
+
+			aRunner.Run("Geometry/FrustumTestSpheres", [&]()
+				{
+					Bench::DoNotOptimize(CU::TestVisibility(frustum, spheres, visibility));
+				}, InputCount);
+
+			std::vector<CU::AABB> transformedBoxes(InputCount);
+			aRunner.Run("Geometry/TransformAABBs", [&]()
+				{
+					CU::TransformAABBs(boxes, matrices, transformedBoxes);
+					Bench::DoNotOptimize(transformedBoxes.data());
+				}, InputCount);
+		}
+	}
+}
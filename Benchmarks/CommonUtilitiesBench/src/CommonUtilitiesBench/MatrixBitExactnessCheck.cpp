@@ -0,0 +1,243 @@
+#include "Benchmarks.h"
+#include "ScalarMatrix.h"
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <CommonUtilities/Math/Matrix/Matrix.h>
+#include <CommonUtilities/Math/Transform.h>
+
+namespace CUBench
+{
+	namespace
+	{
+		// Of each kind of input, from a fixed seed so a mismatch can be reproduced
+		constexpr size_t CheckMatrixCount = 50000;
+		// Mismatches printed per operation, the rest are only counted
+		constexpr uint32_t MaxPrintedMismatches = 4;
+
+		struct CheckInput
+		{
+			const char* Kind;
+			CU::Matrix4x4f Matrix;
+			CU::Vector4f Vector;
+		};
+
+		CU::Matrix4x4f CreateAffine(std::mt19937& aEngine, float aMinScale, float aMaxScale)
+		{
+			std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+			std::uniform_real_distribution<float> angle(-CU::Math::Pi, CU::Math::Pi);
+			std::uniform_real_distribution<float> scale(aMinScale, aMaxScale);
+			std::bernoulli_distribution mirror(0.25);
+
+			CU::Vector3f scales(scale(aEngine), scale(aEngine), scale(aEngine));
+			if (mirror(aEngine))
+			{
+				scales.x = -scales.x;
+			}
+
+			CU::Transform transform(
+				CU::Vector3f(position(aEngine), position(aEngine), position(aEngine)),
+				CU::Vector3f(angle(aEngine), angle(aEngine), angle(aEngine)),
+				scales);
+			return transform.GetMatrix();
+		}
+
+		// Random, affine, singular and degenerate matrices, each with a random vector to transform
+		std::vector<CheckInput> CreateCheckInputs()
+		{
+			std::mt19937 engine(1337);
+			std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+			std::uniform_int_distribution<int> index(0, 3);
+			std::uniform_int_distribution<int> degenerateKind(0, 4);
+
+			auto randomVector = [&]() { return CU::Vector4f(value(engine), value(engine), value(engine), value(engine)); };
+
+			std::vector<CheckInput> inputs;
+			inputs.reserve(CheckMatrixCount * 4);
+
+			for (size_t i = 0; i < CheckMatrixCount; ++i)
+			{
+				CU::Matrix4x4f matrix;
+				for (int element = 0; element < 16; ++element)
+				{
+					matrix[element] = value(engine);
+				}
+				inputs.push_back({ "random", matrix, randomVector() });
+			}
+
+			for (size_t i = 0; i < CheckMatrixCount; ++i)
+			{
+				inputs.push_back({ "affine", CreateAffine(engine, 0.1f, 4.0f), randomVector() });
+			}
+
+			// One row a multiple of another, or all zero, so the determinant is zero or close to it
+			for (size_t i = 0; i < CheckMatrixCount; ++i)
+			{
+				CU::Matrix4x4f matrix;
+				for (int element = 0; element < 16; ++element)
+				{
+					matrix[element] = value(engine);
+				}
+
+				const int from = index(engine);
+				const int to = (from + 1 + index(engine) % 3) % 4;
+				const float factor = (i % 8 == 0) ? 0.0f : value(engine);
+				for (int column = 0; column < 4; ++column)
+				{
+					matrix(to + 1, column + 1) = matrix(from + 1, column + 1) * factor;
+				}
+				inputs.push_back({ "singular", matrix, randomVector() });
+			}
+
+			for (size_t i = 0; i < CheckMatrixCount; ++i)
+			{
+				CU::Matrix4x4f matrix;
+				switch (degenerateKind(engine))
+				{
+				case 0:
+					// A scale axis collapsed to zero
+					matrix = CreateAffine(engine, 0.1f, 4.0f);
+					for (int column = 1; column <= 3; ++column)
+					{
+						matrix(index(engine) % 3 + 1, column) = 0.0f;
+					}
+					break;
+				case 1:
+					matrix = CreateAffine(engine, 1e-6f, 1e-4f);
+					break;
+				case 2:
+					matrix = CreateAffine(engine, 1e4f, 1e6f);
+					break;
+				case 3:
+					// Denormals
+					for (int element = 0; element < 16; ++element)
+					{
+						matrix[element] = value(engine) * 1e-39f;
+					}
+					break;
+				default:
+					matrix = (i % 2 == 0) ? CU::Matrix4x4f::Zero : CU::Matrix4x4f::Identity;
+					break;
+				}
+				inputs.push_back({ "degenerate", matrix, randomVector() });
+			}
+
+			return inputs;
+		}
+
+		class MismatchCounter
+		{
+		public:
+			void Check(const char* aOperation, const CheckInput& aInput, size_t aIndex, const float* aSIMD, const float* aScalar, size_t aCount)
+			{
+				if (std::memcmp(aSIMD, aScalar, aCount * sizeof(float)) == 0) return;
+
+				if (++myCounts[aOperation] <= MaxPrintedMismatches)
+				{
+					std::printf("Bit mismatch in %s, %s matrix %zu:\n", aOperation, aInput.Kind, aIndex);
+					for (size_t i = 0; i < aCount; ++i)
+					{
+						if (std::memcmp(&aSIMD[i], &aScalar[i], sizeof(float)) == 0) continue;
+						std::printf("  [%zu] SIMD %.9g, generic %.9g\n", i, aSIMD[i], aScalar[i]);
+					}
+				}
+			}
+
+			uint32_t Print() const
+			{
+				uint32_t total = 0;
+				for (const auto& [operation, count] : myCounts)
+				{
+					std::printf("  %s: %u mismatches\n", operation.c_str(), count);
+					total += count;
+				}
+				return total;
+			}
+
+		private:
+			std::map<std::string, uint32_t> myCounts;
+		};
+	}
+
+	bool RunMatrixBitExactnessCheck()
+	{
+		const std::vector<CheckInput> inputs = CreateCheckInputs();
+		MismatchCounter mismatches;
+
+		for (size_t i = 0; i < inputs.size(); ++i)
+		{
+			const CheckInput& input = inputs[i];
+			const CU::Matrix4x4f& matrix = input.Matrix;
+			const CU::Matrix4x4f& other = inputs[(i + 1) % inputs.size()].Matrix;
+			const float* data = &matrix[0];
+
+			float scalar[16];
+
+			const CU::Matrix4x4f product = matrix * other;
+			ScalarMatrix::Multiply4x4(data, &other[0], scalar);
+			mismatches.Check("Matrix4x4f * Matrix4x4f", input, i, &product[0], scalar, 16);
+
+			const CU::Vector4f transformed = matrix * input.Vector;
+			ScalarMatrix::TransformVector(data, &input.Vector.x, scalar);
+			mismatches.Check("Matrix4x4f * Vector4f", input, i, &transformed.x, scalar, 4);
+
+			const CU::Vector4f transformedLeft = input.Vector * matrix;
+			ScalarMatrix::TransformVectorLeft(&input.Vector.x, data, scalar);
+			mismatches.Check("Vector4f * Matrix4x4f", input, i, &transformedLeft.x, scalar, 4);
+
+			const CU::Matrix4x4f transpose = matrix.GetTranspose();
+			ScalarMatrix::GetTranspose(data, scalar);
+			mismatches.Check("GetTranspose", input, i, &transpose[0], scalar, 16);
+
+			CU::Matrix4x4f transposedInPlace = matrix;
+			transposedInPlace.Transpose();
+			std::memcpy(scalar, data, sizeof(float) * 16);
+			ScalarMatrix::Transpose(scalar);
+			mismatches.Check("Transpose", input, i, &transposedInPlace[0], scalar, 16);
+
+			const CU::Matrix4x4f inverse = matrix.GetInverse();
+			ScalarMatrix::GetInverse(data, scalar);
+			mismatches.Check("GetInverse", input, i, &inverse[0], scalar, 16);
+
+			const CU::Matrix4x4f fastInverse = matrix.GetFastInverse();
+			ScalarMatrix::GetFastInverse(data, scalar);
+			mismatches.Check("GetFastInverse", input, i, &fastInverse[0], scalar, 16);
+
+			{
+				CU::Vector3f position, rotation, scale;
+				matrix.Decompose(position, rotation, scale);
+				const float simd[9] = { position.x, position.y, position.z, rotation.x, rotation.y, rotation.z, scale.x, scale.y, scale.z };
+				ScalarMatrix::DecomposeEuler(data, scalar, scalar + 3, scalar + 6);
+				mismatches.Check("Decompose (euler)", input, i, simd, scalar, 9);
+			}
+
+			{
+				CU::Vector3f position, scale;
+				CU::Quatf orientation;
+				matrix.Decompose(position, orientation, scale);
+				const float simd[10] = { position.x, position.y, position.z, orientation.w, orientation.x, orientation.y, orientation.z, scale.x, scale.y, scale.z };
+				ScalarMatrix::DecomposeQuaternion(data, scalar, scalar + 3, scalar + 7);
+				mismatches.Check("Decompose (quaternion)", input, i, simd, scalar, 10);
+			}
+
+			{
+				CU::Matrix3x3f lhs, rhs;
+				for (int element = 0; element < 9; ++element)
+				{
+					lhs[element] = matrix[element + element / 3];
+					rhs[element] = other[element + element / 3];
+				}
+				const CU::Matrix3x3f product3x3 = lhs * rhs;
+				ScalarMatrix::Multiply3x3(&lhs[0], &rhs[0], scalar);
+				mismatches.Check("Matrix3x3f * Matrix3x3f", input, i, &product3x3[0], scalar, 9);
+			}
+		}
+
+		const uint32_t total = mismatches.Print();
+		std::printf("Matrix bit exactness check: %zu matrices against the generic code, %u mismatches\n", inputs.size(), total);
+		return total == 0;
+	}
+}
@@ -0,0 +1,50 @@
+#include "Benchmarks.h"
+#include <vector>
+#include <CommonUtilities/Math/Random.h>
+
+namespace CUBench
+{
+	void RunRandomBenchmarks(Bench::Runner& aRunner)
+	{
+		CU::Random::Init();
+
+		aRunner.Run("Random/UInt", []()
+			{
+				Bench::DoNotOptimize(CU::Random::UInt());
+			});
+
+		aRunner.Run("Random/IntRange", []()
+			{
+				Bench::DoNotOptimize(CU::Random::Int(-100, 100));
+			});
+
+		aRunner.Run("Random/Float01", []()
+			{
+				Bench::DoNotOptimize(CU::Random::Float01());
+			});
+
+		aRunner.Run("Random/FloatRange", []()
+			{
+				Bench::DoNotOptimize(CU::Random::Float(-5.0f, 5.0f));
+			});
+
+		aRunner.Run("Random/Vector3", []()
+			{
+				Bench::DoNotOptimize(CU::Random::Vector3(-5.0f, 5.0f));
+			});
+
+		std::vector<float> floats(InputCount);
+		aRunner.Run("Random/FillFloat01", [&]()
+			{
+				CU::Random::FillFloat01(floats);
+				Bench::DoNotOptimize(floats.data());
+			}, InputCount);
+
+		std::vector<CU::Vector3f> vectors(InputCount);
+		aRunner.Run("Random/FillVector3", [&]()
+			{
+				CU::Random::FillVector3(vectors, -5.0f, 5.0f);
+				Bench::DoNotOptimize(vectors.data());
+			}, InputCount);
+	}
+}
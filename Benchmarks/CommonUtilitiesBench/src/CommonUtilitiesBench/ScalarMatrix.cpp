@@ -0,0 +1,119 @@
+#include "ScalarMatrix.h"
+#include <cstring>
+
+// The float specializations are explicit specializations, so the generic code can't be instantiated for float next to them.
+// This file builds the headers without SIMD and in a namespace of its own, so its Matrix4x4<float> is a different type.
+#define CU_NO_SIMD
+#define CU CUScalar
+#include <CommonUtilities/Math/Matrix/Matrix.h>
+#undef CU
+
+namespace CUBench::ScalarMatrix
+{
+	namespace
+	{
+		using Matrix3x3 = CUScalar::Matrix3x3<float>;
+		using Matrix4x4 = CUScalar::Matrix4x4<float>;
+		using Vector3 = CUScalar::Vector3<float>;
+		using Vector4 = CUScalar::Vector4<float>;
+		using Quaternion = CUScalar::Quaternion<float>;
+
+		Matrix3x3 Load3x3(const float* aMatrix)
+		{
+			Matrix3x3 matrix;
+			for (int i = 0; i < 9; ++i)
+			{
+				matrix[i] = aMatrix[i];
+			}
+			return matrix;
+		}
+
+		void Store(const Matrix4x4& aMatrix, float* outResult)
+		{
+			std::memcpy(outResult, &aMatrix[0], sizeof(float) * 16);
+		}
+
+		void Store(const Vector3& aVector, float* outResult)
+		{
+			outResult[0] = aVector.x;
+			outResult[1] = aVector.y;
+			outResult[2] = aVector.z;
+		}
+
+		void Store(const Vector4& aVector, float* outResult)
+		{
+			outResult[0] = aVector.x;
+			outResult[1] = aVector.y;
+			outResult[2] = aVector.z;
+			outResult[3] = aVector.w;
+		}
+	}
+
+	void Multiply4x4(const float* aLhs, const float* aRhs, float* outResult)
+	{
+		Store(Matrix4x4(aLhs) * Matrix4x4(aRhs), outResult);
+	}
+
+	void TransformVector(const float* aMatrix, const float* aVector, float* outResult)
+	{
+		Store(Matrix4x4(aMatrix) * Vector4(aVector[0], aVector[1], aVector[2], aVector[3]), outResult);
+	}
+
+	void TransformVectorLeft(const float* aVector, const float* aMatrix, float* outResult)
+	{
+		Store(Vector4(aVector[0], aVector[1], aVector[2], aVector[3]) * Matrix4x4(aMatrix), outResult);
+	}
+
+	void GetTranspose(const float* aMatrix, float* outResult)
+	{
+		Store(Matrix4x4(aMatrix).GetTranspose(), outResult);
+	}
+
+	void Transpose(float* aMatrix)
+	{
+		Matrix4x4 matrix(aMatrix);
+		matrix.Transpose();
+		Store(matrix, aMatrix);
+	}
+
+	void GetInverse(const float* aMatrix, float* outResult)
+	{
+		Store(Matrix4x4(aMatrix).GetInverse(), outResult);
+	}
+
+	void GetFastInverse(const float* aMatrix, float* outResult)
+	{
+		Store(Matrix4x4(aMatrix).GetFastInverse(), outResult);
+	}
+
+	void DecomposeEuler(const float* aMatrix, float* outPosition, float* outRotation, float* outScale)
+	{
+		Vector3 position, rotation, scale;
+		Matrix4x4(aMatrix).Decompose(position, rotation, scale);
+		Store(position, outPosition);
+		Store(rotation, outRotation);
+		Store(scale, outScale);
+	}
+
+	void DecomposeQuaternion(const float* aMatrix, float* outPosition, float* outOrientation, float* outScale)
+	{
+		Vector3 position, scale;
+		Quaternion orientation;
+		Matrix4x4(aMatrix).Decompose(position, orientation, scale);
+		Store(position, outPosition);
+		outOrientation[0] = orientation.w;
+		outOrientation[1] = orientation.x;
+		outOrientation[2] = orientation.y;
+		outOrientation[3] = orientation.z;
+		Store(scale, outScale);
+	}
+
+	void Multiply3x3(const float* aLhs, const float* aRhs, float* outResult)
+	{
+		const Matrix3x3 result = Load3x3(aLhs) * Load3x3(aRhs);
+		for (int i = 0; i < 9; ++i)
+		{
+			outResult[i] = result[i];
+		}
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+// The generic Matrix3x3/Matrix4x4 code instantiated for float, without the SIMD specializations, for checking them against it.
+// Matrices are row-major float arrays like the matrix classes, quaternions are w, x, y, z.
+namespace CUBench::ScalarMatrix
+{
+	void Multiply4x4(const float* aLhs, const float* aRhs, float* outResult);
+	void TransformVector(const float* aMatrix, const float* aVector, float* outResult);
+	void TransformVectorLeft(const float* aVector, const float* aMatrix, float* outResult);
+	void GetTranspose(const float* aMatrix, float* outResult);
+	void Transpose(float* aMatrix);
+	void GetInverse(const float* aMatrix, float* outResult);
+	void GetFastInverse(const float* aMatrix, float* outResult);
+	void DecomposeEuler(const float* aMatrix, float* outPosition, float* outRotation, float* outScale);
+	void DecomposeQuaternion(const float* aMatrix, float* outPosition, float* outOrientation, float* outScale);
+	void Multiply3x3(const float* aLhs, const float* aRhs, float* outResult);
+}
@@ -0,0 +1,40 @@
+project "CoreBench"
+	kind "ConsoleApp"
+
+	targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+
+	-- Relative paths (baseline.json) resolve against the project folder when started from the IDE
+	debugdir "%{prj.location}"
+
+	apply_simd_flags()
+
+	defines
+	{
+		"TRACY_ENABLE",
+		"TRACY_ON_DEMAND",
+		"TRACY_CALLSTACK=10"
+	}
+
+	files
+	{
+		"src/**.h",
+		"src/**.hpp",
+		"src/**.cpp"
+	}
+
+	includedirs
+	{
+		"src",
+		"%{wks.location}/CommonUtilities/src",
+		"%{wks.location}/vendor/spdlog/include",
+		"%{wks.location}/vendor/tracy/tracy",
+		"%{wks.location}/Epoch/Core/src",
+		"%{wks.location}/Benchmarks/BenchmarkCore/src",
+	}
+
+	links
+	{
+		"EpochCore",
+		"BenchmarkCore",
+	}
@@ -0,0 +1,7 @@
+#pragma once
+#include <BenchmarkCore/Benchmark.h>
+
+namespace CoreBench
+{
+	void RunJobSystemBenchmarks(Bench::Runner& aRunner);
+}
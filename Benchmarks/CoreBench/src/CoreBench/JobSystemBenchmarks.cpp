@@ -0,0 +1,125 @@
+#include "Benchmarks.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+#include <EpochCore/JobSystem.h>
+
+namespace CoreBench
+{
+	namespace
+	{
+		using Epoch::Core::JobCounter;
+		using Epoch::Core::JobSystem;
+
+		constexpr uint32_t ItemCount = 1 << 20;
+		constexpr uint32_t JobCount = 1024;
+		constexpr uint32_t FanOutCount = 64;
+
+		// 1, 2, 4 and so on up to the core count, which is always included
+		std::vector<uint32_t> GetThreadCounts()
+		{
+			const uint32_t coreCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+			std::vector<uint32_t> threadCounts;
+			for (uint32_t count = 1; count < coreCount; count *= 2)
+			{
+				threadCounts.emplace_back(count);
+			}
+			threadCounts.emplace_back(coreCount);
+			return threadCounts;
+		}
+
+		// About as much work per item as a transform update
+		float Compute(float aValue)
+		{
+			for (int i = 0; i < 16; ++i)
+			{
+				aValue = std::sqrt(aValue * aValue + 1.0f) * 0.5f;
+			}
+			return aValue;
+		}
+	}
+
+	void RunJobSystemBenchmarks(Bench::Runner& aRunner)
+	{
+		std::vector<float> input(ItemCount);
+		for (uint32_t i = 0; i < ItemCount; ++i)
+		{
+			input[i] = static_cast<float>(i % 1000);
+		}
+		std::vector<float> output(ItemCount);
+
+		for (uint32_t threadCount : GetThreadCounts())
+		{
+			JobSystem::Initialize(threadCount);
+			const std::string threads = std::to_string(threadCount) + "Threads";
+
+			// Compare the same benchmark between thread counts for the scaling
+			aRunner.Run("JobSystem/ParallelFor/1M/Compute/" + threads, [&]()
+				{
+					JobSystem::ParallelFor(ItemCount, [&](uint32_t aBegin, uint32_t aEnd)
+						{
+							for (uint32_t i = aBegin; i < aEnd; ++i)
+							{
+								output[i] = Compute(input[i]);
+							}
+						});
+					Bench::DoNotOptimize(output.data());
+				}, ItemCount);
+
+			// Bound by memory bandwidth rather than by the cores
+			aRunner.Run("JobSystem/ParallelFor/1M/Copy/" + threads, [&]()
+				{
+					JobSystem::ParallelFor(ItemCount, [&](uint32_t aBegin, uint32_t aEnd)
+						{
+							std::copy(input.begin() + aBegin, input.begin() + aEnd, output.begin() + aBegin);
+						});
+					Bench::DoNotOptimize(output.data());
+				}, ItemCount);
+
+			// What starting, running and waiting for a job costs when it does nothing
+			aRunner.Run("JobSystem/Run/1K/Empty/" + threads, [&]()
+				{
+					JobCounter counter;
+					for (uint32_t i = 0; i < JobCount; ++i)
+					{
+						JobSystem::Run([]() {}, &counter);
+					}
+					JobSystem::Wait(counter);
+				}, JobCount);
+
+			// A fan out, then a fan in, each of the second wave waiting for the whole first one
+			aRunner.Run("JobSystem/RunAfter/64x64/Compute/" + threads, [&]()
+				{
+					JobCounter first;
+					JobCounter second;
+					for (uint32_t i = 0; i < FanOutCount; ++i)
+					{
+						JobSystem::Run([&output, &input, i]()
+							{
+								for (uint32_t j = i; j < ItemCount / 16; j += FanOutCount)
+								{
+									output[j] = Compute(input[j]);
+								}
+							}, &first);
+					}
+					for (uint32_t i = 0; i < FanOutCount; ++i)
+					{
+						JobSystem::RunAfter(first, [&output, i]()
+							{
+								for (uint32_t j = i; j < ItemCount / 16; j += FanOutCount)
+								{
+									output[j] = Compute(output[j]);
+								}
+							}, &second);
+					}
+					JobSystem::Wait(second);
+					Bench::DoNotOptimize(output.data());
+				}, ItemCount / 8);
+
+			JobSystem::Shutdown();
+		}
+	}
+}
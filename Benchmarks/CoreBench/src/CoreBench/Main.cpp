@@ -0,0 +1,10 @@
+#include "Benchmarks.h"
+
+int main(int argc, char** argv)
+{
+	Bench::Runner runner(argc, argv);
+
+	CoreBench::RunJobSystemBenchmarks(runner);
+
+	return runner.Finish();
+}
@@ -0,0 +1,134 @@
+#include "Benchmarks.h"
+#include <random>
+#include <vector>
+#include <EpochScenes/Scene.h>
+
+namespace ScenesBench
+{
+	namespace
+	{
+		using namespace Epoch::Scenes;
+
+		// Props of 64 meshes scattered over a 2x2 km level. No asset manager is set so every mesh is a point at its entity,
+		// which keeps the tree shape the same as with real bounds of similar size.
+		constexpr size_t RootCount = 1563;
+		constexpr size_t ChildrenPerRoot = 63;
+		constexpr size_t EntityCount = RootCount * (ChildrenPerRoot + 1);
+		constexpr float LevelExtent = 1000.0f;
+
+		// Moved per iteration of the refit benchmark, about 1% of the scene
+		constexpr size_t MovedRootCount = 16;
+	}
+
+	void RunBVHBenchmarks(Bench::Runner& aRunner)
+	{
+		std::mt19937 engine(1337);
+		std::uniform_real_distribution<float> levelPosition(-LevelExtent, LevelExtent);
+		std::uniform_real_distribution<float> localPosition(-5.0f, 5.0f);
+
+		Scene scene;
+		std::vector<Entity> roots;
+		for (size_t i = 0; i < RootCount; ++i)
+		{
+			Entity root = scene.CreateEntity("Root");
+			root.GetComponent<TransformComponent>().LocalTransform.SetTranslation({ levelPosition(engine), 0.0f, levelPosition(engine) });
+
+			for (size_t j = 0; j < ChildrenPerRoot; ++j)
+			{
+				Entity child = scene.CreateChildEntity(root, "Child");
+				child.GetComponent<TransformComponent>().LocalTransform.SetTranslation({ localPosition(engine), localPosition(engine), localPosition(engine) });
+				child.AddComponent<MeshRendererComponent>(Epoch::AssetHandle(j + 1));
+			}
+			roots.emplace_back(root);
+		}
+		scene.UpdateWorldTransforms();
+
+		const SceneBVH& bvh = scene.GetBVH();
+
+		// Every mesh renderer queued and inserted into an empty tree, what loading a level costs
+		{
+			entt::registry registry;
+			for (auto [entity, renderer, world] : scene.GetAllEntitiesWith<MeshRendererComponent, WorldTransformComponent>().each())
+			{
+				const entt::entity copy = registry.create();
+				registry.emplace<MeshRendererComponent>(copy, renderer);
+				registry.emplace<WorldTransformComponent>(copy, world);
+			}
+
+			aRunner.Run("SceneBVH/Build/100K", [&]()
+				{
+					SceneBVH rebuilt;
+					for (entt::entity entity : registry.view<MeshRendererComponent>())
+					{
+						rebuilt.OnMeshRendererChanged(registry, entity);
+					}
+					rebuilt.Update(registry, {});
+					Bench::DoNotOptimize(rebuilt.GetHeight());
+				}, EntityCount);
+		}
+
+		// Every root drifts along x, a few of them per update. Includes the world transform update of the moved subtrees.
+		size_t moveIndex = 0;
+		auto moveRoots = [&]()
+			{
+				for (size_t i = 0; i < MovedRootCount; ++i)
+				{
+					Entity root = roots[moveIndex];
+					moveIndex = (moveIndex + 1) % RootCount;
+
+					auto& transform = root.GetComponent<TransformComponent>().LocalTransform;
+					transform.SetTranslation(transform.GetTranslation() + CU::Vector3f(0.5f, 0.0f, 0.0f));
+					scene.MarkTransformDirty(root);
+				}
+				scene.UpdateWorldTransforms();
+			};
+
+		// One round over all roots first so the leaves have boxes stretched along their movement, like in a running game
+		for (size_t i = 0; i < RootCount; i += MovedRootCount)
+		{
+			moveRoots();
+		}
+
+		aRunner.Run("SceneBVH/Refit/1PercentMoved", moveRoots, MovedRootCount * ChildrenPerRoot);
+
+		const CU::Matrix4x4f projection = CU::Matrix4x4f::CreatePerspectiveProjection(CU::Math::Pi * 0.4f, 16.0f / 9.0f, 0.1f, 500.0f);
+		const CU::Frustum frustum(projection);
+
+		aRunner.Run("SceneBVH/QueryFrustum/100K", [&]()
+			{
+				size_t visible = 0;
+				bvh.Query(frustum, [&visible](entt::entity) { ++visible; });
+				Bench::DoNotOptimize(visible);
+			}, EntityCount);
+
+		// What culling cost before the BVH, every entity's bounds tested
+		aRunner.Run("SceneBVH/QueryFrustum/100K/Linear", [&]()
+			{
+				size_t visible = 0;
+				for (auto [entity, renderer] : scene.GetAllEntitiesWith<MeshRendererComponent>().each())
+				{
+					if (frustum.Intersects(bvh.GetBounds(entity))) ++visible;
+				}
+				Bench::DoNotOptimize(visible);
+			}, EntityCount);
+
+		std::uniform_real_distribution<float> boxExtent(5.0f, 50.0f);
+		aRunner.Run("SceneBVH/QueryAABB/100K", [&]()
+			{
+				const CU::Vector3f center(levelPosition(engine), 0.0f, levelPosition(engine));
+				const CU::AABB box = CU::AABB::FromCenterExtents(center, CU::Vector3f(boxExtent(engine)));
+
+				size_t overlapping = 0;
+				bvh.Query(box, [&overlapping](entt::entity) { ++overlapping; });
+				Bench::DoNotOptimize(overlapping);
+			}, 1);
+
+		aRunner.Run("SceneBVH/RaycastClosest/100K", [&]()
+			{
+				const CU::Ray ray(CU::Vector3f(levelPosition(engine), 2.0f, levelPosition(engine)), CU::Vector3f(levelPosition(engine), 0.0f, levelPosition(engine)));
+
+				float distance;
+				Bench::DoNotOptimize(bvh.RaycastClosest(ray, 2.0f * LevelExtent, distance));
+			}, 1);
+	}
+}
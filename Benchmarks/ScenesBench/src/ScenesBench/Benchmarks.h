@@ -0,0 +1,14 @@
+#pragma once
+#include <BenchmarkCore/Benchmark.h>
+
+namespace ScenesBench
+{
+	void RunTransformBenchmarks(Bench::Runner& aRunner);
+	void RunHierarchyBenchmarks(Bench::Runner& aRunner);
+	void RunEntityIDMapBenchmarks(Bench::Runner& aRunner);
+	void RunSerializerBenchmarks(Bench::Runner& aRunner);
+	void RunSnapshotBenchmarks(Bench::Runner& aRunner);
+	void RunBVHBenchmarks(Bench::Runner& aRunner);
+	void RunSystemBenchmarks(Bench::Runner& aRunner);
+	void RunRenderProxyBenchmarks(Bench::Runner& aRunner);
+}
@@ -0,0 +1,85 @@
+#include "Benchmarks.h"
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <EpochScenes/EntityIDMap.h>
+
+namespace ScenesBench
+{
+	namespace
+	{
+		constexpr size_t EntryCount = 1 << 20;
+		constexpr size_t LookupCount = 1 << 16;
+	}
+
+	void RunEntityIDMapBenchmarks(Bench::Runner& aRunner)
+	{
+		std::mt19937_64 engine(1337);
+
+		std::vector<Epoch::UUID> ids;
+		ids.reserve(EntryCount);
+		for (size_t i = 0; i < EntryCount; ++i)
+		{
+			ids.emplace_back(engine());
+		}
+
+		// Random order, so the lookups don't follow the insertion order
+		std::vector<Epoch::UUID> lookups;
+		std::vector<Epoch::UUID> misses;
+		for (size_t i = 0; i < LookupCount; ++i)
+		{
+			lookups.emplace_back(ids[engine() % EntryCount]);
+			misses.emplace_back(engine());
+		}
+
+		Epoch::Scenes::EntityIDMap map;
+		std::unordered_map<Epoch::UUID, entt::entity> reference;
+		for (size_t i = 0; i < EntryCount; ++i)
+		{
+			map.Insert(ids[i], static_cast<entt::entity>(i));
+			reference.emplace(ids[i], static_cast<entt::entity>(i));
+		}
+
+		aRunner.Run("EntityIDMap/Find/1M", [&]()
+			{
+				for (Epoch::UUID id : lookups)
+				{
+					Bench::DoNotOptimize(map.Find(id));
+				}
+			}, LookupCount);
+
+		aRunner.Run("EntityIDMap/FindMissing/1M", [&]()
+			{
+				for (Epoch::UUID id : misses)
+				{
+					Bench::DoNotOptimize(map.Find(id));
+				}
+			}, LookupCount);
+
+		// Steady state churn, one entity destroyed and one created per item
+		size_t index = 0;
+		aRunner.Run("EntityIDMap/EraseInsert/1M", [&]()
+			{
+				const Epoch::UUID id = ids[index];
+				map.Erase(id);
+				map.Insert(id, static_cast<entt::entity>(index));
+				index = (index + 7919) & (EntryCount - 1);
+			});
+
+		aRunner.Run("std::unordered_map/Find/1M", [&]()
+			{
+				for (Epoch::UUID id : lookups)
+				{
+					Bench::DoNotOptimize(reference.find(id)->second);
+				}
+			}, LookupCount);
+
+		aRunner.Run("std::unordered_map/EraseInsert/1M", [&]()
+			{
+				const Epoch::UUID id = ids[index];
+				reference.erase(id);
+				reference.emplace(id, static_cast<entt::entity>(index));
+				index = (index + 7919) & (EntryCount - 1);
+			});
+	}
+}
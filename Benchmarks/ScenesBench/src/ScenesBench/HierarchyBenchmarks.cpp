@@ -0,0 +1,69 @@
+#include "Benchmarks.h"
+#include <vector>
+#include <EpochScenes/Scene.h>
+
+namespace ScenesBench
+{
+	namespace
+	{
+		using namespace Epoch::Scenes;
+
+		constexpr size_t SiblingCount = 4096;
+		constexpr size_t ChainLength = 1024;
+	}
+
+	void RunHierarchyBenchmarks(Bench::Runner& aRunner)
+	{
+		Scene scene;
+
+		Entity parentA = scene.CreateEntity("A");
+		Entity parentB = scene.CreateEntity("B");
+
+		std::vector<Entity> siblings;
+		siblings.reserve(SiblingCount);
+		for (size_t i = 0; i < SiblingCount; ++i)
+		{
+			siblings.emplace_back(scene.CreateChildEntity(parentA, "Sibling"));
+		}
+
+		Entity chainRoot = scene.CreateEntity("Chain");
+		Entity chainLeaf = chainRoot;
+		for (size_t i = 1; i < ChainLength; ++i)
+		{
+			chainLeaf = scene.CreateChildEntity(chainLeaf, "Link");
+		}
+
+		scene.UpdateWorldTransforms();
+
+		aRunner.Run("Hierarchy/TraverseChildren", [&]()
+			{
+				uint32_t count = 0;
+				for (Entity child = parentA.GetFirstChild(); child; child = child.GetNextSibling())
+				{
+					++count;
+				}
+				Bench::DoNotOptimize(count);
+			}, SiblingCount);
+
+		// Moves an entity out of the middle of a big sibling list and back
+		size_t index = 0;
+		aRunner.Run("Hierarchy/Reparent", [&]()
+			{
+				Entity entity = siblings[index];
+				index = (index + 997) % SiblingCount;
+
+				scene.ParentEntity(entity, parentB);
+				scene.ParentEntity(entity, parentA);
+			}, 2);
+
+		aRunner.Run("Hierarchy/IsAncestorOf/Deep", [&]()
+			{
+				Bench::DoNotOptimize(chainRoot.IsAncestorOf(chainLeaf));
+			});
+
+		aRunner.Run("Hierarchy/IsAncestorOf/Sibling", [&]()
+			{
+				Bench::DoNotOptimize(siblings[0].IsAncestorOf(siblings[SiblingCount - 1]));
+			});
+	}
+}
@@ -0,0 +1,20 @@
+#include "Benchmarks.h"
+#include <EpochCore/JobSystem.h>
+
+int main(int argc, char** argv)
+{
+	Bench::Runner runner(argc, argv);
+	Epoch::Core::JobSystem::Initialize();
+
+	ScenesBench::RunTransformBenchmarks(runner);
+	ScenesBench::RunHierarchyBenchmarks(runner);
+	ScenesBench::RunEntityIDMapBenchmarks(runner);
+	ScenesBench::RunSerializerBenchmarks(runner);
+	ScenesBench::RunSnapshotBenchmarks(runner);
+	ScenesBench::RunBVHBenchmarks(runner);
+	ScenesBench::RunSystemBenchmarks(runner);
+	ScenesBench::RunRenderProxyBenchmarks(runner);
+
+	Epoch::Core::JobSystem::Shutdown();
+	return runner.Finish();
+}
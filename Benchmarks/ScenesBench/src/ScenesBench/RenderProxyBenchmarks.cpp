@@ -0,0 +1,157 @@
+#include "Benchmarks.h"
+#include <memory>
+#include <random>
+#include <vector>
+#include <unordered_map>
+#include <EpochAssets/AssetManager.h>
+#include <EpochAssets/AssetSerializers/MeshImporters/MeshImporter.h>
+#include <EpochScenes/Scene.h>
+
+namespace ScenesBench
+{
+	namespace
+	{
+		using namespace Epoch::Scenes;
+
+		constexpr size_t EntityCount = 100000;
+		constexpr size_t MeshCount = 64;
+		constexpr float LevelExtent = 1000.0f;
+
+		// Moved per iteration of the incremental sync benchmark, 1% of the scene
+		constexpr size_t MovedCount = 1000;
+
+		// Only here for the protected SetMeshData(), the meshes are made up instead of imported
+		class BenchMeshFactory : public Epoch::Assets::MeshImporter
+		{
+		public:
+			bool ImportMesh(const Epoch::Assets::AssetMetadata&, Epoch::DataTypes::ModelData&, const Epoch::Assets::ModelImportSettings&) override { return false; }
+
+			// A triangle per submesh
+			std::shared_ptr<Epoch::Assets::MeshAsset> Create(Epoch::AssetHandle aHandle, uint32_t aSubMeshCount) const
+			{
+				Epoch::DataTypes::MeshData data;
+				for (uint32_t i = 0; i < aSubMeshCount; ++i)
+				{
+					const float offset = static_cast<float>(i);
+					data.SubMeshes.push_back({ static_cast<uint32_t>(data.Indices.size()), 3 });
+					for (const CU::Vector3f& position : { CU::Vector3f(offset, 0.0f, 0.0f), CU::Vector3f(offset + 1.0f, 0.0f, 0.0f), CU::Vector3f(offset, 1.0f, 0.0f) })
+					{
+						data.Indices.push_back(static_cast<uint32_t>(data.Vertices.size()));
+						data.Vertices.emplace_back().Position = position;
+					}
+				}
+
+				auto mesh = std::make_shared<Epoch::Assets::MeshAsset>(aHandle);
+				SetMeshData(mesh, data);
+				return mesh;
+			}
+		};
+
+		class BenchAssetManager : public Epoch::Assets::AssetManagerBase
+		{
+		public:
+			std::shared_ptr<Epoch::Assets::Asset> GetAsset(Epoch::AssetHandle aHandle) override
+			{
+				auto it = myAssets.find(aHandle);
+				return it != myAssets.end() ? it->second : nullptr;
+			}
+
+			void AddMemoryOnlyAsset(std::shared_ptr<Epoch::Assets::Asset> aAsset, std::string_view) override { myAssets[aAsset->GetHandle()] = aAsset; }
+			void ReloadAsset(Epoch::AssetHandle) override {}
+			void RemoveAsset(Epoch::AssetHandle aHandle) override { myAssets.erase(aHandle); }
+
+		private:
+			Epoch::Assets::AssetMap myAssets;
+		};
+	}
+
+	void RunRenderProxyBenchmarks(Bench::Runner& aRunner)
+	{
+		auto assetManager = std::make_shared<BenchAssetManager>();
+		Epoch::Assets::AssetManager::SetActiveAssetManager(assetManager);
+
+		// One to three submeshes per mesh, like props made of a few materials
+		BenchMeshFactory factory;
+		for (size_t i = 0; i < MeshCount; ++i)
+		{
+			assetManager->AddMemoryOnlyAsset(factory.Create(Epoch::AssetHandle(i + 1), static_cast<uint32_t>(i % 3) + 1), "Prop");
+		}
+
+		std::mt19937 engine(1337);
+		std::uniform_real_distribution<float> levelPosition(-LevelExtent, LevelExtent);
+		std::uniform_int_distribution<size_t> meshIndex(0, MeshCount - 1);
+
+		// Meshes picked at random so neighbouring entities rarely share one
+		{
+			Scene scene;
+			for (size_t i = 0; i < EntityCount; ++i)
+			{
+				Entity entity = scene.CreateEntity("Prop");
+				entity.GetComponent<TransformComponent>().LocalTransform.SetTranslation({ levelPosition(engine), 0.0f, levelPosition(engine) });
+				entity.AddComponent<MeshRendererComponent>(Epoch::AssetHandle(meshIndex(engine) + 1));
+			}
+			scene.UpdateWorldTransforms();
+
+			RenderProxyBuffer buffer;
+			aRunner.Run("RenderProxies/Extract/100K/Scattered", [&]()
+				{
+					scene.ExtractRenderProxies(buffer.GetWriteList());
+					buffer.Swap();
+					Bench::DoNotOptimize(buffer.GetReadList().Proxies.data());
+				}, EntityCount);
+		}
+
+		// Instances of a mesh created together, what InstantiateMany produces
+		{
+			Scene scene;
+			std::vector<Entity> entities;
+			for (size_t i = 0; i < EntityCount; ++i)
+			{
+				Entity entity = scene.CreateEntity("Prop");
+				entity.GetComponent<TransformComponent>().LocalTransform.SetTranslation({ levelPosition(engine), 0.0f, levelPosition(engine) });
+				entity.AddComponent<MeshRendererComponent>(Epoch::AssetHandle(i * MeshCount / EntityCount + 1));
+				entities.emplace_back(entity);
+			}
+			scene.UpdateWorldTransforms();
+
+			RenderProxyBuffer buffer;
+			aRunner.Run("RenderProxies/Extract/100K/Grouped", [&]()
+				{
+					scene.ExtractRenderProxies(buffer.GetWriteList());
+					buffer.Swap();
+					Bench::DoNotOptimize(buffer.GetReadList().Proxies.data());
+				}, EntityCount);
+
+			// Nothing moved, the lists are already up to date. Per frame, per entity it rounds to nothing.
+			aRunner.Run("RenderProxies/Sync/100K/Static", [&]()
+				{
+					scene.SyncRenderProxies(buffer.GetWriteList());
+					buffer.Swap();
+					Bench::DoNotOptimize(buffer.GetReadList().Proxies.data());
+				});
+
+			std::vector<Entity> moved;
+			std::uniform_int_distribution<size_t> entityIndex(0, EntityCount - 1);
+			for (size_t i = 0; i < MovedCount; ++i)
+			{
+				moved.emplace_back(entities[entityIndex(engine)]);
+			}
+
+			// Includes updating the moved entities' world matrices, the same work the scene does every frame anyway
+			aRunner.Run("RenderProxies/Sync/100K/1PercentMoving", [&]()
+				{
+					for (Entity entity : moved)
+					{
+						entity.GetComponent<TransformComponent>().LocalTransform.Translate({ 0.0f, 0.01f, 0.0f });
+						scene.MarkTransformDirty(entity);
+					}
+					scene.UpdateWorldTransforms();
+					scene.SyncRenderProxies(buffer.GetWriteList());
+					buffer.Swap();
+					Bench::DoNotOptimize(buffer.GetReadList().Proxies.data());
+				}, EntityCount);
+		}
+
+		Epoch::Assets::AssetManager::SetActiveAssetManager(nullptr);
+	}
+}
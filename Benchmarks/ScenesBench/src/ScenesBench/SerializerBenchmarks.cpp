@@ -0,0 +1,62 @@
+#include "Benchmarks.h"
+#include <filesystem>
+#include <memory>
+#include <EpochScenes/SceneSerializer.h>
+
+namespace ScenesBench
+{
+	namespace
+	{
+		using namespace Epoch::Scenes;
+
+		constexpr size_t RootCount = 1024;
+		constexpr size_t ChildrenPerRoot = 63;
+		constexpr size_t EntityCount = RootCount * (ChildrenPerRoot + 1);
+	}
+
+	void RunSerializerBenchmarks(Bench::Runner& aRunner)
+	{
+		auto scene = std::make_shared<Scene>();
+		for (size_t i = 0; i < RootCount; ++i)
+		{
+			Entity root = scene->CreateEntity("Root");
+			Entity parent = root;
+			for (size_t j = 0; j < ChildrenPerRoot; ++j)
+			{
+				Entity child = scene->CreateChildEntity(parent, "Child");
+				child.AddComponent<MeshRendererComponent>(Epoch::AssetHandle(i * ChildrenPerRoot + j + 1));
+				parent = (j % 8 == 7) ? root : child;
+			}
+		}
+
+		const std::filesystem::path filepath = std::filesystem::temp_directory_path() / "ScenesBench.escn";
+		const std::filesystem::path textFilepath = std::filesystem::temp_directory_path() / "ScenesBench.yaml";
+		SceneSerializer serializer(scene);
+
+		aRunner.Run("SceneSerializer/SerializeBinary/64K", [&]()
+			{
+				Bench::DoNotOptimize(serializer.SerializeBinary(filepath));
+			}, EntityCount);
+
+		// Includes creating and tearing down the scene it loads into
+		aRunner.Run("SceneSerializer/DeserializeBinary/64K", [&]()
+			{
+				auto loaded = std::make_shared<Scene>();
+				Bench::DoNotOptimize(SceneSerializer(loaded).DeserializeBinary(filepath));
+			}, EntityCount);
+
+		aRunner.Run("SceneSerializer/SerializeText/64K", [&]()
+			{
+				serializer.SerializeText(textFilepath);
+			}, EntityCount);
+
+		aRunner.Run("SceneSerializer/DeserializeText/64K", [&]()
+			{
+				auto loaded = std::make_shared<Scene>();
+				Bench::DoNotOptimize(SceneSerializer(loaded).DeserializeText(textFilepath));
+			}, EntityCount);
+
+		std::filesystem::remove(filepath);
+		std::filesystem::remove(textFilepath);
+	}
+}
@@ -0,0 +1,56 @@
+#include "Benchmarks.h"
+#include <EpochScenes/Scene.h>
+
+namespace ScenesBench
+{
+	namespace
+	{
+		using namespace Epoch::Scenes;
+
+		constexpr size_t RootCount = 1563;
+		constexpr size_t ChildrenPerRoot = 63;
+		constexpr size_t EntityCount = RootCount * (ChildrenPerRoot + 1);
+	}
+
+	void RunSnapshotBenchmarks(Bench::Runner& aRunner)
+	{
+		Scene scene;
+		std::vector<Entity> roots;
+		for (size_t i = 0; i < RootCount; ++i)
+		{
+			Entity root = scene.CreateEntity("Root");
+			Entity parent = root;
+			for (size_t j = 0; j < ChildrenPerRoot; ++j)
+			{
+				Entity child = scene.CreateChildEntity(parent, "Child");
+				child.AddComponent<MeshRendererComponent>(Epoch::AssetHandle(i * ChildrenPerRoot + j + 1));
+				parent = (j % 8 == 7) ? root : child;
+			}
+			roots.emplace_back(root);
+		}
+		scene.UpdateWorldTransforms();
+
+		SceneSnapshot snapshot = scene.Snapshot();
+
+		aRunner.Run("Scene/Snapshot/100K", [&]()
+			{
+				scene.Snapshot(snapshot);
+			}, EntityCount);
+
+		// Rolling back a simulation that only moved things, every pool keeps its layout
+		aRunner.Run("Scene/Restore/100K", [&]()
+			{
+				scene.Restore(snapshot);
+			}, EntityCount);
+
+		// Destroying a subtree first changes every pool, so all of them are rebuilt from the snapshot
+		size_t index = 0;
+		aRunner.Run("Scene/Restore/100K/AfterDestroy", [&]()
+			{
+				scene.DestroyEntity(roots[index]);
+				index = (index + 1) % RootCount;
+
+				scene.Restore(snapshot);
+			}, EntityCount);
+	}
+}
@@ -0,0 +1,141 @@
+#include "Benchmarks.h"
+#include <random>
+#include <EpochScenes/Scene.h>
+
+namespace ScenesBench
+{
+	namespace
+	{
+		using namespace Epoch::Scenes;
+
+		constexpr size_t EntityCount = 100000;
+		constexpr size_t EmptySystemCount = 64;
+
+		// Gameplay style components, only used by the benchmark systems
+		struct Position { CU::Vector3f Value; };
+		struct Velocity { CU::Vector3f Value; };
+		struct Target { CU::Vector3f Value; };
+		struct Health { float Value = 100.0f; };
+		struct Poison { float DamagePerSecond = 1.0f; };
+		struct Score { int Value = 0; };
+		struct Cooldown { float Remaining = 0.0f; };
+		struct Visibility { bool Visible = false; };
+
+		// Eight systems, three chains deep at most: Steering -> Movement -> Visibility, Damage -> Regeneration -> Scoring,
+		// with Cooldowns and a second Visibility reader free to run next to anything
+		void RegisterGameplaySystems(Scene& aScene)
+		{
+			aScene.RegisterSystem<Read<Target, Position>, Write<Velocity>>("Steering", [](SystemContext& aContext)
+				{
+					for (auto [entity, target, position, velocity] : aContext.View<const Target, const Position, Velocity>().each())
+					{
+						velocity.Value = velocity.Value * 0.9f + (target.Value - position.Value) * 0.1f;
+					}
+				});
+
+			aScene.RegisterSystem<Read<Velocity>, Write<Position>>("Movement", [](SystemContext& aContext)
+				{
+					const float deltaTime = aContext.GetDeltaTime();
+					for (auto [entity, velocity, position] : aContext.View<const Velocity, Position>().each())
+					{
+						position.Value += velocity.Value * deltaTime;
+					}
+				});
+
+			aScene.RegisterSystem<Read<Poison>, Write<Health>>("Damage", [](SystemContext& aContext)
+				{
+					const float deltaTime = aContext.GetDeltaTime();
+					for (auto [entity, poison, health] : aContext.View<const Poison, Health>().each())
+					{
+						health.Value -= poison.DamagePerSecond * deltaTime;
+					}
+				});
+
+			aScene.RegisterSystem<Read<>, Write<Health>>("Regeneration", [](SystemContext& aContext)
+				{
+					const float deltaTime = aContext.GetDeltaTime();
+					for (auto [entity, health] : aContext.View<Health>().each())
+					{
+						health.Value = CU::Math::Min(health.Value + deltaTime, 100.0f);
+					}
+				});
+
+			aScene.RegisterSystem<Read<Health>, Write<Score>>("Scoring", [](SystemContext& aContext)
+				{
+					for (auto [entity, health, score] : aContext.View<const Health, Score>().each())
+					{
+						score.Value += health.Value > 50.0f ? 1 : 0;
+					}
+				});
+
+			aScene.RegisterSystem<Read<>, Write<Cooldown>>("Cooldowns", [](SystemContext& aContext)
+				{
+					const float deltaTime = aContext.GetDeltaTime();
+					for (auto [entity, cooldown] : aContext.View<Cooldown>().each())
+					{
+						cooldown.Remaining = cooldown.Remaining > deltaTime ? cooldown.Remaining - deltaTime : 2.0f;
+					}
+				});
+
+			aScene.RegisterSystem<Read<Position>, Write<Visibility>>("Visibility", [](SystemContext& aContext)
+				{
+					for (auto [entity, position, visibility] : aContext.View<const Position, Visibility>().each())
+					{
+						visibility.Visible = position.Value.LengthSqr() < 250000.0f;
+					}
+				});
+
+			aScene.RegisterSystem<Read<Visibility, Score>>("Statistics", [](SystemContext& aContext)
+				{
+					int visibleScore = 0;
+					for (auto [entity, visibility, score] : aContext.View<const Visibility, const Score>().each())
+					{
+						visibleScore += visibility.Visible ? score.Value : 0;
+					}
+					Bench::DoNotOptimize(visibleScore);
+				});
+		}
+	}
+
+	void RunSystemBenchmarks(Bench::Runner& aRunner)
+	{
+		std::mt19937 engine(1337);
+		std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+
+		Scene scene;
+		for (size_t i = 0; i < EntityCount; ++i)
+		{
+			Entity entity = scene.CreateEntity("Agent");
+			entity.AddComponent<Position>(CU::Vector3f(position(engine), 0.0f, position(engine)));
+			entity.AddComponent<Velocity>();
+			entity.AddComponent<Target>(CU::Vector3f(position(engine), 0.0f, position(engine)));
+			entity.AddComponent<Health>();
+			entity.AddComponent<Poison>();
+			entity.AddComponent<Score>();
+			entity.AddComponent<Cooldown>();
+			entity.AddComponent<Visibility>();
+		}
+		scene.UpdateWorldTransforms();
+
+		RegisterGameplaySystems(scene);
+
+		scene.SetSystemThreadCount(1);
+		aRunner.Run("Systems/8Systems/100K/SingleThread", [&]() { scene.Update(0.016f); }, EntityCount);
+
+		scene.SetSystemThreadCount(0);
+		aRunner.Run("Systems/8Systems/100K/Parallel", [&]() { scene.Update(0.016f); }, EntityCount);
+
+		// What scheduling costs per system when there's nothing to do, none of them conflict
+		Scene emptyScene;
+		for (size_t i = 0; i < EmptySystemCount; ++i)
+		{
+			emptyScene.RegisterSystem("Empty", [](SystemContext& aContext) { Bench::DoNotOptimize(aContext.GetDeltaTime()); });
+		}
+
+		emptyScene.SetSystemThreadCount(1);
+		aRunner.Run("Systems/Overhead/64Empty/SingleThread", [&]() { emptyScene.Update(0.016f); }, EmptySystemCount);
+
+		emptyScene.SetSystemThreadCount(0);
+		aRunner.Run("Systems/Overhead/64Empty/Parallel", [&]() { emptyScene.Update(0.016f); }, EmptySystemCount);
+	}
+}
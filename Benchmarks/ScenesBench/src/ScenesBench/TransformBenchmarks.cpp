@@ -0,0 +1,122 @@
+#include "Benchmarks.h"
+#include <random>
+#include <vector>
+#include <EpochScenes/Scene.h>
+
+namespace ScenesBench
+{
+	namespace
+	{
+		using namespace Epoch::Scenes;
+
+		// Same shape as what Scene::InstantiateChild gives for the sandbox models (SM_Chest_Separated, raccoon):
+		// a root node with a few mesh nodes below it.
+		constexpr size_t NodesPerModel = 4;
+
+		// Wide: lots of models placed side by side under one level root
+		constexpr size_t WideModelCount = 4096;
+		// Deep: models attached to models (props on props), chains of ChainLength instances
+		constexpr size_t DeepChainCount = 16;
+		constexpr size_t DeepChainLength = 64;
+
+		CU::CompactTransform RandomTransform(std::mt19937& aEngine)
+		{
+			std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+			std::uniform_real_distribution<float> angle(-CU::Math::Pi, CU::Math::Pi);
+			std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+			return CU::CompactTransform(
+				CU::Vector3f(position(aEngine), position(aEngine), position(aEngine)),
+				CU::Vector3f(angle(aEngine), angle(aEngine), angle(aEngine)),
+				CU::Vector3f(scale(aEngine), scale(aEngine), scale(aEngine)));
+		}
+
+		Entity InstantiateModel(Scene& aScene, Entity aParent, std::mt19937& aEngine)
+		{
+			Entity root = aScene.CreateChildEntity(aParent, "Model");
+			root.GetComponent<TransformComponent>().LocalTransform = RandomTransform(aEngine);
+
+			for (size_t i = 1; i < NodesPerModel; ++i)
+			{
+				Entity node = aScene.CreateChildEntity(root, "Mesh");
+				node.GetComponent<TransformComponent>().LocalTransform = RandomTransform(aEngine);
+			}
+
+			return root;
+		}
+
+		void RunBenchmarks(Bench::Runner& aRunner, std::string_view aName, Scene& aScene, Entity aLevelRoot, const std::vector<Entity>& aModelRoots, size_t aEntityCount)
+		{
+			aScene.UpdateWorldTransforms();
+
+			aRunner.Run(std::string(aName) + "/AllDirty", [&]()
+				{
+					aScene.MarkTransformDirty(aLevelRoot);
+					aScene.UpdateWorldTransforms();
+				}, aEntityCount);
+
+			// Every model root is queued, the system has to find the one at the top itself
+			aRunner.Run(std::string(aName) + "/AllModelsMarked", [&]()
+				{
+					for (Entity root : aModelRoots)
+					{
+						aScene.MarkTransformDirty(root);
+					}
+					aScene.UpdateWorldTransforms();
+				}, aEntityCount);
+
+			// One model in a hundred moves, the rest of the tree isn't touched
+			aRunner.Run(std::string(aName) + "/OnePercentMarked", [&]()
+				{
+					for (size_t i = 0; i < aModelRoots.size(); i += 100)
+					{
+						aScene.MarkTransformDirty(aModelRoots[i]);
+					}
+					aScene.UpdateWorldTransforms();
+				});
+
+			aRunner.Run(std::string(aName) + "/Clean", [&]()
+				{
+					aScene.UpdateWorldTransforms();
+				});
+		}
+	}
+
+	void RunTransformBenchmarks(Bench::Runner& aRunner)
+	{
+		std::mt19937 engine(1337);
+
+		{
+			Scene scene;
+			Entity levelRoot = scene.CreateEntity("Level");
+
+			std::vector<Entity> modelRoots;
+			modelRoots.reserve(WideModelCount);
+			for (size_t i = 0; i < WideModelCount; ++i)
+			{
+				modelRoots.emplace_back(InstantiateModel(scene, levelRoot, engine));
+			}
+
+			RunBenchmarks(aRunner, "TransformSystem/Wide", scene, levelRoot, modelRoots, 1 + WideModelCount * NodesPerModel);
+		}
+
+		{
+			Scene scene;
+			Entity levelRoot = scene.CreateEntity("Level");
+
+			std::vector<Entity> modelRoots;
+			modelRoots.reserve(DeepChainCount * DeepChainLength);
+			for (size_t chain = 0; chain < DeepChainCount; ++chain)
+			{
+				Entity parent = levelRoot;
+				for (size_t i = 0; i < DeepChainLength; ++i)
+				{
+					parent = InstantiateModel(scene, parent, engine);
+					modelRoots.emplace_back(parent);
+				}
+			}
+
+			RunBenchmarks(aRunner, "TransformSystem/Deep", scene, levelRoot, modelRoots, 1 + DeepChainCount * DeepChainLength * NodesPerModel);
+		}
+	}
+}
@@ -0,0 +1,510 @@
+#include "ColorConversion.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include "Math/SIMD/SIMD.h"
+
+namespace CU
+{
+	namespace
+	{
+		constexpr int SRGBTableSize = 4096;
+		constexpr float MaxR11G11Value = 65024.0f;
+		constexpr float MaxB10Value = 64512.0f;
+		constexpr float MaxHalfValue = 65504.0f;
+
+		struct SRGBTables
+		{
+			// Encoded values are pre-scaled to [0.5, 255.5], so truncating the interpolated value rounds it.
+			float encode[SRGBTableSize + 1];
+			float decode[256];
+		};
+
+		const SRGBTables& GetSRGBTables()
+		{
+			static const SRGBTables tables = []()
+				{
+					SRGBTables result;
+					for (int i = 0; i <= SRGBTableSize; ++i)
+					{
+						result.encode[i] = LinearToSRGB((float)i / (float)SRGBTableSize) * 255.0f + 0.5f;
+					}
+					for (int i = 0; i < 256; ++i)
+					{
+						result.decode[i] = SRGBToLinear((float)i / 255.0f);
+					}
+					return result;
+				}();
+			return tables;
+		}
+
+		// Clamps to [0, 1] and maps NaN to 0, the same as max/min with the value as the first SSE operand.
+		float Saturate(float aValue)
+		{
+			aValue = aValue > 0.0f ? aValue : 0.0f;
+			return aValue < 1.0f ? aValue : 1.0f;
+		}
+
+		// Clamps to the finite half range and keeps NaN, the same as max/min with the value as the second SSE operand.
+		float ClampHalf(float aValue)
+		{
+			aValue = aValue < -MaxHalfValue ? -MaxHalfValue : aValue;
+			return aValue > MaxHalfValue ? MaxHalfValue : aValue;
+		}
+
+		float ClampPackedFloat(float aValue, float aMax)
+		{
+			aValue = aValue > 0.0f ? aValue : 0.0f;
+			return aValue < aMax ? aValue : aMax;
+		}
+
+		uint8_t ToUNorm8(float aValue)
+		{
+			return static_cast<uint8_t>(static_cast<int>(Saturate(aValue) * 255.0f + 0.5f));
+		}
+
+		uint8_t ToSRGB8(float aValue, const float* aTable)
+		{
+			const float position = Saturate(aValue) * (float)SRGBTableSize;
+			const int index = std::min(static_cast<int>(position), SRGBTableSize - 1);
+			const float fraction = position - static_cast<float>(index);
+			return static_cast<uint8_t>(static_cast<int>(aTable[index] + (aTable[index + 1] - aTable[index]) * fraction));
+		}
+
+		// Unsigned floats with a 5-bit exponent (bias 15) and MantissaBits of mantissa, the layout shared by halves and the packed 11/10 bit floats.
+		// aBits must be a non-negative float that doesn't overflow the format. Rounds to nearest even,
+		// denormals are rounded by the FPU by adding a float whose last mantissa bit is the smallest denormal.
+		template<int MantissaBits>
+		uint32_t EncodeSmallFloat(uint32_t aBits)
+		{
+			constexpr int shift = 23 - MantissaBits;
+			constexpr uint32_t denormalMagic = ((127 - 15) + shift + 1) << 23;
+
+			if (aBits < (113u << 23))
+			{
+				return std::bit_cast<uint32_t>(std::bit_cast<float>(aBits) + std::bit_cast<float>(denormalMagic)) - denormalMagic;
+			}
+
+			const uint32_t mantissaOdd = (aBits >> shift) & 1;
+			return (aBits - (112u << 23) + (1u << (shift - 1)) - 1 + mantissaOdd) >> shift;
+		}
+
+		template<int MantissaBits>
+		float DecodeSmallFloat(uint32_t aBits)
+		{
+			constexpr int shift = 23 - MantissaBits;
+			constexpr uint32_t exponentMask = 0x1Fu << 23;
+
+			uint32_t bits = aBits << shift;
+			const uint32_t exponent = bits & exponentMask;
+			bits += 112u << 23;
+
+			if (exponent == exponentMask)
+			{
+				bits += 112u << 23;
+			}
+			else if (exponent == 0)
+			{
+				return std::bit_cast<float>(bits + (1u << 23)) - std::bit_cast<float>(113u << 23);
+			}
+
+			return std::bit_cast<float>(bits);
+		}
+
+		uint32_t PackR11G11B10F(const float* aPixel)
+		{
+			const uint32_t r = EncodeSmallFloat<6>(std::bit_cast<uint32_t>(ClampPackedFloat(aPixel[0], MaxR11G11Value)));
+			const uint32_t g = EncodeSmallFloat<6>(std::bit_cast<uint32_t>(ClampPackedFloat(aPixel[1], MaxR11G11Value)));
+			const uint32_t b = EncodeSmallFloat<5>(std::bit_cast<uint32_t>(ClampPackedFloat(aPixel[2], MaxB10Value)));
+			return r | (g << 11) | (b << 22);
+		}
+
+#if CU_SIMD_SSE
+		CU_FORCEINLINE __m128i Select(__m128i aMask, __m128i aTrue, __m128i aFalse)
+		{
+			return _mm_or_si128(_mm_and_si128(aMask, aTrue), _mm_andnot_si128(aMask, aFalse));
+		}
+
+		CU_FORCEINLINE __m128 Select(__m128i aMask, __m128 aTrue, __m128 aFalse)
+		{
+			const __m128 mask = _mm_castsi128_ps(aMask);
+			return _mm_or_ps(_mm_and_ps(mask, aTrue), _mm_andnot_ps(mask, aFalse));
+		}
+
+		CU_FORCEINLINE __m128i ToUNorm8(__m128 aValue)
+		{
+			const __m128 value = _mm_min_ps(_mm_max_ps(aValue, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+			return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+		}
+
+		CU_FORCEINLINE void StoreBytes(uint8_t* outDestination, __m128i aPixel0, __m128i aPixel1, __m128i aPixel2, __m128i aPixel3)
+		{
+			const __m128i low = _mm_packs_epi32(aPixel0, aPixel1);
+			const __m128i high = _mm_packs_epi32(aPixel2, aPixel3);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(outDestination), _mm_packus_epi16(low, high));
+		}
+
+		template<int MantissaBits>
+		CU_FORCEINLINE __m128i EncodeSmallFloat(__m128 aValue)
+		{
+			constexpr int shift = 23 - MantissaBits;
+			const __m128i bits = _mm_castps_si128(aValue);
+
+			const __m128 denormalMagic = _mm_castsi128_ps(_mm_set1_epi32(((127 - 15) + shift + 1) << 23));
+			const __m128i denormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(aValue, denormalMagic)), _mm_castps_si128(denormalMagic));
+
+			const __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(bits, shift), _mm_set1_epi32(1));
+			__m128i normal = _mm_add_epi32(bits, _mm_set1_epi32((1 << (shift - 1)) - 1 - (112 << 23)));
+			normal = _mm_srli_epi32(_mm_add_epi32(normal, mantissaOdd), shift);
+
+			return Select(_mm_cmplt_epi32(bits, _mm_set1_epi32(113 << 23)), denormal, normal);
+		}
+
+		template<int MantissaBits>
+		CU_FORCEINLINE __m128 DecodeSmallFloat(__m128i aBits)
+		{
+			constexpr int shift = 23 - MantissaBits;
+			const __m128i exponentMask = _mm_set1_epi32(0x1F << 23);
+			const __m128i exponentBias = _mm_set1_epi32(112 << 23);
+
+			__m128i bits = _mm_slli_epi32(aBits, shift);
+			const __m128i exponent = _mm_and_si128(bits, exponentMask);
+			bits = _mm_add_epi32(bits, exponentBias);
+			bits = _mm_add_epi32(bits, _mm_and_si128(_mm_cmpeq_epi32(exponent, exponentMask), exponentBias));
+
+			const __m128 denormal = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(1 << 23))), _mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+			return Select(_mm_cmpeq_epi32(exponent, _mm_setzero_si128()), denormal, _mm_castsi128_ps(bits));
+		}
+
+#if !CU_SIMD_F16C
+		// Same as FloatToHalf, four lanes with the halves in the low 16 bits.
+		CU_FORCEINLINE __m128i FloatToHalf(__m128 aValue)
+		{
+			const __m128i bits = _mm_castps_si128(aValue);
+			const __m128i sign = _mm_and_si128(bits, _mm_set1_epi32(0x80000000));
+			const __m128i absolute = _mm_xor_si128(bits, sign);
+
+			const __m128i encoded = EncodeSmallFloat<10>(_mm_castsi128_ps(absolute));
+			const __m128i special = Select(_mm_cmpgt_epi32(absolute, _mm_set1_epi32(0x7F800000)), _mm_set1_epi32(0x7E00), _mm_set1_epi32(0x7C00));
+			const __m128i result = Select(_mm_cmpgt_epi32(absolute, _mm_set1_epi32((143 << 23) - 1)), special, encoded);
+
+			// Sign extended so the signed saturating pack keeps all 16 bits
+			return _mm_srai_epi32(_mm_slli_epi32(_mm_or_si128(result, _mm_srli_epi32(sign, 16)), 16), 16);
+		}
+
+		CU_FORCEINLINE __m128 HalfToFloat(__m128i aHalves)
+		{
+			const __m128i sign = _mm_slli_epi32(_mm_and_si128(aHalves, _mm_set1_epi32(0x8000)), 16);
+			const __m128 value = DecodeSmallFloat<10>(_mm_and_si128(aHalves, _mm_set1_epi32(0x7FFF)));
+			return _mm_or_ps(value, _mm_castsi128_ps(sign));
+		}
+#endif
+#endif
+
+#if CU_SIMD_AVX2
+		// Two pixels, RGB through the sRGB table and alpha as UNORM.
+		CU_FORCEINLINE __m256i ToSRGB8(__m256 aValue, const float* aTable)
+		{
+			const __m256 value = _mm256_min_ps(_mm256_max_ps(aValue, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+
+			const __m256 position = _mm256_mul_ps(value, _mm256_set1_ps((float)SRGBTableSize));
+			const __m256i index = _mm256_min_epi32(_mm256_cvttps_epi32(position), _mm256_set1_epi32(SRGBTableSize - 1));
+			const __m256 fraction = _mm256_sub_ps(position, _mm256_cvtepi32_ps(index));
+
+			const __m256 from = _mm256_i32gather_ps(aTable, index, 4);
+			const __m256 to = _mm256_i32gather_ps(aTable + 1, index, 4);
+			const __m256 encoded = _mm256_add_ps(from, _mm256_mul_ps(_mm256_sub_ps(to, from), fraction));
+			const __m256 alpha = _mm256_add_ps(_mm256_mul_ps(value, _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f));
+
+			return _mm256_cvttps_epi32(_mm256_blend_ps(encoded, alpha, 0x88));
+		}
+#endif
+	}
+
+	size_t ConvertRGBA32FToRGBA8(std::span<const float> aSource, std::span<uint8_t> outDestination)
+	{
+		const size_t count = std::min(aSource.size() / 4, outDestination.size() / 4);
+		const float* source = aSource.data();
+		uint8_t* destination = outDestination.data();
+		size_t i = 0;
+
+#if CU_SIMD_SSE
+		for (; i + 4 <= count; i += 4)
+		{
+			const float* pixels = source + i * 4;
+			StoreBytes(destination + i * 4,
+				ToUNorm8(_mm_loadu_ps(pixels + 0)), ToUNorm8(_mm_loadu_ps(pixels + 4)),
+				ToUNorm8(_mm_loadu_ps(pixels + 8)), ToUNorm8(_mm_loadu_ps(pixels + 12)));
+		}
+#endif
+
+		for (size_t channel = i * 4; channel < count * 4; ++channel)
+		{
+			destination[channel] = ToUNorm8(source[channel]);
+		}
+
+		return count;
+	}
+
+	size_t ConvertRGBA8ToRGBA32F(std::span<const uint8_t> aSource, std::span<float> outDestination)
+	{
+		const size_t count = std::min(aSource.size() / 4, outDestination.size() / 4);
+		const uint8_t* source = aSource.data();
+		float* destination = outDestination.data();
+		const float scale = 1.0f / 255.0f;
+		size_t i = 0;
+
+#if CU_SIMD_SSE
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+			const __m128i low = _mm_unpacklo_epi8(bytes, _mm_setzero_si128());
+			const __m128i high = _mm_unpackhi_epi8(bytes, _mm_setzero_si128());
+
+			float* pixels = destination + i * 4;
+			_mm_storeu_ps(pixels + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, _mm_setzero_si128())), _mm_set1_ps(scale)));
+			_mm_storeu_ps(pixels + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, _mm_setzero_si128())), _mm_set1_ps(scale)));
+			_mm_storeu_ps(pixels + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, _mm_setzero_si128())), _mm_set1_ps(scale)));
+			_mm_storeu_ps(pixels + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, _mm_setzero_si128())), _mm_set1_ps(scale)));
+		}
+#endif
+
+		for (size_t channel = i * 4; channel < count * 4; ++channel)
+		{
+			destination[channel] = static_cast<float>(source[channel]) * scale;
+		}
+
+		return count;
+	}
+
+	size_t ConvertRGBA32FToRGBA8SRGB(std::span<const float> aSource, std::span<uint8_t> outDestination)
+	{
+		const size_t count = std::min(aSource.size() / 4, outDestination.size() / 4);
+		const float* source = aSource.data();
+		uint8_t* destination = outDestination.data();
+		const float* table = GetSRGBTables().encode;
+		size_t i = 0;
+
+#if CU_SIMD_AVX2
+		for (; i + 4 <= count; i += 4)
+		{
+			const float* pixels = source + i * 4;
+			const __m256i first = ToSRGB8(_mm256_loadu_ps(pixels + 0), table);
+			const __m256i second = ToSRGB8(_mm256_loadu_ps(pixels + 8), table);
+			StoreBytes(destination + i * 4,
+				_mm256_castsi256_si128(first), _mm256_extracti128_si256(first, 1),
+				_mm256_castsi256_si128(second), _mm256_extracti128_si256(second, 1));
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			const float* pixel = source + i * 4;
+			uint8_t* output = destination + i * 4;
+			output[0] = ToSRGB8(pixel[0], table);
+			output[1] = ToSRGB8(pixel[1], table);
+			output[2] = ToSRGB8(pixel[2], table);
+			output[3] = ToUNorm8(pixel[3]);
+		}
+
+		return count;
+	}
+
+	size_t ConvertRGBA8SRGBToRGBA32F(std::span<const uint8_t> aSource, std::span<float> outDestination)
+	{
+		const size_t count = std::min(aSource.size() / 4, outDestination.size() / 4);
+		const uint8_t* source = aSource.data();
+		float* destination = outDestination.data();
+		const float* table = GetSRGBTables().decode;
+
+		// A table lookup per channel is already cheaper than any gather
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint8_t* pixel = source + i * 4;
+			float* output = destination + i * 4;
+			output[0] = table[pixel[0]];
+			output[1] = table[pixel[1]];
+			output[2] = table[pixel[2]];
+			output[3] = static_cast<float>(pixel[3]) * (1.0f / 255.0f);
+		}
+
+		return count;
+	}
+
+	size_t ConvertRGBA32FToRGBA16F(std::span<const float> aSource, std::span<uint16_t> outDestination)
+	{
+		const size_t count = std::min(aSource.size() / 4, outDestination.size() / 4);
+		const float* source = aSource.data();
+		uint16_t* destination = outDestination.data();
+		size_t i = 0;
+
+#if CU_SIMD_F16C
+		for (; i + 2 <= count; i += 2)
+		{
+			const __m256 value = _mm256_min_ps(_mm256_set1_ps(MaxHalfValue), _mm256_max_ps(_mm256_set1_ps(-MaxHalfValue), _mm256_loadu_ps(source + i * 4)));
+			const __m128i halves = _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), halves);
+		}
+#elif CU_SIMD_SSE
+		for (; i + 2 <= count; i += 2)
+		{
+			const __m128 min = _mm_set1_ps(-MaxHalfValue);
+			const __m128 max = _mm_set1_ps(MaxHalfValue);
+			const __m128i first = FloatToHalf(_mm_min_ps(max, _mm_max_ps(min, _mm_loadu_ps(source + i * 4))));
+			const __m128i second = FloatToHalf(_mm_min_ps(max, _mm_max_ps(min, _mm_loadu_ps(source + i * 4 + 4))));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), _mm_packs_epi32(first, second));
+		}
+#endif
+
+		for (size_t channel = i * 4; channel < count * 4; ++channel)
+		{
+			destination[channel] = FloatToHalf(ClampHalf(source[channel]));
+		}
+
+		return count;
+	}
+
+	size_t ConvertRGBA16FToRGBA32F(std::span<const uint16_t> aSource, std::span<float> outDestination)
+	{
+		const size_t count = std::min(aSource.size() / 4, outDestination.size() / 4);
+		const uint16_t* source = aSource.data();
+		float* destination = outDestination.data();
+		size_t i = 0;
+
+#if CU_SIMD_F16C
+		for (; i + 2 <= count; i += 2)
+		{
+			const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+			_mm256_storeu_ps(destination + i * 4, _mm256_cvtph_ps(halves));
+		}
+#elif CU_SIMD_SSE
+		for (; i + 2 <= count; i += 2)
+		{
+			const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+			_mm_storeu_ps(destination + i * 4, HalfToFloat(_mm_unpacklo_epi16(halves, _mm_setzero_si128())));
+			_mm_storeu_ps(destination + i * 4 + 4, HalfToFloat(_mm_unpackhi_epi16(halves, _mm_setzero_si128())));
+		}
+#endif
+
+		for (size_t channel = i * 4; channel < count * 4; ++channel)
+		{
+			destination[channel] = HalfToFloat(source[channel]);
+		}
+
+		return count;
+	}
+
+	size_t ConvertRGBA32FToR11G11B10F(std::span<const float> aSource, std::span<uint32_t> outDestination)
+	{
+		const size_t count = std::min(aSource.size() / 4, outDestination.size());
+		const float* source = aSource.data();
+		uint32_t* destination = outDestination.data();
+		size_t i = 0;
+
+#if CU_SIMD_SSE
+		for (; i + 4 <= count; i += 4)
+		{
+			const float* pixels = source + i * 4;
+			__m128 r = _mm_loadu_ps(pixels + 0);
+			__m128 g = _mm_loadu_ps(pixels + 4);
+			__m128 b = _mm_loadu_ps(pixels + 8);
+			__m128 a = _mm_loadu_ps(pixels + 12);
+			_MM_TRANSPOSE4_PS(r, g, b, a);
+
+			r = _mm_min_ps(_mm_max_ps(r, _mm_setzero_ps()), _mm_set1_ps(MaxR11G11Value));
+			g = _mm_min_ps(_mm_max_ps(g, _mm_setzero_ps()), _mm_set1_ps(MaxR11G11Value));
+			b = _mm_min_ps(_mm_max_ps(b, _mm_setzero_ps()), _mm_set1_ps(MaxB10Value));
+
+			__m128i packed = EncodeSmallFloat<6>(r);
+			packed = _mm_or_si128(packed, _mm_slli_epi32(EncodeSmallFloat<6>(g), 11));
+			packed = _mm_or_si128(packed, _mm_slli_epi32(EncodeSmallFloat<5>(b), 22));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), packed);
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			destination[i] = PackR11G11B10F(source + i * 4);
+		}
+
+		return count;
+	}
+
+	size_t ConvertR11G11B10FToRGBA32F(std::span<const uint32_t> aSource, std::span<float> outDestination)
+	{
+		const size_t count = std::min(aSource.size(), outDestination.size() / 4);
+		const uint32_t* source = aSource.data();
+		float* destination = outDestination.data();
+		size_t i = 0;
+
+#if CU_SIMD_SSE
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+			const __m128i mask = _mm_set1_epi32(0x7FF);
+
+			__m128 r = DecodeSmallFloat<6>(_mm_and_si128(packed, mask));
+			__m128 g = DecodeSmallFloat<6>(_mm_and_si128(_mm_srli_epi32(packed, 11), mask));
+			__m128 b = DecodeSmallFloat<5>(_mm_srli_epi32(packed, 22));
+			__m128 a = _mm_set1_ps(1.0f);
+			_MM_TRANSPOSE4_PS(r, g, b, a);
+
+			float* pixels = destination + i * 4;
+			_mm_storeu_ps(pixels + 0, r);
+			_mm_storeu_ps(pixels + 4, g);
+			_mm_storeu_ps(pixels + 8, b);
+			_mm_storeu_ps(pixels + 12, a);
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			float* pixel = destination + i * 4;
+			pixel[0] = DecodeSmallFloat<6>(source[i] & 0x7FF);
+			pixel[1] = DecodeSmallFloat<6>((source[i] >> 11) & 0x7FF);
+			pixel[2] = DecodeSmallFloat<5>(source[i] >> 22);
+			pixel[3] = 1.0f;
+		}
+
+		return count;
+	}
+
+	uint16_t FloatToHalf(float aValue)
+	{
+		uint32_t bits = std::bit_cast<uint32_t>(aValue);
+		const uint32_t sign = (bits >> 16) & 0x8000;
+		bits &= 0x7FFFFFFF;
+
+		// 65536 and up can't round to a finite half, NaN stays a (quiet) NaN
+		if (bits >= (143u << 23))
+		{
+			return static_cast<uint16_t>(sign | (bits > 0x7F800000 ? 0x7E00 : 0x7C00));
+		}
+
+		return static_cast<uint16_t>(sign | EncodeSmallFloat<10>(bits));
+	}
+
+	float HalfToFloat(uint16_t aValue)
+	{
+		const uint32_t sign = static_cast<uint32_t>(aValue & 0x8000) << 16;
+		return std::bit_cast<float>(std::bit_cast<uint32_t>(DecodeSmallFloat<10>(aValue & 0x7FFF)) | sign);
+	}
+
+	float LinearToSRGB(float aValue)
+	{
+		if (aValue <= 0.0031308f)
+		{
+			return aValue * 12.92f;
+		}
+		return 1.055f * std::pow(aValue, 1.0f / 2.4f) - 0.055f;
+	}
+
+	float SRGBToLinear(float aValue)
+	{
+		if (aValue <= 0.04045f)
+		{
+			return aValue / 12.92f;
+		}
+		return std::pow((aValue + 0.055f) / 1.055f, 2.4f);
+	}
+}
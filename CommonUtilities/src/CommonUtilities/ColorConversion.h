@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <span>
+
+namespace CU
+{
+	// Bulk pixel format conversions for texture import and other CPU image work.
+	// Float pixels are four floats (RGBA), the other formats are one element per pixel (RGBA8 is four bytes).
+	// Every function converts min(source pixels, destination pixels) pixels and returns that count.
+	// The SSE/AVX2/F16C paths give the same bits as the scalar paths, except for NaN payloads in half floats.
+
+	// UNORM: clamped to [0, 1] (NaN becomes 0) and rounded to the nearest of the 256 steps.
+	size_t ConvertRGBA32FToRGBA8(std::span<const float> aSource, std::span<uint8_t> outDestination);
+	size_t ConvertRGBA8ToRGBA32F(std::span<const uint8_t> aSource, std::span<float> outDestination);
+
+	// sRGB: RGB is encoded with the sRGB transfer function, alpha stays linear.
+	// Encoding interpolates a 4096 entry table, it's off from the exact curve by less than 0.005 of a step.
+	size_t ConvertRGBA32FToRGBA8SRGB(std::span<const float> aSource, std::span<uint8_t> outDestination);
+	size_t ConvertRGBA8SRGBToRGBA32F(std::span<const uint8_t> aSource, std::span<float> outDestination);
+
+	// IEEE half floats, round to nearest even. Values are clamped to [-65504, 65504] first, so large HDR values and
+	// infinity become the largest finite half instead of infinity. NaN stays NaN.
+	size_t ConvertRGBA32FToRGBA16F(std::span<const float> aSource, std::span<uint16_t> outDestination);
+	size_t ConvertRGBA16FToRGBA32F(std::span<const uint16_t> aSource, std::span<float> outDestination);
+
+	// 11/11/10 bit unsigned floats (R in the low bits), alpha is dropped and read back as 1.
+	// Values are clamped to [0, largest finite value] first, so negatives, NaN and infinity don't survive the trip.
+	size_t ConvertRGBA32FToR11G11B10F(std::span<const float> aSource, std::span<uint32_t> outDestination);
+	size_t ConvertR11G11B10FToRGBA32F(std::span<const uint32_t> aSource, std::span<float> outDestination);
+
+	// Single values aren't clamped, overflow becomes infinity like the GPU conversion.
+	uint16_t FloatToHalf(float aValue);
+	float HalfToFloat(uint16_t aValue);
+
+	// Exact transfer functions, for single values and building tables.
+	float LinearToSRGB(float aValue);
+	float SRGBToLinear(float aValue);
+}
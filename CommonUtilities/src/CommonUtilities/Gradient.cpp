@@ -1,263 +1,249 @@
 #include "Gradient.h"
 #include <algorithm>
 #include "Math/CommonMath.hpp"
+#include "Math/SIMD/SIMD.h"
 
 namespace CU
 {
-	Gradient::Gradient(bool aAddDefaultKeys)
+	namespace
 	{
-		if (aAddDefaultKeys)
-		{
-			AddColorKey(0.0f);
-			AddColorKey(1.0f);
+		template<typename Key>
+		bool CompareKeyTime(const Key& aKey, float aTime) { return aKey.time < aTime; }
 
-			AddAlphaKey(0.0f);
-			AddAlphaKey(1.0f);
+		// aRightIndex is the first key at or after the sampled time, left is the key before it.
+		// Both are the same key outside the key range.
+		template<typename Key>
+		void GetLeftAndRightKey(const std::vector<Key>& aKeys, size_t aRightIndex, const Key*& outLeft, const Key*& outRight)
+		{
+			if (aRightIndex == 0)
+			{
+				outLeft = outRight = &aKeys.front();
+			}
+			else if (aRightIndex == aKeys.size())
+			{
+				outLeft = outRight = &aKeys.back();
+			}
+			else
+			{
+				outLeft = &aKeys[aRightIndex - 1];
+				outRight = &aKeys[aRightIndex];
+			}
 		}
-	}
 
-	Gradient::~Gradient()
-	{
-		colorKeys.clear();
-		alphaKeys.clear();
-	}
-
-	CU::Gradient Gradient::CreateCopy() const
-	{
-		CU::Gradient gradient(false);
-		CopyTo(gradient);
-		return gradient;
-	}
-
-	void Gradient::CopyTo(CU::Gradient& outGradient) const
-	{
-		if (outGradient.colorKeys.size() > 0)
+		template<typename Key>
+		size_t FindRightKey(const std::vector<Key>& aKeys, float aTime)
 		{
-			outGradient.colorKeys.clear();
+			return static_cast<size_t>(std::lower_bound(aKeys.begin(), aKeys.end(), aTime, CompareKeyTime<Key>) - aKeys.begin());
 		}
 
-		if (outGradient.alphaKeys.size() > 0)
+		// Moves aRightIndex forward to the first key at or after aTime, for walking increasing times.
+		template<typename Key>
+		void AdvanceRightKey(const std::vector<Key>& aKeys, float aTime, size_t& aRightIndex)
 		{
-			outGradient.alphaKeys.clear();
+			while (aRightIndex < aKeys.size() && aKeys[aRightIndex].time < aTime)
+			{
+				++aRightIndex;
+			}
 		}
 
-		for (const std::shared_ptr<Key>& key : colorKeys)
+		// Clamps to [0, 1] and maps NaN to 0, so the result is always a valid cache position.
+		float ClampTime(float aTime)
 		{
-			outGradient.AddColorKey(key->time, key->color);
+			aTime = aTime > 0.0f ? aTime : 0.0f;
+			return aTime < 1.0f ? aTime : 1.0f;
 		}
+	}
 
-		for (const std::shared_ptr<Key>& key : alphaKeys)
+	Gradient::Gradient(bool aAddDefaultKeys)
+	{
+		if (aAddDefaultKeys)
 		{
-			outGradient.AddAlphaKey(key->time, key->alpha);
+			myColorKeys = { { 0.0f, Color::White }, { 1.0f, Color::White } };
+			myAlphaKeys = { { 0.0f, 1.0f }, { 1.0f, 1.0f } };
 		}
+
+		RefreshCache();
 	}
 
-	void Gradient::AddColorKey(float aTime, const Color& aColor)
+	CU::Gradient Gradient::CreateCopy() const
 	{
-		colorKeys.push_back(std::make_shared<Key>(KeyType::Color, aTime, aColor));
-		RefreshCache();
+		return *this;
 	}
 
-	void Gradient::AddColorKey(std::shared_ptr<Key>& aColorKey)
+	void Gradient::CopyTo(CU::Gradient& outGradient) const
 	{
-		colorKeys.push_back(aColorKey);
+		outGradient = *this;
+	}
+
+	size_t Gradient::AddColorKey(float aTime, const Color& aColor)
+	{
+		// Inserted after keys with the same time, so keys added later win ties like before.
+		auto it = std::upper_bound(myColorKeys.begin(), myColorKeys.end(), aTime, [](float aTime, const ColorKey& aKey) { return aTime < aKey.time; });
+		it = myColorKeys.insert(it, { aTime, aColor });
 		RefreshCache();
+		return static_cast<size_t>(it - myColorKeys.begin());
 	}
 
-	void Gradient::RemoveColorKey(std::shared_ptr<Key> aColorKey)
+	void Gradient::RemoveColorKey(size_t aIndex)
 	{
-		colorKeys.remove(aColorKey);
+		if (aIndex >= myColorKeys.size())
+		{
+			return;
+		}
+
+		myColorKeys.erase(myColorKeys.begin() + aIndex);
 		RefreshCache();
 	}
 
-	void Gradient::AddAlphaKey(float aTime, float aAlpha)
+	size_t Gradient::AddAlphaKey(float aTime, float aAlpha)
 	{
-		alphaKeys.push_back(std::make_shared<Key>(KeyType::Alpha, aTime, aAlpha));
+		auto it = std::upper_bound(myAlphaKeys.begin(), myAlphaKeys.end(), aTime, [](float aTime, const AlphaKey& aKey) { return aTime < aKey.time; });
+		it = myAlphaKeys.insert(it, { aTime, aAlpha });
 		RefreshCache();
+		return static_cast<size_t>(it - myAlphaKeys.begin());
 	}
 
-	void Gradient::AddAlphaKey(std::shared_ptr<Key>& aAlphaKey)
+	void Gradient::RemoveAlphaKey(size_t aIndex)
 	{
-		alphaKeys.push_back(aAlphaKey);
+		if (aIndex >= myAlphaKeys.size())
+		{
+			return;
+		}
+
+		myAlphaKeys.erase(myAlphaKeys.begin() + aIndex);
 		RefreshCache();
 	}
 
-	void Gradient::RemoveAlphaKey(std::shared_ptr<Key> aAlphaKey)
+	void Gradient::SetKeys(std::span<const ColorKey> aColorKeys, std::span<const AlphaKey> aAlphaKeys)
 	{
-		alphaKeys.remove(aAlphaKey);
+		myColorKeys.assign(aColorKeys.begin(), aColorKeys.end());
+		myAlphaKeys.assign(aAlphaKeys.begin(), aAlphaKeys.end());
+
+		std::stable_sort(myColorKeys.begin(), myColorKeys.end(), [](const ColorKey& a, const ColorKey& b) { return a.time < b.time; });
+		std::stable_sort(myAlphaKeys.begin(), myAlphaKeys.end(), [](const AlphaKey& a, const AlphaKey& b) { return a.time < b.time; });
+
 		RefreshCache();
 	}
 
-	Color Gradient::GetColorAt(float aPosition)
+	Color Gradient::GetColorAt(float aPosition) const
 	{
-		aPosition = Math::Clamp01(aPosition);
-		int cachePos = (int)(aPosition * 255.0f);
+		const int cachePos = (int)(ClampTime(aPosition) * 255.0f);
 		return myCachedValues[cachePos];
 	}
 
-	void Gradient::RefreshCache()
+	Color Gradient::Evaluate(float aTime) const
 	{
-		colorKeys.sort([](const std::shared_ptr<Key>& a, const std::shared_ptr<Key>& b) { return a->time < b->time; });
-		alphaKeys.sort([](const std::shared_ptr<Key>& a, const std::shared_ptr<Key>& b) { return a->time < b->time; });
+		aTime = ClampTime(aTime);
 
-		const float divider = 1.0f / 255.0f;
-		for (int i = 0; i < 256; ++i)
-		{
-			myCachedValues[i] = ComputeColorAt((float)i * divider);
-		}
+		Color result = ComputeColor(aTime, FindRightKey(myColorKeys, aTime));
+		result.a = ComputeAlpha(aTime, FindRightKey(myAlphaKeys, aTime));
+		return result;
 	}
 
-	Color Gradient::ComputeColorAt(float aTime) const
+	void Gradient::Evaluate(std::span<const float> aTimes, std::span<Color> outColors) const
 	{
-		aTime = Math::Clamp01(aTime);
+		static_assert(sizeof(Color) == sizeof(float) * 4);
+		static_assert(CacheSize == 256);
 
-		Color returnColor;
+		const size_t count = std::min(aTimes.size(), outColors.size());
+		size_t i = 0;
 
-		if (colorKeys.size() == 0)
-		{
-			returnColor = Color::White;
-		}
-		else
-		{
-			ComputeColor(returnColor, aTime);
-		}
+#if CU_SIMD_SSE
+		const float* cache = &myCachedValues[0].r;
 
-		if (alphaKeys.size() == 0)
+		for (; i + 4 <= count; i += 4)
 		{
-			returnColor.a = 1.0f;
+			// Same clamp as ClampTime, max returns the second operand for NaN
+			__m128 time = _mm_loadu_ps(aTimes.data() + i);
+			time = _mm_min_ps(_mm_max_ps(time, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+
+			const __m128 position = _mm_mul_ps(time, _mm_set1_ps(255.0f));
+			const __m128i index = _mm_cvttps_epi32(position);
+			const __m128 fraction = _mm_sub_ps(position, _mm_cvtepi32_ps(index));
+			// Indices fit in 16 bits, so the SSE2 16-bit min works for these 32-bit lanes
+			const __m128i nextIndex = _mm_min_epi16(_mm_add_epi32(index, _mm_set1_epi32(1)), _mm_set1_epi32(255));
+
+			alignas(16) int indices[4];
+			alignas(16) int nextIndices[4];
+			alignas(16) float fractions[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(indices), index);
+			_mm_store_si128(reinterpret_cast<__m128i*>(nextIndices), nextIndex);
+			_mm_store_ps(fractions, fraction);
+
+			for (int lane = 0; lane < 4; ++lane)
+			{
+				const __m128 from = _mm_loadu_ps(cache + indices[lane] * 4);
+				const __m128 to = _mm_loadu_ps(cache + nextIndices[lane] * 4);
+				const __m128 color = _mm_add_ps(from, _mm_mul_ps(_mm_sub_ps(to, from), _mm_set1_ps(fractions[lane])));
+				_mm_storeu_ps(&outColors[i + lane].r, color);
+			}
 		}
-		else
+#endif
+
+		for (; i < count; ++i)
 		{
-			ComputeAlpha(returnColor.a, aTime);
+			const float position = ClampTime(aTimes[i]) * 255.0f;
+			const int index = static_cast<int>(position);
+			const int nextIndex = std::min(index + 1, 255);
+			outColors[i] = Color::Lerp(myCachedValues[index], myCachedValues[nextIndex], position - static_cast<float>(index));
 		}
-
-		return returnColor;
 	}
 
-	void Gradient::ComputeColor(Color& outColor, const float aTime) const
+	void Gradient::RefreshCache()
 	{
-		if (static_cast<int>(colorKeys.size()) == 1)
-		{
-			outColor = colorKeys.front()->color;
-			return;
-		}
+		// One pass over the sorted keys, the cache times only increase.
+		size_t colorIndex = 0;
+		size_t alphaIndex = 0;
 
-		std::shared_ptr<Key> left = nullptr;
-		std::shared_ptr<Key> right = nullptr;
-		FindLeftAndRightKey(left, right, aTime, colorKeys);
-
-		if (!left && !right)
+		const float divider = 1.0f / 255.0f;
+		for (int i = 0; i < static_cast<int>(CacheSize); ++i)
 		{
-			outColor = Color::White;
-			return;
-		}
+			const float time = (float)i * divider;
+			AdvanceRightKey(myColorKeys, time, colorIndex);
+			AdvanceRightKey(myAlphaKeys, time, alphaIndex);
 
-		if (left.get() == right.get())
-		{
-			outColor = left->color;
-			return;
+			myCachedValues[i] = ComputeColor(time, colorIndex);
+			myCachedValues[i].a = ComputeAlpha(time, alphaIndex);
 		}
-
-		float lerpValue = Math::Remap01(aTime, left->time, right->time);
-
-		outColor = Color::Lerp(left->color, right->color, lerpValue);
-
-		//{
-		//	CU::Color leftCol = left->color;
-		//	CU::Color rightCol = right->color;
-		//
-		//	leftCol.r = std::sqrtf(leftCol.r);
-		//	leftCol.g = std::sqrtf(leftCol.g);
-		//	leftCol.b = std::sqrtf(leftCol.b);
-		//
-		//	rightCol.r = std::sqrtf(rightCol.r);
-		//	rightCol.g = std::sqrtf(rightCol.g);
-		//	rightCol.b = std::sqrtf(rightCol.b);
-		//
-		//	CU::Color mix = Color::Lerp(leftCol, rightCol, lerpValue);
-		//	mix *= mix;
-		//	outColor = mix;
-		//}
-
-		//{
-		//	CU::Color leftCol = left->color;
-		//	CU::Color rightCol = right->color;
-		//
-		//	leftCol *= leftCol;
-		//	rightCol *= rightCol;
-		//
-		//	CU::Color mix = Color::Lerp(leftCol, rightCol, lerpValue);
-		//
-		//	mix.r = std::sqrtf(mix.r);
-		//	mix.g = std::sqrtf(mix.g);
-		//	mix.b = std::sqrtf(mix.b);
-		//	
-		//	mix.r = std::sqrtf(mix.r);
-		//	mix.g = std::sqrtf(mix.g);
-		//	mix.b = std::sqrtf(mix.b);
-		//
-		//	mix *= mix;
-		//
-		//	outColor = mix;
-		//}
 	}
-	
-	void Gradient::ComputeAlpha(float& outAlpha, const float aTime) const
+
+	Color Gradient::ComputeColor(float aTime, size_t aRightKey) const
 	{
-		if (static_cast<int>(alphaKeys.size()) == 1)
+		if (myColorKeys.empty())
 		{
-			outAlpha = alphaKeys.front()->alpha;
-			return;
+			return Color::White;
 		}
 
-		std::shared_ptr<Key> left = nullptr;
-		std::shared_ptr<Key> right = nullptr;
-		FindLeftAndRightKey(left, right, aTime, alphaKeys);
+		const ColorKey* left = nullptr;
+		const ColorKey* right = nullptr;
+		GetLeftAndRightKey(myColorKeys, aRightKey, left, right);
 
-		if (!left && !right)
+		if (left == right)
 		{
-			outAlpha = 1.0f;
-			return;
+			return left->color;
 		}
 
-		if (left.get() == right.get())
-		{
-			outAlpha = left->alpha;
-			return;
-		}
-
-		float lerpValue = Math::Remap01(aTime, left->time, right->time);
-		outAlpha = Math::Lerp(left->alpha, right->alpha, lerpValue);
+		const float lerpValue = Math::Remap01(aTime, left->time, right->time);
+		return Color::Lerp(left->color, right->color, lerpValue);
 	}
 
-	void Gradient::FindLeftAndRightKey(std::shared_ptr<Key>& outLeft, std::shared_ptr<Key>& outRight, float aTime, const std::list<std::shared_ptr<Key>>& aList) const
+	float Gradient::ComputeAlpha(float aTime, size_t aRightKey) const
 	{
-		for (const std::shared_ptr<Key>& key : aList)
+		if (myAlphaKeys.empty())
 		{
-			if (key->time < aTime)
-			{
-				if (!outLeft || outLeft->time < key->time)
-				{
-					outLeft = key;
-				}
-			}
-
-			if (key->time >= aTime)
-			{
-				if (!outRight || outRight->time > key->time)
-				{
-					outRight = key;
-				}
-			}
+			return 1.0f;
 		}
 
-		if (outRight && !outLeft)
-		{
-			outLeft = outRight;
-		}
-		else if (!outRight && outLeft)
+		const AlphaKey* left = nullptr;
+		const AlphaKey* right = nullptr;
+		GetLeftAndRightKey(myAlphaKeys, aRightKey, left, right);
+
+		if (left == right)
 		{
-			outRight = outLeft;
+			return left->alpha;
 		}
+
+		const float lerpValue = Math::Remap01(aTime, left->time, right->time);
+		return Math::Lerp(left->alpha, right->alpha, lerpValue);
 	}
 }
@@ -1,55 +1,67 @@
 #pragma once
-#include <memory>
-#include <list>
 #include <array>
+#include <span>
+#include <vector>
 #include "Color.h"
 
 namespace CU
 {
+	// Color and alpha keys are stored in separate arrays sorted by time.
+	// All const functions only read, so a gradient can be sampled from any number of threads as long as nobody edits it at the same time.
 	class Gradient
 	{
 	public:
-		enum class KeyType { Color, Alpha };
-		struct Key
+		struct ColorKey
 		{
-			KeyType type = KeyType::Color;
 			float time = 0.0f;
-			float alpha = 0.0f;
 			Color color;
+		};
 
-			Key(KeyType aType, float aTime, const Color& aColor) : type(aType), time(aTime), color(aColor) {}
-			Key(KeyType aType, float aTime, float aAlpha) : type(aType), time(aTime), alpha(aAlpha) {}
+		struct AlphaKey
+		{
+			float time = 0.0f;
+			float alpha = 1.0f;
 		};
 
-	public:
-		std::list<std::shared_ptr<Key>> colorKeys;
-		std::list<std::shared_ptr<Key>> alphaKeys;
-		std::array<Color, 256> myCachedValues;
-		
+		static constexpr size_t CacheSize = 256;
+
 	public:
 		Gradient(bool aAddDefaultKeys = true);
-		~Gradient();
+		~Gradient() = default;
 
 		CU::Gradient CreateCopy() const;
 		void CopyTo(CU::Gradient& outGradient) const;
 
-		void AddColorKey(float aTime, const Color& aColor = Color::White);
-		void AddColorKey(std::shared_ptr<Key>& aColorKey);
-		void RemoveColorKey(std::shared_ptr<Key> aColorKey);
+		// Adding a key returns its index in the sorted key array, indices of later keys shift by one.
+		size_t AddColorKey(float aTime, const Color& aColor = Color::White);
+		void RemoveColorKey(size_t aIndex);
+		size_t AddAlphaKey(float aTime, float aAlpha = 1.0f);
+		void RemoveAlphaKey(size_t aIndex);
 
-		void AddAlphaKey(float aTime, float aAlpha = 1.0f);
-		void AddAlphaKey(std::shared_ptr<Key>& aAlphaKey);
-		void RemoveAlphaKey(std::shared_ptr<Key> aAlphaKey);
+		// Replaces all keys at once with a single cache refresh, the keys don't need to be sorted.
+		void SetKeys(std::span<const ColorKey> aColorKeys, std::span<const AlphaKey> aAlphaKeys);
 
-		Color GetColorAt(float aPosition);
-		void RefreshCache();
+		std::span<const ColorKey> GetColorKeys() const { return myColorKeys; }
+		std::span<const AlphaKey> GetAlphaKeys() const { return myAlphaKeys; }
+
+		// Nearest lower cache entry, cheapest lookup.
+		Color GetColorAt(float aPosition) const;
+		// Exact value from the keys.
+		Color Evaluate(float aTime) const;
+		// Linear interpolation between the two closest cache entries for every time, four at a time with SSE.
+		// Evaluates min(aTimes.size(), outColors.size()) colors.
+		void Evaluate(std::span<const float> aTimes, std::span<Color> outColors) const;
 
 	private:
-		Color ComputeColorAt(float aTime) const;
-		void ComputeColor(Color& outColor, const float aTime) const;
-		void ComputeAlpha(float& outAlpha, const float aTime) const;
-		void FindLeftAndRightKey(std::shared_ptr<Key>& outLeft, std::shared_ptr<Key>& outRight, float aTime, const std::list<std::shared_ptr<Key>>& aList) const;
+		void RefreshCache();
+
+		// aRightKey is the index of the first key at or after aTime.
+		Color ComputeColor(float aTime, size_t aRightKey) const;
+		float ComputeAlpha(float aTime, size_t aRightKey) const;
 
 	private:
+		std::vector<ColorKey> myColorKeys;
+		std::vector<AlphaKey> myAlphaKeys;
+		std::array<Color, CacheSize> myCachedValues;
 	};
 }
@@ -0,0 +1,271 @@
+#include "CommonMathBatch.h"
+#include <algorithm>
+#include <cmath>
+#include "SIMD/MathSIMD.hpp"
+
+namespace CU::Math
+{
+	namespace
+	{
+#if CU_SIMD_SSE
+#if CU_SIMD_AVX2
+		using Lanes = SIMD::Float8;
+#else
+		using Lanes = SIMD::Float4;
+#endif
+		using Register = Lanes::Register;
+
+		// Runs aKernel(inputs, outputs) over whole registers, then once over the zero padded remainder.
+		template<size_t InputCount, size_t OutputCount, typename Kernel>
+		void RunKernel(const float* const (&aInputs)[InputCount], float* const (&outOutputs)[OutputCount], size_t aCount, Kernel&& aKernel)
+		{
+			auto run = [&aKernel](const float* const* aBlockInputs, float* const* outBlockOutputs, size_t aOffset)
+				{
+					Register inputs[InputCount];
+					Register outputs[OutputCount];
+					for (size_t i = 0; i < InputCount; ++i)
+					{
+						inputs[i] = Lanes::Load(aBlockInputs[i] + aOffset);
+					}
+
+					aKernel(inputs, outputs);
+
+					for (size_t i = 0; i < OutputCount; ++i)
+					{
+						Lanes::Store(outBlockOutputs[i] + aOffset, outputs[i]);
+					}
+				};
+
+			size_t index = 0;
+			for (; index + Lanes::Width <= aCount; index += Lanes::Width)
+			{
+				run(aInputs, outOutputs, index);
+			}
+
+			const size_t remainder = aCount - index;
+			if (remainder == 0)
+			{
+				return;
+			}
+
+			float paddedInputs[InputCount][Lanes::Width] = {};
+			float paddedOutputs[OutputCount][Lanes::Width];
+			const float* inputPointers[InputCount];
+			float* outputPointers[OutputCount];
+
+			for (size_t i = 0; i < InputCount; ++i)
+			{
+				std::copy(aInputs[i] + index, aInputs[i] + aCount, paddedInputs[i]);
+				inputPointers[i] = paddedInputs[i];
+			}
+			for (size_t i = 0; i < OutputCount; ++i)
+			{
+				outputPointers[i] = paddedOutputs[i];
+			}
+
+			run(inputPointers, outputPointers, 0);
+
+			for (size_t i = 0; i < OutputCount; ++i)
+			{
+				std::copy(paddedOutputs[i], paddedOutputs[i] + remainder, outOutputs[i] + index);
+			}
+		}
+
+		// Four packed Vector3 (x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3) to one register per component.
+		CU_FORCEINLINE void Deinterleave(const float* aVectors, __m128& outX, __m128& outY, __m128& outZ)
+		{
+			const __m128 a = _mm_loadu_ps(aVectors + 0);
+			const __m128 b = _mm_loadu_ps(aVectors + 4);
+			const __m128 c = _mm_loadu_ps(aVectors + 8);
+
+			outX = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 3, 2)), _MM_SHUFFLE(3, 0, 3, 0));
+			outY = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+			outZ = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+		}
+
+		void NormalizeVectors(float* aVectors)
+		{
+			__m128 x, y, z;
+			Deinterleave(aVectors, x, y, z);
+
+			const __m128 lengthSqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+			__m128 scale = SIMD::RSqrt<SIMD::Float4>(lengthSqr);
+			scale = _mm_andnot_ps(_mm_cmpeq_ps(lengthSqr, _mm_setzero_ps()), scale);
+
+			// The scales are spread in the same packed layout instead of transposing back
+			_mm_storeu_ps(aVectors + 0, _mm_mul_ps(_mm_loadu_ps(aVectors + 0), _mm_shuffle_ps(scale, scale, _MM_SHUFFLE(1, 0, 0, 0))));
+			_mm_storeu_ps(aVectors + 4, _mm_mul_ps(_mm_loadu_ps(aVectors + 4), _mm_shuffle_ps(scale, scale, _MM_SHUFFLE(2, 2, 1, 1))));
+			_mm_storeu_ps(aVectors + 8, _mm_mul_ps(_mm_loadu_ps(aVectors + 8), _mm_shuffle_ps(scale, scale, _MM_SHUFFLE(3, 3, 3, 2))));
+		}
+
+		void EulerToQuat(const float* aPitchYawRoll, float* outRotations)
+		{
+			__m128 pitch, yaw, roll;
+			Deinterleave(aPitchYawRoll, pitch, yaw, roll);
+
+			const __m128 half = _mm_set1_ps(0.5f);
+			__m128 sp, cp, sh, ch, sb, cb;
+			SIMD::SinCos<SIMD::Float4>(_mm_mul_ps(pitch, half), sp, cp);
+			SIMD::SinCos<SIMD::Float4>(_mm_mul_ps(yaw, half), sh, ch);
+			SIMD::SinCos<SIMD::Float4>(_mm_mul_ps(roll, half), sb, cb);
+
+			const __m128 chcp = _mm_mul_ps(ch, cp);
+			const __m128 shsp = _mm_mul_ps(sh, sp);
+			const __m128 chsp = _mm_mul_ps(ch, sp);
+			const __m128 shcp = _mm_mul_ps(sh, cp);
+
+			__m128 w = _mm_add_ps(_mm_mul_ps(chcp, cb), _mm_mul_ps(shsp, sb));
+			__m128 x = _mm_add_ps(_mm_mul_ps(chsp, cb), _mm_mul_ps(shcp, sb));
+			__m128 y = _mm_sub_ps(_mm_mul_ps(shcp, cb), _mm_mul_ps(chsp, sb));
+			__m128 z = _mm_sub_ps(_mm_mul_ps(chcp, sb), _mm_mul_ps(shsp, cb));
+			_MM_TRANSPOSE4_PS(w, x, y, z);
+
+			_mm_storeu_ps(outRotations + 0, w);
+			_mm_storeu_ps(outRotations + 4, x);
+			_mm_storeu_ps(outRotations + 8, y);
+			_mm_storeu_ps(outRotations + 12, z);
+		}
+#endif
+	}
+
+	void SinCos(std::span<const float> aAngles, std::span<float> outSin, std::span<float> outCos)
+	{
+		const size_t count = std::min({ aAngles.size(), outSin.size(), outCos.size() });
+
+#if CU_SIMD_SSE
+		RunKernel({ aAngles.data() }, { outSin.data(), outCos.data() }, count, [](const Register* aInputs, Register* outOutputs)
+			{
+				SIMD::SinCos<Lanes>(aInputs[0], outOutputs[0], outOutputs[1]);
+			});
+#else
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float angle = aAngles[i];
+			outSin[i] = std::sin(angle);
+			outCos[i] = std::cos(angle);
+		}
+#endif
+	}
+
+	void RSqrt(std::span<const float> aValues, std::span<float> outResults)
+	{
+		const size_t count = std::min(aValues.size(), outResults.size());
+
+#if CU_SIMD_SSE
+		RunKernel({ aValues.data() }, { outResults.data() }, count, [](const Register* aInputs, Register* outOutputs)
+			{
+				outOutputs[0] = SIMD::RSqrt<Lanes>(aInputs[0]);
+			});
+#else
+		for (size_t i = 0; i < count; ++i)
+		{
+			outResults[i] = 1.0f / std::sqrt(aValues[i]);
+		}
+#endif
+	}
+
+	void Atan2(std::span<const float> aY, std::span<const float> aX, std::span<float> outResults)
+	{
+		const size_t count = std::min({ aY.size(), aX.size(), outResults.size() });
+
+#if CU_SIMD_SSE
+		RunKernel({ aY.data(), aX.data() }, { outResults.data() }, count, [](const Register* aInputs, Register* outOutputs)
+			{
+				outOutputs[0] = SIMD::Atan2<Lanes>(aInputs[0], aInputs[1]);
+			});
+#else
+		for (size_t i = 0; i < count; ++i)
+		{
+			outResults[i] = std::atan2(aY[i], aX[i]);
+		}
+#endif
+	}
+
+	void Exp(std::span<const float> aValues, std::span<float> outResults)
+	{
+		const size_t count = std::min(aValues.size(), outResults.size());
+
+#if CU_SIMD_SSE
+		RunKernel({ aValues.data() }, { outResults.data() }, count, [](const Register* aInputs, Register* outOutputs)
+			{
+				outOutputs[0] = SIMD::Exp<Lanes>(aInputs[0]);
+			});
+#else
+		for (size_t i = 0; i < count; ++i)
+		{
+			outResults[i] = std::exp(aValues[i]);
+		}
+#endif
+	}
+
+	void Log(std::span<const float> aValues, std::span<float> outResults)
+	{
+		const size_t count = std::min(aValues.size(), outResults.size());
+
+#if CU_SIMD_SSE
+		RunKernel({ aValues.data() }, { outResults.data() }, count, [](const Register* aInputs, Register* outOutputs)
+			{
+				outOutputs[0] = SIMD::Log<Lanes>(aInputs[0]);
+			});
+#else
+		for (size_t i = 0; i < count; ++i)
+		{
+			outResults[i] = std::log(aValues[i]);
+		}
+#endif
+	}
+
+	void NormalizeVectors(std::span<Vector3f> aVectors)
+	{
+		static_assert(sizeof(Vector3f) == sizeof(float) * 3);
+		size_t i = 0;
+
+#if CU_SIMD_SSE
+		for (; i + 4 <= aVectors.size(); i += 4)
+		{
+			NormalizeVectors(&aVectors[i].x);
+		}
+
+		if (i < aVectors.size())
+		{
+			Vector3f padded[4] = {};
+			std::copy(aVectors.begin() + i, aVectors.end(), padded);
+			NormalizeVectors(&padded[0].x);
+			std::copy(padded, padded + (aVectors.size() - i), aVectors.begin() + i);
+		}
+#else
+		for (; i < aVectors.size(); ++i)
+		{
+			aVectors[i].Normalize();
+		}
+#endif
+	}
+
+	void EulerToQuat(std::span<const Vector3f> aPitchYawRoll, std::span<Quatf> outRotations)
+	{
+		static_assert(sizeof(Quatf) == sizeof(float) * 4);
+		const size_t count = std::min(aPitchYawRoll.size(), outRotations.size());
+		size_t i = 0;
+
+#if CU_SIMD_SSE
+		for (; i + 4 <= count; i += 4)
+		{
+			EulerToQuat(&aPitchYawRoll[i].x, &outRotations[i].w);
+		}
+
+		if (i < count)
+		{
+			Vector3f padded[4] = {};
+			Quatf rotations[4];
+			std::copy(aPitchYawRoll.begin() + i, aPitchYawRoll.begin() + count, padded);
+			EulerToQuat(&padded[0].x, &rotations[0].w);
+			std::copy(rotations, rotations + (count - i), outRotations.begin() + i);
+		}
+#else
+		for (; i < count; ++i)
+		{
+			outRotations[i] = Quatf(aPitchYawRoll[i]);
+		}
+#endif
+	}
+}
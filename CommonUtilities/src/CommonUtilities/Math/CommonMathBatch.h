@@ -0,0 +1,31 @@
+#pragma once
+#include <span>
+#include "Vector/Vector.h"
+#include "Matrix/Matrix.h"
+#include "Quaternion.hpp"
+
+// Array versions of the CommonMath/Vector/Quaternion functions, 8 values at a time in AVX2 builds and 4 with SSE
+// (NormalizeVectors and EulerToQuat always work on 4 vectors).
+// Every function processes min(input size, output size) elements, outputs may alias their inputs.
+// The remainder goes through the same kernels padded, so every element gets the same result regardless of its position.
+// Max errors measured against double precision over the valid range (ULP = units in the last place of the float result):
+//	SinCos	1.6 ULP for |x| <= 8192, absolute error below 2e-10 where the result is close to zero
+//	RSqrt	4.2 ULP (estimate plus one Newton-Raphson step)
+//	Atan2	3.1 ULP
+//	Exp		1 ULP, also for denormal results
+//	Log		0.8 ULP
+// Builds without SIMD fall back to the std functions.
+
+namespace CU::Math
+{
+	void SinCos(std::span<const float> aAngles, std::span<float> outSin, std::span<float> outCos);
+	void RSqrt(std::span<const float> aValues, std::span<float> outResults);
+	void Atan2(std::span<const float> aY, std::span<const float> aX, std::span<float> outResults);
+	void Exp(std::span<const float> aValues, std::span<float> outResults);
+	void Log(std::span<const float> aValues, std::span<float> outResults);
+
+	// Same as Vector3::Normalize through RSqrt, zero vectors stay zero.
+	void NormalizeVectors(std::span<Vector3f> aVectors);
+	// Same rotation as the Quaternion(pitch, yaw, roll) constructor, angles in radians.
+	void EulerToQuat(std::span<const Vector3f> aPitchYawRoll, std::span<Quatf> outRotations);
+}
@@ -0,0 +1,71 @@
+#include "CompactTransform.h"
+#include "Transform.h"
+
+namespace CU
+{
+	CompactTransform::CompactTransform(const Vector3f& aTranslation, const Quatf& aRotation, const Vector3f& aScale) : myTranslation(aTranslation), myRotation(aRotation), myScale(aScale) {}
+
+	CompactTransform::CompactTransform(const Vector3f& aTranslation, const Vector3f& aEulerAngles, const Vector3f& aScale) : myTranslation(aTranslation), myRotation(aEulerAngles), myScale(aScale) {}
+
+	CompactTransform::CompactTransform(const Matrix4x4f& aMatrix)
+	{
+		SetTransform(aMatrix);
+	}
+
+	CompactTransform::CompactTransform(const Transform& aTransform) : myTranslation(aTransform.GetTranslation()), myRotation(aTransform.GetRotationQuat()), myScale(aTransform.GetScale()) {}
+
+	Matrix4x4f CompactTransform::GetMatrix() const
+	{
+		// The scale and translation matrices only scale the rotation rows and fill in the last row
+		const Vector3f right = myRotation.GetRight() * myScale.x;
+		const Vector3f up = myRotation.GetUp() * myScale.y;
+		const Vector3f forward = myRotation.GetForward() * myScale.z;
+
+		Matrix4x4f result = Matrix4x4f::Identity;
+		result[0] = right.x;
+		result[1] = right.y;
+		result[2] = right.z;
+		result[4] = up.x;
+		result[5] = up.y;
+		result[6] = up.z;
+		result[8] = forward.x;
+		result[9] = forward.y;
+		result[10] = forward.z;
+		result[12] = myTranslation.x;
+		result[13] = myTranslation.y;
+		result[14] = myTranslation.z;
+		return result;
+	}
+
+	Transform CompactTransform::ToTransform() const
+	{
+		Transform result(myTranslation, Vector3f::Zero, myScale);
+		result.SetRotation(myRotation);
+		return result;
+	}
+
+	void CompactTransform::SetTransform(const Matrix4x4f& aMatrix)
+	{
+		aMatrix.Decompose(myTranslation, myRotation, myScale);
+	}
+
+	void CompactTransform::RotateAround(const Vector3f& aPoint, const Vector3f& aAxis, float aAngle)
+	{
+		const Quatf rotation = Quatf(aAxis, aAngle);
+		myRotation *= rotation;
+		myTranslation = Quatf::RotateVectorByQuaternion((myTranslation - aPoint), rotation) + aPoint;
+	}
+
+	void CompactTransform::LookAt(const Vector3f& aTarget, const Vector3f& aUp)
+	{
+		const Vector3f forwardDir = (aTarget - myTranslation).GetNormalized();
+
+		if (forwardDir == aUp) return;
+
+		const Vector3f rightDir = aUp.Cross(forwardDir).GetNormalized();
+		const Vector3f upDir = forwardDir.Cross(rightDir).GetNormalized();
+
+		const Matrix3x3f rotationMatrix = Matrix4x4f::CreateRotationMatrix(rightDir, upDir, forwardDir);
+		myRotation = Quatf(rotationMatrix);
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "Vector/Vector.h"
+#include "Matrix/Matrix.h"
+#include "Quaternion.hpp"
+#include "CommonMath.hpp"
+
+namespace CU
+{
+	class Transform;
+
+	// Translation, rotation and scale only, 40 bytes against Transform's ~140.
+	// The quaternion is the only stored rotation, Euler angles are derived from it when asked for
+	// and the matrix is built on every GetMatrix() call instead of being cached.
+	// Meant for data that is streamed in bulk (scene components), use Transform where a cached matrix pays off.
+	class CompactTransform
+	{
+	public:
+		CompactTransform() = default;
+		CompactTransform(const Vector3f& aTranslation, const Quatf& aRotation = Quatf(), const Vector3f& aScale = Vector3f::One);
+		CompactTransform(const Vector3f& aTranslation, const Vector3f& aEulerAngles, const Vector3f& aScale = Vector3f::One);
+		explicit CompactTransform(const Matrix4x4f& aMatrix);
+		explicit CompactTransform(const Transform& aTransform);
+		~CompactTransform() = default;
+
+		const Vector3f& GetTranslation() const { return myTranslation; }
+		const Quatf& GetRotation() const { return myRotation; }
+		const Vector3f& GetScale() const { return myScale; }
+
+		// Derived from the quaternion, so it's not guaranteed to give back the angles that were set.
+		Vector3f GetEulerAngles() const { return myRotation.GetEulerAngles(); }
+
+		Vector3f GetRight() const { return myRotation.GetRight(); }
+		Vector3f GetUp() const { return myRotation.GetUp(); }
+		Vector3f GetForward() const { return myRotation.GetForward(); }
+
+		// Scale * Rotation * Translation, same as Transform::GetMatrix() up to the sign of zero elements.
+		Matrix4x4f GetMatrix() const;
+		Transform ToTransform() const;
+
+		void SetTranslation(const Vector3f& aTranslation) { myTranslation = aTranslation; }
+		void SetRotation(const Quatf& aRotation) { myRotation = aRotation; }
+		void SetEulerAngles(const Vector3f& aEulerAngles) { myRotation = Quatf(aEulerAngles); }
+		void SetScale(const Vector3f& aScale) { myScale = aScale; }
+		void SetTransform(const Matrix4x4f& aMatrix);
+
+		void Translate(const Vector3f& aTranslation) { myTranslation += aTranslation; }
+		// Applied after the current rotation, same order as Transform::RotateAround.
+		void Rotate(const Quatf& aRotation) { myRotation *= aRotation; }
+		void Scale(const Vector3f& aScale) { myScale += aScale; }
+
+		void RotateAround(const Vector3f& aPoint, const Vector3f& aAxis, float aAngle);
+		void LookAt(const Vector3f& aTarget, const Vector3f& aUp = Vector3f::Up);
+
+	private:
+		Vector3f myTranslation = Vector3f::Zero;
+		Quatf myRotation;
+		Vector3f myScale = Vector3f::One;
+	};
+
+	static_assert(sizeof(CompactTransform) == 40);
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <cfloat>
+#include "CommonUtilities/Math/Vector/Vector.h"
+#include "CommonUtilities/Math/Matrix/Matrix.h"
+
+namespace CU
+{
+	class AABB
+	{
+	public:
+		Vector3f min;
+		Vector3f max;
+
+		// Starts out inverted so the first Encapsulate() sets both corners.
+		AABB() : min(FLT_MAX), max(-FLT_MAX) {}
+		AABB(const Vector3f& aMin, const Vector3f& aMax) : min(aMin), max(aMax) {}
+		~AABB() = default;
+
+		static AABB FromCenterExtents(const Vector3f& aCenter, const Vector3f& aExtents) { return AABB(aCenter - aExtents, aCenter + aExtents); }
+
+		bool IsValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+		Vector3f GetCenter() const { return (min + max) * 0.5f; }
+		Vector3f GetExtents() const { return (max - min) * 0.5f; }
+		Vector3f GetSize() const { return max - min; }
+		float GetSurfaceArea() const;
+
+		void Encapsulate(const Vector3f& aPoint);
+		void Encapsulate(const AABB& aAABB);
+
+		bool Contains(const Vector3f& aPoint) const;
+		bool Contains(const AABB& aAABB) const;
+		bool Intersects(const AABB& aAABB) const;
+
+		Vector3f GetClosestPoint(const Vector3f& aPoint) const;
+
+		// Box enclosing this box after it's been transformed by aMatrix (row vector convention, same as the rest of the math library).
+		AABB GetTransformed(const Matrix4x4f& aMatrix) const;
+	};
+
+	inline float AABB::GetSurfaceArea() const
+	{
+		const Vector3f size = GetSize();
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	inline void AABB::Encapsulate(const Vector3f& aPoint)
+	{
+		min = { Math::Min(min.x, aPoint.x), Math::Min(min.y, aPoint.y), Math::Min(min.z, aPoint.z) };
+		max = { Math::Max(max.x, aPoint.x), Math::Max(max.y, aPoint.y), Math::Max(max.z, aPoint.z) };
+	}
+
+	inline void AABB::Encapsulate(const AABB& aAABB)
+	{
+		min = { Math::Min(min.x, aAABB.min.x), Math::Min(min.y, aAABB.min.y), Math::Min(min.z, aAABB.min.z) };
+		max = { Math::Max(max.x, aAABB.max.x), Math::Max(max.y, aAABB.max.y), Math::Max(max.z, aAABB.max.z) };
+	}
+
+	inline bool AABB::Contains(const Vector3f& aPoint) const
+	{
+		return
+			aPoint.x >= min.x && aPoint.x <= max.x &&
+			aPoint.y >= min.y && aPoint.y <= max.y &&
+			aPoint.z >= min.z && aPoint.z <= max.z;
+	}
+
+	inline bool AABB::Contains(const AABB& aAABB) const
+	{
+		return
+			aAABB.min.x >= min.x && aAABB.max.x <= max.x &&
+			aAABB.min.y >= min.y && aAABB.max.y <= max.y &&
+			aAABB.min.z >= min.z && aAABB.max.z <= max.z;
+	}
+
+	inline bool AABB::Intersects(const AABB& aAABB) const
+	{
+		return
+			min.x <= aAABB.max.x && max.x >= aAABB.min.x &&
+			min.y <= aAABB.max.y && max.y >= aAABB.min.y &&
+			min.z <= aAABB.max.z && max.z >= aAABB.min.z;
+	}
+
+	inline Vector3f AABB::GetClosestPoint(const Vector3f& aPoint) const
+	{
+		return
+		{
+			Math::Clamp(aPoint.x, min.x, max.x),
+			Math::Clamp(aPoint.y, min.y, max.y),
+			Math::Clamp(aPoint.z, min.z, max.z)
+		};
+	}
+
+	inline AABB AABB::GetTransformed(const Matrix4x4f& aMatrix) const
+	{
+		// Arvo's method, the new extents are the old ones projected onto the absolute basis of the matrix.
+		const Vector3f center = GetCenter();
+		const Vector3f extents = GetExtents();
+
+		const Vector3f newCenter
+		(
+			center.x * aMatrix[0] + center.y * aMatrix[4] + center.z * aMatrix[8] + aMatrix[12],
+			center.x * aMatrix[1] + center.y * aMatrix[5] + center.z * aMatrix[9] + aMatrix[13],
+			center.x * aMatrix[2] + center.y * aMatrix[6] + center.z * aMatrix[10] + aMatrix[14]
+		);
+
+		const Vector3f newExtents
+		(
+			extents.x * std::abs(aMatrix[0]) + extents.y * std::abs(aMatrix[4]) + extents.z * std::abs(aMatrix[8]),
+			extents.x * std::abs(aMatrix[1]) + extents.y * std::abs(aMatrix[5]) + extents.z * std::abs(aMatrix[9]),
+			extents.x * std::abs(aMatrix[2]) + extents.y * std::abs(aMatrix[6]) + extents.z * std::abs(aMatrix[10])
+		);
+
+		return FromCenterExtents(newCenter, newExtents);
+	}
+}
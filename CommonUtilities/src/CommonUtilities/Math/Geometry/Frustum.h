@@ -0,0 +1,100 @@
+#pragma once
+#include <array>
+#include "Plane.h"
+#include "Sphere.h"
+#include "CommonUtilities/Math/Matrix/Matrix.h"
+
+namespace CU
+{
+	// Six inward facing planes, a point is inside when it's in front of all of them.
+	class Frustum
+	{
+	public:
+		enum PlaneIndex { Left, Right, Bottom, Top, Near, Far, Count };
+
+		std::array<Plane, PlaneIndex::Count> planes;
+
+		Frustum() = default;
+		// Extracts the planes from a view-projection matrix (row vectors, clip space depth in [0, 1] like CreatePerspectiveProjection).
+		// With only a projection matrix the planes end up in view space.
+		Frustum(const Matrix4x4f& aViewProjection);
+		~Frustum() = default;
+
+		bool Contains(const Vector3f& aPoint) const;
+		bool Intersects(const AABB& aAABB) const;
+		bool Intersects(const Sphere& aSphere) const;
+	};
+
+	inline Frustum::Frustum(const Matrix4x4f& aViewProjection)
+	{
+		// Clip space position is (x, y, z, w) = point * matrix, so every plane is a combination of the matrix columns.
+		auto column = [&aViewProjection](int aColumn)
+			{
+				return Vector4f(aViewProjection[aColumn], aViewProjection[4 + aColumn], aViewProjection[8 + aColumn], aViewProjection[12 + aColumn]);
+			};
+
+		const Vector4f x = column(0);
+		const Vector4f y = column(1);
+		const Vector4f z = column(2);
+		const Vector4f w = column(3);
+
+		auto setPlane = [this](PlaneIndex aIndex, const Vector4f& aCoefficients)
+			{
+				Plane& plane = planes[aIndex];
+				plane.normal = { aCoefficients.x, aCoefficients.y, aCoefficients.z };
+				plane.distance = aCoefficients.w;
+				plane.Normalize();
+			};
+
+		setPlane(Left, w + x);
+		setPlane(Right, w - x);
+		setPlane(Bottom, w + y);
+		setPlane(Top, w - y);
+		setPlane(Near, z);
+		setPlane(Far, w - z);
+	}
+
+	inline bool Frustum::Contains(const Vector3f& aPoint) const
+	{
+		for (const Plane& plane : planes)
+		{
+			if (!plane.IsInFront(aPoint))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	inline bool Frustum::Intersects(const AABB& aAABB) const
+	{
+		// Conservative: boxes crossing two planes outside a corner of the frustum are reported as visible.
+		const Vector3f center = aAABB.GetCenter();
+		const Vector3f extents = aAABB.GetExtents();
+
+		for (const Plane& plane : planes)
+		{
+			const float radius = extents.x * std::abs(plane.normal.x) + extents.y * std::abs(plane.normal.y) + extents.z * std::abs(plane.normal.z);
+			if (plane.GetSignedDistance(center) < -radius)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	inline bool Frustum::Intersects(const Sphere& aSphere) const
+	{
+		for (const Plane& plane : planes)
+		{
+			if (plane.GetSignedDistance(aSphere.center) < -aSphere.radius)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,7 @@
+#pragma once
+#include "AABB.h"
+#include "Sphere.h"
+#include "Plane.h"
+#include "Ray.h"
+#include "Frustum.h"
+#include "Intersection.h"
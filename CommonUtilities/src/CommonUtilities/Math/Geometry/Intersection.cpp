@@ -0,0 +1,321 @@
+#include "Intersection.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "CommonUtilities/Math/SIMD/MatrixSIMD.hpp"
+
+namespace CU
+{
+	namespace
+	{
+		// The distances where the ray enters and leaves one slab. A ray parallel to the slab with its origin on one of
+		// its planes gives 0 * inf = NaN, it runs along the boundary and the slab doesn't limit it, like a parallel ray inside.
+		void GetSlab(float aMin, float aMax, float aOrigin, float aInverseDirection, float& outNear, float& outFar)
+		{
+			const float t0 = (aMin - aOrigin) * aInverseDirection;
+			const float t1 = (aMax - aOrigin) * aInverseDirection;
+
+			if (std::isnan(t0) || std::isnan(t1))
+			{
+				outNear = -std::numeric_limits<float>::infinity();
+				outFar = std::numeric_limits<float>::infinity();
+				return;
+			}
+
+			outNear = Math::Min(t0, t1);
+			outFar = Math::Max(t0, t1);
+		}
+	}
+
+	bool Intersects(const Ray& aRay, const AABB& aAABB, float& outDistance)
+	{
+		const Vector3f inverseDirection = aRay.GetInverseDirection();
+
+		float nearX, farX, nearY, farY, nearZ, farZ;
+		GetSlab(aAABB.min.x, aAABB.max.x, aRay.origin.x, inverseDirection.x, nearX, farX);
+		GetSlab(aAABB.min.y, aAABB.max.y, aRay.origin.y, inverseDirection.y, nearY, farY);
+		GetSlab(aAABB.min.z, aAABB.max.z, aRay.origin.z, inverseDirection.z, nearZ, farZ);
+
+		const float tMin = Math::Max(Math::Max(nearX, nearY), nearZ);
+		const float tMax = Math::Min(Math::Min(farX, farY), farZ);
+
+		if (tMax < 0.0f || tMin > tMax)
+		{
+			return false;
+		}
+
+		outDistance = Math::Max(tMin, 0.0f);
+		return true;
+	}
+
+	bool Intersects(const Ray& aRay, const Sphere& aSphere, float& outDistance)
+	{
+		const Vector3f offset = aRay.origin - aSphere.center;
+		const float b = offset.Dot(aRay.direction);
+		const float c = offset.LengthSqr() - aSphere.radius * aSphere.radius;
+
+		// Origin outside the sphere and pointing away from it.
+		if (c > 0.0f && b > 0.0f)
+		{
+			return false;
+		}
+
+		const float discriminant = b * b - c;
+		if (discriminant < 0.0f)
+		{
+			return false;
+		}
+
+		outDistance = Math::Max(-b - std::sqrt(discriminant), 0.0f);
+		return true;
+	}
+
+	bool Intersects(const Ray& aRay, const Plane& aPlane, float& outDistance)
+	{
+		const float denominator = aPlane.normal.Dot(aRay.direction);
+		if (std::abs(denominator) < Math::Epsilon)
+		{
+			return false;
+		}
+
+		const float distance = -aPlane.GetSignedDistance(aRay.origin) / denominator;
+		if (distance < 0.0f)
+		{
+			return false;
+		}
+
+		outDistance = distance;
+		return true;
+	}
+
+	namespace
+	{
+		// Frustum planes in structure-of-arrays form, padded to 8 with planes nothing can be behind.
+		struct FrustumPlanes
+		{
+			alignas(32) float normalX[8];
+			alignas(32) float normalY[8];
+			alignas(32) float normalZ[8];
+			alignas(32) float distance[8];
+			alignas(32) float absNormalX[8];
+			alignas(32) float absNormalY[8];
+			alignas(32) float absNormalZ[8];
+
+			FrustumPlanes(const Frustum& aFrustum)
+			{
+				for (int i = 0; i < 8; ++i)
+				{
+					const Plane plane = i < Frustum::Count ? aFrustum.planes[i] : Plane(Vector3f::Zero, 1.0f);
+					normalX[i] = plane.normal.x;
+					normalY[i] = plane.normal.y;
+					normalZ[i] = plane.normal.z;
+					distance[i] = plane.distance;
+					absNormalX[i] = std::abs(plane.normal.x);
+					absNormalY[i] = std::abs(plane.normal.y);
+					absNormalZ[i] = std::abs(plane.normal.z);
+				}
+			}
+		};
+
+		// Writes the visibility mask one word at a time, aIsVisible(i) is called for every index in order.
+		template<typename Function>
+		size_t BuildVisibilityMask(size_t aCount, std::span<uint64_t> outVisibility, Function&& aIsVisible)
+		{
+			size_t visibleCount = 0;
+			for (size_t word = 0; word < outVisibility.size(); ++word)
+			{
+				const size_t start = word * 64;
+				const size_t end = std::min(start + 64, aCount);
+
+				uint64_t bits = 0;
+				for (size_t i = start; i < end; ++i)
+				{
+					if (aIsVisible(i))
+					{
+						bits |= uint64_t(1) << (i - start);
+						++visibleCount;
+					}
+				}
+
+				outVisibility[word] = bits;
+			}
+
+			return visibleCount;
+		}
+
+#if CU_SIMD_SSE
+		// The six planes are tested in parallel, one plane per lane. The operations follow Frustum::Intersects so the results match.
+		struct PlaneTester
+		{
+#if CU_SIMD_AVX2
+			__m256 normalX, normalY, normalZ, distance, absNormalX, absNormalY, absNormalZ;
+
+			PlaneTester(const FrustumPlanes& aPlanes) :
+				normalX(_mm256_load_ps(aPlanes.normalX)), normalY(_mm256_load_ps(aPlanes.normalY)), normalZ(_mm256_load_ps(aPlanes.normalZ)),
+				distance(_mm256_load_ps(aPlanes.distance)),
+				absNormalX(_mm256_load_ps(aPlanes.absNormalX)), absNormalY(_mm256_load_ps(aPlanes.absNormalY)), absNormalZ(_mm256_load_ps(aPlanes.absNormalZ)) {}
+
+			CU_FORCEINLINE bool IsOutside(float aX, float aY, float aZ, __m256 aRadius) const
+			{
+				const __m256 x = _mm256_set1_ps(aX);
+				const __m256 y = _mm256_set1_ps(aY);
+				const __m256 z = _mm256_set1_ps(aZ);
+
+				__m256 signedDistance = _mm256_mul_ps(normalX, x);
+				signedDistance = _mm256_add_ps(signedDistance, _mm256_mul_ps(normalY, y));
+				signedDistance = _mm256_add_ps(signedDistance, _mm256_mul_ps(normalZ, z));
+				signedDistance = _mm256_add_ps(signedDistance, distance);
+
+				const __m256 negativeRadius = _mm256_xor_ps(aRadius, _mm256_set1_ps(-0.0f));
+				return _mm256_movemask_ps(_mm256_cmp_ps(signedDistance, negativeRadius, _CMP_LT_OQ)) != 0;
+			}
+
+			CU_FORCEINLINE bool IsOutside(const Vector3f& aCenter, float aRadius) const
+			{
+				return IsOutside(aCenter.x, aCenter.y, aCenter.z, _mm256_set1_ps(aRadius));
+			}
+
+			CU_FORCEINLINE bool IsOutside(const Vector3f& aCenter, const Vector3f& aExtents) const
+			{
+				__m256 radius = _mm256_mul_ps(_mm256_set1_ps(aExtents.x), absNormalX);
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_set1_ps(aExtents.y), absNormalY));
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_set1_ps(aExtents.z), absNormalZ));
+				return IsOutside(aCenter.x, aCenter.y, aCenter.z, radius);
+			}
+#else
+			__m128 normalX[2], normalY[2], normalZ[2], distance[2], absNormalX[2], absNormalY[2], absNormalZ[2];
+
+			PlaneTester(const FrustumPlanes& aPlanes)
+			{
+				for (int i = 0; i < 2; ++i)
+				{
+					normalX[i] = _mm_load_ps(aPlanes.normalX + i * 4);
+					normalY[i] = _mm_load_ps(aPlanes.normalY + i * 4);
+					normalZ[i] = _mm_load_ps(aPlanes.normalZ + i * 4);
+					distance[i] = _mm_load_ps(aPlanes.distance + i * 4);
+					absNormalX[i] = _mm_load_ps(aPlanes.absNormalX + i * 4);
+					absNormalY[i] = _mm_load_ps(aPlanes.absNormalY + i * 4);
+					absNormalZ[i] = _mm_load_ps(aPlanes.absNormalZ + i * 4);
+				}
+			}
+
+			CU_FORCEINLINE bool IsOutside(const Vector3f& aCenter, const __m128* aRadius) const
+			{
+				const __m128 x = _mm_set1_ps(aCenter.x);
+				const __m128 y = _mm_set1_ps(aCenter.y);
+				const __m128 z = _mm_set1_ps(aCenter.z);
+
+				int outside = 0;
+				for (int i = 0; i < 2; ++i)
+				{
+					__m128 signedDistance = _mm_mul_ps(normalX[i], x);
+					signedDistance = _mm_add_ps(signedDistance, _mm_mul_ps(normalY[i], y));
+					signedDistance = _mm_add_ps(signedDistance, _mm_mul_ps(normalZ[i], z));
+					signedDistance = _mm_add_ps(signedDistance, distance[i]);
+
+					outside |= _mm_movemask_ps(_mm_cmplt_ps(signedDistance, SIMD::Negate(aRadius[i])));
+				}
+
+				return outside != 0;
+			}
+
+			CU_FORCEINLINE bool IsOutside(const Vector3f& aCenter, float aRadius) const
+			{
+				const __m128 radius[2] = { _mm_set1_ps(aRadius), _mm_set1_ps(aRadius) };
+				return IsOutside(aCenter, radius);
+			}
+
+			CU_FORCEINLINE bool IsOutside(const Vector3f& aCenter, const Vector3f& aExtents) const
+			{
+				__m128 radius[2];
+				for (int i = 0; i < 2; ++i)
+				{
+					radius[i] = _mm_mul_ps(_mm_set1_ps(aExtents.x), absNormalX[i]);
+					radius[i] = _mm_add_ps(radius[i], _mm_mul_ps(_mm_set1_ps(aExtents.y), absNormalY[i]));
+					radius[i] = _mm_add_ps(radius[i], _mm_mul_ps(_mm_set1_ps(aExtents.z), absNormalZ[i]));
+				}
+
+				return IsOutside(aCenter, radius);
+			}
+#endif
+		};
+
+		// Stores x, y and z of aValue without touching the float after them.
+		CU_FORCEINLINE void StoreVector3(float* outValue, __m128 aValue)
+		{
+			_mm_storel_pi(reinterpret_cast<__m64*>(outValue), aValue);
+			_mm_store_ss(outValue + 2, _mm_movehl_ps(aValue, aValue));
+		}
+
+		CU_FORCEINLINE void TransformAABB(const AABB& aAABB, const float* aMatrix, AABB& outAABB)
+		{
+			const Vector3f center = aAABB.GetCenter();
+			const Vector3f extents = aAABB.GetExtents();
+
+			const __m128 newCenter = SIMD::TransformVector4(aMatrix, _mm_setr_ps(center.x, center.y, center.z, 1.0f));
+
+			const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+			__m128 newExtents = _mm_mul_ps(_mm_set1_ps(extents.x), _mm_and_ps(_mm_loadu_ps(aMatrix + 0), absMask));
+			newExtents = _mm_add_ps(newExtents, _mm_mul_ps(_mm_set1_ps(extents.y), _mm_and_ps(_mm_loadu_ps(aMatrix + 4), absMask)));
+			newExtents = _mm_add_ps(newExtents, _mm_mul_ps(_mm_set1_ps(extents.z), _mm_and_ps(_mm_loadu_ps(aMatrix + 8), absMask)));
+
+			StoreVector3(&outAABB.min.x, _mm_sub_ps(newCenter, newExtents));
+			StoreVector3(&outAABB.max.x, _mm_add_ps(newCenter, newExtents));
+		}
+#endif
+	}
+
+	size_t TestVisibility(const Frustum& aFrustum, std::span<const AABB> aAABBs, std::span<uint64_t> outVisibility)
+	{
+#if CU_SIMD_SSE
+		const PlaneTester tester(FrustumPlanes{ aFrustum });
+		return BuildVisibilityMask(aAABBs.size(), outVisibility, [&](size_t aIndex)
+			{
+				const AABB& aabb = aAABBs[aIndex];
+				return !tester.IsOutside(aabb.GetCenter(), aabb.GetExtents());
+			});
+#else
+		return BuildVisibilityMask(aAABBs.size(), outVisibility, [&](size_t aIndex) { return aFrustum.Intersects(aAABBs[aIndex]); });
+#endif
+	}
+
+	size_t TestVisibility(const Frustum& aFrustum, std::span<const Sphere> aSpheres, std::span<uint64_t> outVisibility)
+	{
+#if CU_SIMD_SSE
+		const PlaneTester tester(FrustumPlanes{ aFrustum });
+		return BuildVisibilityMask(aSpheres.size(), outVisibility, [&](size_t aIndex)
+			{
+				const Sphere& sphere = aSpheres[aIndex];
+				return !tester.IsOutside(sphere.center, sphere.radius);
+			});
+#else
+		return BuildVisibilityMask(aSpheres.size(), outVisibility, [&](size_t aIndex) { return aFrustum.Intersects(aSpheres[aIndex]); });
+#endif
+	}
+
+	void TransformAABBs(std::span<const AABB> aAABBs, std::span<const Matrix4x4f> aMatrices, std::span<AABB> outAABBs)
+	{
+		const size_t count = std::min({ aAABBs.size(), aMatrices.size(), outAABBs.size() });
+		for (size_t i = 0; i < count; ++i)
+		{
+#if CU_SIMD_SSE
+			TransformAABB(aAABBs[i], &aMatrices[i][0], outAABBs[i]);
+#else
+			outAABBs[i] = aAABBs[i].GetTransformed(aMatrices[i]);
+#endif
+		}
+	}
+
+	void TransformAABBs(std::span<const AABB> aAABBs, const Matrix4x4f& aMatrix, std::span<AABB> outAABBs)
+	{
+		const size_t count = std::min(aAABBs.size(), outAABBs.size());
+		for (size_t i = 0; i < count; ++i)
+		{
+#if CU_SIMD_SSE
+			TransformAABB(aAABBs[i], &aMatrix[0], outAABBs[i]);
+#else
+			outAABBs[i] = aAABBs[i].GetTransformed(aMatrix);
+#endif
+		}
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <span>
+#include <cstdint>
+#include "AABB.h"
+#include "Sphere.h"
+#include "Plane.h"
+#include "Frustum.h"
+#include "Ray.h"
+
+namespace CU
+{
+	// Ray tests return the distance along the ray to the first hit through outDistance, hits behind the origin are ignored.
+	// A ray starting inside a volume hits it at distance 0. A ray running along a face of a box touches it and hits it.
+	bool Intersects(const Ray& aRay, const AABB& aAABB, float& outDistance);
+	bool Intersects(const Ray& aRay, const Sphere& aSphere, float& outDistance);
+	bool Intersects(const Ray& aRay, const Plane& aPlane, float& outDistance);
+
+	// Number of 64-bit words needed for the visibility mask of aCount volumes.
+	constexpr size_t GetVisibilityMaskSize(size_t aCount) { return (aCount + 63) / 64; }
+
+	// Tests every volume against the frustum and sets bit (i % 64) of outVisibility[i / 64] for the ones that are visible, returns the visible count.
+	// Same result as Frustum::Intersects for each volume. outVisibility needs GetVisibilityMaskSize(count) words, all of them get written.
+	size_t TestVisibility(const Frustum& aFrustum, std::span<const AABB> aAABBs, std::span<uint64_t> outVisibility);
+	size_t TestVisibility(const Frustum& aFrustum, std::span<const Sphere> aSpheres, std::span<uint64_t> outVisibility);
+
+	// outAABBs[i] = aAABBs[i].GetTransformed(aMatrices[i]).
+	void TransformAABBs(std::span<const AABB> aAABBs, std::span<const Matrix4x4f> aMatrices, std::span<AABB> outAABBs);
+	// Transforms every box by the same matrix.
+	void TransformAABBs(std::span<const AABB> aAABBs, const Matrix4x4f& aMatrix, std::span<AABB> outAABBs);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "CommonUtilities/Math/Vector/Vector.h"
+
+namespace CU
+{
+	// Points where normal.Dot(point) + distance == 0, positive signed distances are in front of the plane.
+	class Plane
+	{
+	public:
+		Vector3f normal;
+		float distance = 0.0f;
+
+		Plane() = default;
+		Plane(const Vector3f& aNormal, float aDistance) : normal(aNormal), distance(aDistance) {}
+		Plane(const Vector3f& aNormal, const Vector3f& aPoint) : normal(aNormal), distance(-aNormal.Dot(aPoint)) {}
+		Plane(const Vector3f& aPoint0, const Vector3f& aPoint1, const Vector3f& aPoint2);
+		~Plane() = default;
+
+		float GetSignedDistance(const Vector3f& aPoint) const { return normal.Dot(aPoint) + distance; }
+		bool IsInFront(const Vector3f& aPoint) const { return GetSignedDistance(aPoint) >= 0.0f; }
+		Vector3f GetClosestPoint(const Vector3f& aPoint) const { return aPoint - normal * GetSignedDistance(aPoint); }
+
+		// Scales the plane so the normal has unit length, needed for meaningful distances.
+		void Normalize();
+	};
+
+	inline Plane::Plane(const Vector3f& aPoint0, const Vector3f& aPoint1, const Vector3f& aPoint2)
+	{
+		normal = (aPoint1 - aPoint0).Cross(aPoint2 - aPoint0).GetNormalized();
+		distance = -normal.Dot(aPoint0);
+	}
+
+	inline void Plane::Normalize()
+	{
+		const float length = normal.Length();
+		if (length == 0.0f)
+		{
+			return;
+		}
+
+		const float magnitude = 1.0f / length;
+		normal *= magnitude;
+		distance *= magnitude;
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "CommonUtilities/Math/Vector/Vector.h"
+
+namespace CU
+{
+	class Ray
+	{
+	public:
+		Vector3f origin;
+		Vector3f direction = Vector3f::Forward;
+
+		Ray() = default;
+		Ray(const Vector3f& aOrigin, const Vector3f& aDirection) : origin(aOrigin), direction(aDirection.GetNormalized()) {}
+		~Ray() = default;
+
+		static Ray FromPoints(const Vector3f& aFrom, const Vector3f& aTo) { return Ray(aFrom, aTo - aFrom); }
+
+		Vector3f GetPoint(float aDistance) const { return origin + direction * aDistance; }
+
+		// Component wise 1 / direction, used by the slab tests against boxes. Zero components turn into +-infinity.
+		Vector3f GetInverseDirection() const { return { 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z }; }
+	};
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "AABB.h"
+
+namespace CU
+{
+	class Sphere
+	{
+	public:
+		Vector3f center;
+		float radius = 0.0f;
+
+		Sphere() = default;
+		Sphere(const Vector3f& aCenter, float aRadius) : center(aCenter), radius(aRadius) {}
+		~Sphere() = default;
+
+		static Sphere FromAABB(const AABB& aAABB) { return Sphere(aAABB.GetCenter(), aAABB.GetExtents().Length()); }
+
+		bool Contains(const Vector3f& aPoint) const { return Vector3f::DistanceSqr(center, aPoint) <= radius * radius; }
+		bool Intersects(const Sphere& aSphere) const;
+		bool Intersects(const AABB& aAABB) const;
+
+		AABB GetAABB() const { return AABB::FromCenterExtents(center, Vector3f(radius)); }
+	};
+
+	inline bool Sphere::Intersects(const Sphere& aSphere) const
+	{
+		const float radiusSum = radius + aSphere.radius;
+		return Vector3f::DistanceSqr(center, aSphere.center) <= radiusSum * radiusSum;
+	}
+
+	inline bool Sphere::Intersects(const AABB& aAABB) const
+	{
+		return Vector3f::DistanceSqr(center, aAABB.GetClosestPoint(center)) <= radius * radius;
+	}
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <array>
 #include "CommonUtilities/Math/Vector/Vector3.hpp"
+#include "CommonUtilities/Math/SIMD/MatrixSIMD.hpp"
 
 namespace CU
 {
@@ -421,4 +422,14 @@ namespace CU
 	const Matrix3x3<T> Matrix3x3<T>::Zero({ 0, 0, 0, 0, 0, 0, 0, 0, 0 });
 
 	typedef Matrix3x3<float> Matrix3x3f;
+
+#if CU_SIMD_SSE
+	template <>
+	inline Matrix3x3<float> operator*(const Matrix3x3<float>& aMatrix0, const Matrix3x3<float>& aMatrix1)
+	{
+		Matrix3x3<float> result;
+		SIMD::MultiplyMatrix3x3(&aMatrix0[0], &aMatrix1[0], &result[0]);
+		return result;
+	}
+#endif
 }
\ No newline at end of file
@@ -1,9 +1,9 @@
 #pragma once
 #include <array>
 #include <algorithm>
-//#include <dvec.h>
 #include "Matrix3x3.hpp"
 #include "CommonUtilities/Math/CommonMath.hpp"
+#include "CommonUtilities/Math/SIMD/MatrixSIMD.hpp"
 #include "CommonUtilities/Math/Vector/Vector3.hpp"
 #include "CommonUtilities/Math/Vector/Vector4.hpp"
 
@@ -13,7 +13,7 @@ namespace CU
 	class Quaternion;
 
 	template<typename T>
-	class Matrix4x4
+	class alignas(16) Matrix4x4
 	{
 	public:
 		Matrix4x4<T>();
@@ -74,13 +74,6 @@ namespace CU
 		{
 			std::array<T, 16> myData;
 
-			//struct
-			//{
-			//	__m128 m1;
-			//	__m128 m2;
-			//	__m128 m3;
-			//	__m128 m4;
-			//};
 			struct
 			{
 				T m11;
@@ -164,60 +157,6 @@ namespace CU
 	template <class T>
 	Matrix4x4<T> operator*(const Matrix4x4<T>& aMatrix0, const Matrix4x4<T>& aMatrix1)
 	{
-		/*Matrix4x4<float> result;
-		const __m128& m1 = aMatrix1.m1;
-		const __m128& m2 = aMatrix1.m2;
-		const __m128& m3 = aMatrix1.m3;
-		const __m128& m4 = aMatrix1.m4;
-
-		__m128 t1, t2;
-
-		t1 = _mm_set1_ps(aMatrix0.m11);
-		t2 = _mm_mul_ps(m1, t1);
-		t1 = _mm_set1_ps(aMatrix0.m12);
-		t2 = _mm_add_ps(_mm_mul_ps(m2, t1), t2);
-		t1 = _mm_set1_ps(aMatrix0.m13);
-		t2 = _mm_add_ps(_mm_mul_ps(m3, t1), t2);
-		t1 = _mm_set1_ps(aMatrix0.m14);
-		t2 = _mm_add_ps(_mm_mul_ps(m4, t1), t2);
-
-		_mm_store_ps(&result.m11, t2);
-
-		t1 = _mm_set1_ps(aMatrix0.m21);
-		t2 = _mm_mul_ps(m1, t1);
-		t1 = _mm_set1_ps(aMatrix0.m22);
-		t2 = _mm_add_ps(_mm_mul_ps(m2, t1), t2);
-		t1 = _mm_set1_ps(aMatrix0.m23);
-		t2 = _mm_add_ps(_mm_mul_ps(m3, t1), t2);
-		t1 = _mm_set1_ps(aMatrix0.m24);
-		t2 = _mm_add_ps(_mm_mul_ps(m4, t1), t2);
-
-		_mm_store_ps(&result.m21, t2);
-
-		t1 = _mm_set1_ps(aMatrix0.m31);
-		t2 = _mm_mul_ps(m1, t1);
-		t1 = _mm_set1_ps(aMatrix0.m32);
-		t2 = _mm_add_ps(_mm_mul_ps(m2, t1), t2);
-		t1 = _mm_set1_ps(aMatrix0.m33);
-		t2 = _mm_add_ps(_mm_mul_ps(m3, t1), t2);
-		t1 = _mm_set1_ps(aMatrix0.m34);
-		t2 = _mm_add_ps(_mm_mul_ps(m4, t1), t2);
-
-		_mm_store_ps(&result.m31, t2);
-
-		t1 = _mm_set1_ps(aMatrix0.m41);
-		t2 = _mm_mul_ps(m1, t1);
-		t1 = _mm_set1_ps(aMatrix0.m42);
-		t2 = _mm_add_ps(_mm_mul_ps(m2, t1), t2);
-		t1 = _mm_set1_ps(aMatrix0.m43);
-		t2 = _mm_add_ps(_mm_mul_ps(m3, t1), t2);
-		t1 = _mm_set1_ps(aMatrix0.m44);
-		t2 = _mm_add_ps(_mm_mul_ps(m4, t1), t2);
-
-		_mm_store_ps(&result.m41, t2);
-		return result;*/
-
-
 		Matrix4x4<T> result;
 
 		result[0] =
@@ -876,4 +815,92 @@ namespace CU
 	const Matrix4x4<T> Matrix4x4<T>::Identity({ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 });
 
 	typedef Matrix4x4<float> Matrix4x4f;
-}
\ No newline at end of file
+}
+
+#include "CommonUtilities/Math/Quaternion.hpp"
+
+#if CU_SIMD_SSE
+namespace CU
+{
+	// SIMD specializations for Matrix4x4f, see MatrixSIMD.hpp. They produce the same bits as the generic code above,
+	// which remains the fallback for CU_NO_SIMD builds and non-float matrices.
+
+	template <>
+	inline Matrix4x4<float> operator*(const Matrix4x4<float>& aMatrix0, const Matrix4x4<float>& aMatrix1)
+	{
+		Matrix4x4<float> result;
+		SIMD::MultiplyMatrix4x4(&aMatrix0[0], &aMatrix1[0], &result[0]);
+		return result;
+	}
+
+	template <>
+	inline Vector4<float> operator*(const Matrix4x4<float>& aMatrix, const Vector4<float>& aVector)
+	{
+		Vector4<float> result;
+		_mm_storeu_ps(&result.x, SIMD::TransformVector4(&aMatrix[0], _mm_loadu_ps(&aVector.x)));
+		return result;
+	}
+
+	template <>
+	inline Vector4<float> operator*(const Vector4<float>& aVector, const Matrix4x4<float>& aMatrix)
+	{
+		Vector4<float> result;
+		_mm_storeu_ps(&result.x, SIMD::TransformVector4(&aMatrix[0], _mm_loadu_ps(&aVector.x)));
+		return result;
+	}
+
+	template<>
+	inline Matrix4x4<float> Matrix4x4<float>::GetTranspose() const
+	{
+		Matrix4x4<float> result;
+		SIMD::TransposeMatrix4x4(myData.data(), result.myData.data());
+		return result;
+	}
+
+	template<>
+	inline void Matrix4x4<float>::Transpose()
+	{
+		SIMD::TransposeMatrix4x4(myData.data(), myData.data());
+	}
+
+	template<>
+	inline Matrix4x4<float> Matrix4x4<float>::GetInverse() const
+	{
+		Matrix4x4<float> result;
+		if (!SIMD::InverseMatrix4x4(myData.data(), result.myData.data()))
+		{
+			return Matrix4x4<float>::Identity; // Non-invertible matrix
+		}
+
+		return result;
+	}
+
+	template<>
+	inline Matrix4x4<float> Matrix4x4<float>::GetFastInverse() const
+	{
+		Matrix4x4<float> result;
+		SIMD::FastInverseMatrix4x4(myData.data(), result.myData.data());
+		return result;
+	}
+
+	template<>
+	inline void Matrix4x4<float>::Decompose(Vector3<float>& aPosition, Vector3<float>& aRotation, Vector3<float>& aScale) const
+	{
+		aPosition = { m41, m42, m43 };
+
+		Matrix3x3<float> rotationMatrix;
+		SIMD::DecomposeBasis(myData.data(), &rotationMatrix[0], &aScale.x);
+		aRotation = Quaternion<float>(rotationMatrix).GetEulerAngles();
+	}
+
+	template<>
+	inline void Matrix4x4<float>::Decompose(Vector3<float>& aPosition, Quaternion<float>& aOrientaion, Vector3<float>& aScale) const
+	{
+		aPosition = { m41, m42, m43 };
+
+		Matrix3x3<float> rotationMatrix;
+		SIMD::DecomposeBasis(myData.data(), &rotationMatrix[0], &aScale.x);
+		aOrientaion = Quaternion<float>(rotationMatrix);
+	}
+}
+#endif
@@ -1,71 +1,99 @@
 #pragma once
-#include <random>
+#include <vector>
+#include <span>
 #include <cstdint>
+#include "RandomEngine.h"
 #include "Vector/Vector.h"
 
-#define GetRand staticDistribution(staticRandomEngine)
-
 namespace CU
 {
+	// Static access to a per-thread RandomEngine, every thread gets its own randomly seeded stream on first use.
 	class Random
 	{
 	public:
 		Random() = delete;
 		~Random() = delete;
 
+		// Reseeds the calling thread's engine randomly, or with aSeed for reproducible sequences.
 		static void Init()
 		{
-			staticRandomEngine.seed(std::random_device()());
+			GetEngine() = RandomEngine::CreateRandomlySeeded();
+		}
+
+		static void Init(uint64_t aSeed)
+		{
+			GetEngine().Seed(aSeed);
+		}
+
+		static RandomEngine& GetEngine()
+		{
+			static thread_local RandomEngine staticRandomEngine = RandomEngine::CreateRandomlySeeded();
+			return staticRandomEngine;
 		}
 
 		static bool Bool()
 		{
-			return Int() > 0 ? true : false;
+			return GetEngine().NextBool();
 		}
 
 		static int32_t Int()
 		{
-			return GetRand;
+			return static_cast<int32_t>(GetEngine().NextUInt32());
 		}
 
 		static int32_t Int(int32_t aMin, int32_t aMax)
 		{
-			return aMin + (GetRand % (aMax - aMin + 1));
+			return GetEngine().NextInt(aMin, aMax);
 		}
 
 		static uint32_t UInt()
 		{
-			return GetRand;
+			return GetEngine().NextUInt32();
 		}
 
 		static uint32_t UInt(uint32_t aMin, uint32_t aMax)
 		{
-			return aMin + (GetRand % (aMax - aMin + 1));
+			return GetEngine().NextUInt(aMin, aMax);
 		}
 
 		static float Float01()
 		{
-			return (float)GetRand / (float)0xFFFFFFFF;
+			return GetEngine().NextFloat01();
 		}
 
 		static float Float(float aMin, float aMax)
 		{
-			return Float01() * (aMax - aMin) + aMin;
+			return GetEngine().NextFloat(aMin, aMax);
 		}
 
 		static Vector3f Vector3(float aMin, float aMax)
 		{
-			return CU::Vector3f(Float(aMin, aMax), Float(aMin, aMax), Float(aMin, aMax));
+			RandomEngine& engine = GetEngine();
+			const float x = engine.NextFloat(aMin, aMax);
+			const float y = engine.NextFloat(aMin, aMax);
+			const float z = engine.NextFloat(aMin, aMax);
+			return CU::Vector3f(x, y, z);
+		}
+
+		static void FillFloat01(std::span<float> outValues)
+		{
+			GetEngine().FillFloat01(outValues);
+		}
+
+		static void FillFloat(std::span<float> outValues, float aMin, float aMax)
+		{
+			GetEngine().FillFloat(outValues, aMin, aMax);
+		}
+
+		static void FillVector3(std::span<Vector3f> outValues, float aMin, float aMax)
+		{
+			GetEngine().FillVector3(outValues, aMin, aMax);
 		}
 
 		template <typename T>
 		static const T& VectorValue(const std::vector<T>& aVector)
 		{
-			return aVector[UInt(0, aVector.size() - 1)];
+			return aVector[GetEngine().NextBounded(static_cast<uint32_t>(aVector.size()))];
 		}
-
-	private:
-		inline static thread_local std::mt19937 staticRandomEngine;
-		inline static thread_local std::uniform_int_distribution<std::mt19937::result_type> staticDistribution;
 	};
 }
@@ -0,0 +1,191 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+#include "Vector/Vector.h"
+
+namespace CU
+{
+	// xoshiro256++ (https://prng.di.unimi.it/), 32 bytes of state and a handful of cycles per 64-bit draw.
+	// Not thread-safe, give every thread its own engine (CU::Random and Epoch::UUID keep one per thread).
+	// Satisfies UniformRandomBitGenerator, so it also works with the std distributions.
+	class RandomEngine
+	{
+	public:
+		using result_type = uint64_t;
+
+		RandomEngine() : RandomEngine(0x853C49E6748FEA9Bull) {}
+		explicit RandomEngine(uint64_t aSeed) { Seed(aSeed); }
+		~RandomEngine() = default;
+
+		// Seeded from std::random_device, for when a fresh unpredictable stream is wanted.
+		static RandomEngine CreateRandomlySeeded();
+
+		// The state is expanded from the seed with SplitMix64, so similar seeds still give unrelated streams.
+		void Seed(uint64_t aSeed);
+
+		// Advances the engine 2^128 steps, calling it repeatedly on copies of one engine gives non-overlapping streams.
+		void Jump();
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+		result_type operator()() { return NextUInt64(); }
+
+		uint64_t NextUInt64();
+		uint32_t NextUInt32() { return static_cast<uint32_t>(NextUInt64() >> 32); }
+
+		// Unbiased integer in [0, aRange) using Lemire's multiply-shift reduction, aRange 0 returns 0.
+		uint32_t NextBounded(uint32_t aRange);
+		// Unbiased integers in [aMin, aMax], inclusive.
+		int32_t NextInt(int32_t aMin, int32_t aMax);
+		uint32_t NextUInt(uint32_t aMin, uint32_t aMax);
+
+		bool NextBool() { return (NextUInt64() >> 63) != 0; }
+		// Uniform in [0, 1), 24 random mantissa bits.
+		float NextFloat01() { return ToFloat01(NextUInt32()); }
+		float NextFloat(float aMin, float aMax) { return NextFloat01() * (aMax - aMin) + aMin; }
+
+		// Batch versions, every 64-bit draw gives two floats.
+		void FillFloat01(std::span<float> outValues);
+		void FillFloat(std::span<float> outValues, float aMin, float aMax);
+		void FillVector3(std::span<Vector3f> outValues, float aMin, float aMax);
+
+	private:
+		static float ToFloat01(uint32_t aBits) { return static_cast<float>(aBits >> 8) * 0x1.0p-24f; }
+		static uint64_t RotateLeft(uint64_t aValue, int aBits) { return (aValue << aBits) | (aValue >> (64 - aBits)); }
+
+	private:
+		uint64_t myState[4];
+	};
+
+	inline RandomEngine RandomEngine::CreateRandomlySeeded()
+	{
+		std::random_device device;
+		const uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^ device();
+		return RandomEngine(seed);
+	}
+
+	inline void RandomEngine::Seed(uint64_t aSeed)
+	{
+		for (uint64_t& state : myState)
+		{
+			aSeed += 0x9E3779B97F4A7C15ull;
+			uint64_t value = aSeed;
+			value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+			value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+			state = value ^ (value >> 31);
+		}
+	}
+
+	inline void RandomEngine::Jump()
+	{
+		static constexpr uint64_t jumpTable[] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+
+		uint64_t state[4] = {};
+		for (uint64_t jump : jumpTable)
+		{
+			for (int bit = 0; bit < 64; ++bit)
+			{
+				if (jump & (uint64_t(1) << bit))
+				{
+					state[0] ^= myState[0];
+					state[1] ^= myState[1];
+					state[2] ^= myState[2];
+					state[3] ^= myState[3];
+				}
+				NextUInt64();
+			}
+		}
+
+		myState[0] = state[0];
+		myState[1] = state[1];
+		myState[2] = state[2];
+		myState[3] = state[3];
+	}
+
+	inline uint64_t RandomEngine::NextUInt64()
+	{
+		const uint64_t result = RotateLeft(myState[0] + myState[3], 23) + myState[0];
+		const uint64_t t = myState[1] << 17;
+
+		myState[2] ^= myState[0];
+		myState[3] ^= myState[1];
+		myState[1] ^= myState[2];
+		myState[0] ^= myState[3];
+
+		myState[2] ^= t;
+		myState[3] = RotateLeft(myState[3], 45);
+
+		return result;
+	}
+
+	inline uint32_t RandomEngine::NextBounded(uint32_t aRange)
+	{
+		uint64_t product = static_cast<uint64_t>(NextUInt32()) * aRange;
+		uint32_t low = static_cast<uint32_t>(product);
+
+		// Only draws landing in the first (2^32 % aRange) values of a bucket are rejected, the modulo is rarely needed.
+		if (low < aRange)
+		{
+			const uint32_t threshold = (0u - aRange) % aRange;
+			while (low < threshold)
+			{
+				product = static_cast<uint64_t>(NextUInt32()) * aRange;
+				low = static_cast<uint32_t>(product);
+			}
+		}
+
+		return static_cast<uint32_t>(product >> 32);
+	}
+
+	inline int32_t RandomEngine::NextInt(int32_t aMin, int32_t aMax)
+	{
+		return static_cast<int32_t>(NextUInt(static_cast<uint32_t>(aMin), static_cast<uint32_t>(aMax)));
+	}
+
+	inline uint32_t RandomEngine::NextUInt(uint32_t aMin, uint32_t aMax)
+	{
+		// Wraps to 0 for the full 32-bit range, which needs no reduction.
+		const uint32_t range = aMax - aMin + 1;
+		return aMin + (range == 0 ? NextUInt32() : NextBounded(range));
+	}
+
+	inline void RandomEngine::FillFloat01(std::span<float> outValues)
+	{
+		size_t i = 0;
+		for (; i + 2 <= outValues.size(); i += 2)
+		{
+			const uint64_t bits = NextUInt64();
+			outValues[i + 0] = ToFloat01(static_cast<uint32_t>(bits >> 32));
+			outValues[i + 1] = ToFloat01(static_cast<uint32_t>(bits));
+		}
+
+		if (i < outValues.size())
+		{
+			outValues[i] = NextFloat01();
+		}
+	}
+
+	inline void RandomEngine::FillFloat(std::span<float> outValues, float aMin, float aMax)
+	{
+		FillFloat01(outValues);
+
+		const float range = aMax - aMin;
+		for (float& value : outValues)
+		{
+			value = value * range + aMin;
+		}
+	}
+
+	inline void RandomEngine::FillVector3(std::span<Vector3f> outValues, float aMin, float aMax)
+	{
+		static_assert(sizeof(Vector3f) == sizeof(float) * 3);
+		if (outValues.empty())
+		{
+			return;
+		}
+
+		FillFloat(std::span<float>(&outValues.data()->x, outValues.size() * 3), aMin, aMax);
+	}
+}
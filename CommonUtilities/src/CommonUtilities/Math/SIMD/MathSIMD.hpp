@@ -0,0 +1,303 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include "SIMD.h"
+
+#if CU_SIMD_SSE
+
+// Vectorized transcendental kernels, written once against a lane abstraction so the SSE (Float4) and AVX2 (Float8) versions are the same code.
+// The polynomials are the single precision Cephes ones. Multiplies and adds are never fused, so both widths give the same bits for the same input.
+// Max errors were measured against double precision std functions (see CommonMathBatch.h for the numbers).
+
+namespace CU::SIMD
+{
+	struct Float4
+	{
+		using Register = __m128;
+		using IntRegister = __m128i;
+		static constexpr size_t Width = 4;
+
+		static Register Load(const float* aData) { return _mm_loadu_ps(aData); }
+		static void Store(float* outData, Register aValue) { _mm_storeu_ps(outData, aValue); }
+		static Register Set(float aValue) { return _mm_set1_ps(aValue); }
+		static IntRegister SetInt(int32_t aValue) { return _mm_set1_epi32(aValue); }
+
+		static Register Add(Register aA, Register aB) { return _mm_add_ps(aA, aB); }
+		static Register Sub(Register aA, Register aB) { return _mm_sub_ps(aA, aB); }
+		static Register Mul(Register aA, Register aB) { return _mm_mul_ps(aA, aB); }
+		static Register Div(Register aA, Register aB) { return _mm_div_ps(aA, aB); }
+		static Register Min(Register aA, Register aB) { return _mm_min_ps(aA, aB); }
+		static Register Max(Register aA, Register aB) { return _mm_max_ps(aA, aB); }
+		static Register RSqrtEstimate(Register aValue) { return _mm_rsqrt_ps(aValue); }
+
+		static Register And(Register aA, Register aB) { return _mm_and_ps(aA, aB); }
+		static Register AndNot(Register aMask, Register aValue) { return _mm_andnot_ps(aMask, aValue); }
+		static Register Or(Register aA, Register aB) { return _mm_or_ps(aA, aB); }
+		static Register Xor(Register aA, Register aB) { return _mm_xor_ps(aA, aB); }
+		static Register Select(Register aMask, Register aTrue, Register aFalse) { return _mm_or_ps(_mm_and_ps(aMask, aTrue), _mm_andnot_ps(aMask, aFalse)); }
+
+		static Register CmpEq(Register aA, Register aB) { return _mm_cmpeq_ps(aA, aB); }
+		static Register CmpLt(Register aA, Register aB) { return _mm_cmplt_ps(aA, aB); }
+		static Register CmpLe(Register aA, Register aB) { return _mm_cmple_ps(aA, aB); }
+		static Register CmpGt(Register aA, Register aB) { return _mm_cmpgt_ps(aA, aB); }
+		static Register CmpUnordered(Register aA, Register aB) { return _mm_cmpunord_ps(aA, aB); }
+		static bool Any(Register aMask) { return _mm_movemask_ps(aMask) != 0; }
+
+		static IntRegister Round(Register aValue) { return _mm_cvtps_epi32(aValue); }
+		static IntRegister Truncate(Register aValue) { return _mm_cvttps_epi32(aValue); }
+		static Register ToFloat(IntRegister aValue) { return _mm_cvtepi32_ps(aValue); }
+		static IntRegister AsInt(Register aValue) { return _mm_castps_si128(aValue); }
+		static Register AsFloat(IntRegister aValue) { return _mm_castsi128_ps(aValue); }
+
+		static IntRegister AddInt(IntRegister aA, IntRegister aB) { return _mm_add_epi32(aA, aB); }
+		static IntRegister SubInt(IntRegister aA, IntRegister aB) { return _mm_sub_epi32(aA, aB); }
+		static IntRegister AndInt(IntRegister aA, IntRegister aB) { return _mm_and_si128(aA, aB); }
+		static IntRegister AndNotInt(IntRegister aMask, IntRegister aValue) { return _mm_andnot_si128(aMask, aValue); }
+		static IntRegister OrInt(IntRegister aA, IntRegister aB) { return _mm_or_si128(aA, aB); }
+		static IntRegister CmpEqInt(IntRegister aA, IntRegister aB) { return _mm_cmpeq_epi32(aA, aB); }
+		template<int Bits> static IntRegister ShiftLeft(IntRegister aValue) { return _mm_slli_epi32(aValue, Bits); }
+		template<int Bits> static IntRegister ShiftRight(IntRegister aValue) { return _mm_srli_epi32(aValue, Bits); }
+		template<int Bits> static IntRegister ShiftRightArithmetic(IntRegister aValue) { return _mm_srai_epi32(aValue, Bits); }
+	};
+
+#if CU_SIMD_AVX2
+	struct Float8
+	{
+		using Register = __m256;
+		using IntRegister = __m256i;
+		static constexpr size_t Width = 8;
+
+		static Register Load(const float* aData) { return _mm256_loadu_ps(aData); }
+		static void Store(float* outData, Register aValue) { _mm256_storeu_ps(outData, aValue); }
+		static Register Set(float aValue) { return _mm256_set1_ps(aValue); }
+		static IntRegister SetInt(int32_t aValue) { return _mm256_set1_epi32(aValue); }
+
+		static Register Add(Register aA, Register aB) { return _mm256_add_ps(aA, aB); }
+		static Register Sub(Register aA, Register aB) { return _mm256_sub_ps(aA, aB); }
+		static Register Mul(Register aA, Register aB) { return _mm256_mul_ps(aA, aB); }
+		static Register Div(Register aA, Register aB) { return _mm256_div_ps(aA, aB); }
+		static Register Min(Register aA, Register aB) { return _mm256_min_ps(aA, aB); }
+		static Register Max(Register aA, Register aB) { return _mm256_max_ps(aA, aB); }
+		static Register RSqrtEstimate(Register aValue) { return _mm256_rsqrt_ps(aValue); }
+
+		static Register And(Register aA, Register aB) { return _mm256_and_ps(aA, aB); }
+		static Register AndNot(Register aMask, Register aValue) { return _mm256_andnot_ps(aMask, aValue); }
+		static Register Or(Register aA, Register aB) { return _mm256_or_ps(aA, aB); }
+		static Register Xor(Register aA, Register aB) { return _mm256_xor_ps(aA, aB); }
+		static Register Select(Register aMask, Register aTrue, Register aFalse) { return _mm256_blendv_ps(aFalse, aTrue, aMask); }
+
+		static Register CmpEq(Register aA, Register aB) { return _mm256_cmp_ps(aA, aB, _CMP_EQ_OQ); }
+		static Register CmpLt(Register aA, Register aB) { return _mm256_cmp_ps(aA, aB, _CMP_LT_OS); }
+		static Register CmpLe(Register aA, Register aB) { return _mm256_cmp_ps(aA, aB, _CMP_LE_OS); }
+		static Register CmpGt(Register aA, Register aB) { return _mm256_cmp_ps(aA, aB, _CMP_GT_OS); }
+		static Register CmpUnordered(Register aA, Register aB) { return _mm256_cmp_ps(aA, aB, _CMP_UNORD_Q); }
+		static bool Any(Register aMask) { return _mm256_movemask_ps(aMask) != 0; }
+
+		static IntRegister Round(Register aValue) { return _mm256_cvtps_epi32(aValue); }
+		static IntRegister Truncate(Register aValue) { return _mm256_cvttps_epi32(aValue); }
+		static Register ToFloat(IntRegister aValue) { return _mm256_cvtepi32_ps(aValue); }
+		static IntRegister AsInt(Register aValue) { return _mm256_castps_si256(aValue); }
+		static Register AsFloat(IntRegister aValue) { return _mm256_castsi256_ps(aValue); }
+
+		static IntRegister AddInt(IntRegister aA, IntRegister aB) { return _mm256_add_epi32(aA, aB); }
+		static IntRegister SubInt(IntRegister aA, IntRegister aB) { return _mm256_sub_epi32(aA, aB); }
+		static IntRegister AndInt(IntRegister aA, IntRegister aB) { return _mm256_and_si256(aA, aB); }
+		static IntRegister AndNotInt(IntRegister aMask, IntRegister aValue) { return _mm256_andnot_si256(aMask, aValue); }
+		static IntRegister OrInt(IntRegister aA, IntRegister aB) { return _mm256_or_si256(aA, aB); }
+		static IntRegister CmpEqInt(IntRegister aA, IntRegister aB) { return _mm256_cmpeq_epi32(aA, aB); }
+		template<int Bits> static IntRegister ShiftLeft(IntRegister aValue) { return _mm256_slli_epi32(aValue, Bits); }
+		template<int Bits> static IntRegister ShiftRight(IntRegister aValue) { return _mm256_srli_epi32(aValue, Bits); }
+		template<int Bits> static IntRegister ShiftRightArithmetic(IntRegister aValue) { return _mm256_srai_epi32(aValue, Bits); }
+	};
+#endif
+
+	// Sine and cosine together, they share the range reduction. Accurate for |x| <= 8192, the reduction loses precision above that.
+	template<typename Lanes>
+	CU_FORCEINLINE void SinCos(typename Lanes::Register aAngle, typename Lanes::Register& outSin, typename Lanes::Register& outCos)
+	{
+		using Register = typename Lanes::Register;
+		using IntRegister = typename Lanes::IntRegister;
+
+		const Register signMask = Lanes::Set(-0.0f);
+		Register sinSign = Lanes::And(aAngle, signMask);
+		Register x = Lanes::AndNot(signMask, aAngle);
+
+		// Octant of the angle, rounded up to even so the remainder is in [-Pi/4, Pi/4]
+		IntRegister octant = Lanes::Truncate(Lanes::Mul(x, Lanes::Set(1.27323954473516f)));
+		octant = Lanes::AndInt(Lanes::AddInt(octant, Lanes::SetInt(1)), Lanes::SetInt(~1));
+		const Register octantFloat = Lanes::ToFloat(octant);
+
+		// Extended precision Pi/4 in three parts (Cody-Waite)
+		x = Lanes::Sub(x, Lanes::Mul(octantFloat, Lanes::Set(0.78515625f)));
+		x = Lanes::Sub(x, Lanes::Mul(octantFloat, Lanes::Set(2.4187564849853515625e-4f)));
+		x = Lanes::Sub(x, Lanes::Mul(octantFloat, Lanes::Set(3.77489497744594108e-8f)));
+
+		sinSign = Lanes::Xor(sinSign, Lanes::AsFloat(Lanes::template ShiftLeft<29>(Lanes::AndInt(octant, Lanes::SetInt(4)))));
+		const Register cosSign = Lanes::AsFloat(Lanes::template ShiftLeft<29>(Lanes::AndNotInt(Lanes::SubInt(octant, Lanes::SetInt(2)), Lanes::SetInt(4))));
+		const Register useSinPolynomial = Lanes::AsFloat(Lanes::CmpEqInt(Lanes::AndInt(octant, Lanes::SetInt(2)), Lanes::SetInt(0)));
+
+		const Register z = Lanes::Mul(x, x);
+
+		Register cosPolynomial = Lanes::Set(2.443315711809948e-5f);
+		cosPolynomial = Lanes::Add(Lanes::Mul(cosPolynomial, z), Lanes::Set(-1.388731625493765e-3f));
+		cosPolynomial = Lanes::Add(Lanes::Mul(cosPolynomial, z), Lanes::Set(4.166664568298827e-2f));
+		cosPolynomial = Lanes::Mul(Lanes::Mul(cosPolynomial, z), z);
+		cosPolynomial = Lanes::Sub(cosPolynomial, Lanes::Mul(z, Lanes::Set(0.5f)));
+		cosPolynomial = Lanes::Add(cosPolynomial, Lanes::Set(1.0f));
+
+		Register sinPolynomial = Lanes::Set(-1.9515295891e-4f);
+		sinPolynomial = Lanes::Add(Lanes::Mul(sinPolynomial, z), Lanes::Set(8.3321608736e-3f));
+		sinPolynomial = Lanes::Add(Lanes::Mul(sinPolynomial, z), Lanes::Set(-1.6666654611e-1f));
+		sinPolynomial = Lanes::Add(Lanes::Mul(Lanes::Mul(sinPolynomial, z), x), x);
+
+		outSin = Lanes::Xor(Lanes::Select(useSinPolynomial, sinPolynomial, cosPolynomial), sinSign);
+		outCos = Lanes::Xor(Lanes::Select(useSinPolynomial, cosPolynomial, sinPolynomial), cosSign);
+	}
+
+	// Hardware estimate plus one Newton-Raphson step. 0 gives +inf and +inf gives 0.
+	template<typename Lanes>
+	CU_FORCEINLINE typename Lanes::Register RSqrt(typename Lanes::Register aValue)
+	{
+		using Register = typename Lanes::Register;
+
+		auto refine = [](Register aX)
+			{
+				const Register estimate = Lanes::RSqrtEstimate(aX);
+				const Register halfValueEstimate = Lanes::Mul(Lanes::Mul(aX, Lanes::Set(0.5f)), estimate);
+				const Register refined = Lanes::Mul(estimate, Lanes::Sub(Lanes::Set(1.5f), Lanes::Mul(halfValueEstimate, estimate)));
+
+				// The step turns the exact 0 and inf estimates into NaN
+				const Register isExact = Lanes::Or(Lanes::CmpEq(aX, Lanes::Set(0.0f)), Lanes::CmpEq(estimate, Lanes::Set(0.0f)));
+				return Lanes::Select(isExact, estimate, refined);
+			};
+
+		// The estimate treats denormals as 0 and gives inf. They're scaled by 2^24 into the normal range and the result by 2^12 back,
+		// only in the rare registers that have one.
+		const Register isDenormal = Lanes::And(Lanes::CmpGt(aValue, Lanes::Set(0.0f)), Lanes::CmpLt(aValue, Lanes::Set(1.17549435e-38f)));
+		if (!Lanes::Any(isDenormal))
+		{
+			return refine(aValue);
+		}
+
+		const Register result = refine(Lanes::Select(isDenormal, Lanes::Mul(aValue, Lanes::Set(16777216.0f)), aValue));
+		return Lanes::Select(isDenormal, Lanes::Mul(result, Lanes::Set(4096.0f)), result);
+	}
+
+	// Same quadrants and signed zero handling as std::atan2. Both inputs infinite gives NaN.
+	template<typename Lanes>
+	CU_FORCEINLINE typename Lanes::Register Atan2(typename Lanes::Register aY, typename Lanes::Register aX)
+	{
+		using Register = typename Lanes::Register;
+
+		const Register signMask = Lanes::Set(-0.0f);
+		const Register absY = Lanes::AndNot(signMask, aY);
+		const Register absX = Lanes::AndNot(signMask, aX);
+
+		// atan of min/max in [0, 1], then mirrored into the right octant
+		const Register numerator = Lanes::Min(absY, absX);
+		const Register denominator = Lanes::Max(absY, absX);
+		Register t = Lanes::Div(numerator, denominator);
+		t = Lanes::AndNot(Lanes::CmpEq(denominator, Lanes::Set(0.0f)), t);
+
+		// Above tan(Pi/8) the argument is reduced with atan(t) = Pi/4 + atan((t - 1) / (t + 1))
+		const Register isReduced = Lanes::CmpGt(t, Lanes::Set(0.4142135623730950f));
+		t = Lanes::Select(isReduced, Lanes::Div(Lanes::Sub(t, Lanes::Set(1.0f)), Lanes::Add(t, Lanes::Set(1.0f))), t);
+		const Register offset = Lanes::And(isReduced, Lanes::Set(0.78539816339744830962f));
+
+		const Register z = Lanes::Mul(t, t);
+		Register result = Lanes::Set(8.05374449538e-2f);
+		result = Lanes::Add(Lanes::Mul(result, z), Lanes::Set(-1.38776856032e-1f));
+		result = Lanes::Add(Lanes::Mul(result, z), Lanes::Set(1.99777106478e-1f));
+		result = Lanes::Add(Lanes::Mul(result, z), Lanes::Set(-3.33329491539e-1f));
+		result = Lanes::Add(Lanes::Mul(Lanes::Mul(result, z), t), t);
+		result = Lanes::Add(result, offset);
+
+		// Negative x goes by the sign bit, so -0 gives Pi like std::atan2
+		const Register isXNegative = Lanes::AsFloat(Lanes::template ShiftRightArithmetic<31>(Lanes::AsInt(aX)));
+		result = Lanes::Select(Lanes::CmpGt(absY, absX), Lanes::Sub(Lanes::Set(1.57079632679489661923f), result), result);
+		result = Lanes::Select(isXNegative, Lanes::Sub(Lanes::Set(3.14159265358979323846f), result), result);
+		result = Lanes::Or(result, Lanes::And(aY, signMask));
+
+		// Min/max drop NaN, so it's put back here
+		return Lanes::Select(Lanes::CmpUnordered(aY, aX), Lanes::Add(aY, aX), result);
+	}
+
+	// Overflows to +inf above ~88.72, underflows through the denormals to 0 below ~-103.97, NaN stays NaN.
+	template<typename Lanes>
+	CU_FORCEINLINE typename Lanes::Register Exp(typename Lanes::Register aValue)
+	{
+		using Register = typename Lanes::Register;
+		using IntRegister = typename Lanes::IntRegister;
+
+		// The value is the second operand so min/max pass NaN through
+		Register x = Lanes::Min(Lanes::Set(88.8f), Lanes::Max(Lanes::Set(-104.0f), aValue));
+
+		// x = n * ln(2) + r, with ln(2) in two parts so r is exact
+		const IntRegister n = Lanes::Round(Lanes::Mul(x, Lanes::Set(1.44269504088896341f)));
+		const Register nFloat = Lanes::ToFloat(n);
+		x = Lanes::Sub(x, Lanes::Mul(nFloat, Lanes::Set(0.693359375f)));
+		x = Lanes::Sub(x, Lanes::Mul(nFloat, Lanes::Set(-2.12194440e-4f)));
+
+		const Register z = Lanes::Mul(x, x);
+		Register result = Lanes::Set(1.9875691500e-4f);
+		result = Lanes::Add(Lanes::Mul(result, x), Lanes::Set(1.3981999507e-3f));
+		result = Lanes::Add(Lanes::Mul(result, x), Lanes::Set(8.3334519073e-3f));
+		result = Lanes::Add(Lanes::Mul(result, x), Lanes::Set(4.1665795894e-2f));
+		result = Lanes::Add(Lanes::Mul(result, x), Lanes::Set(1.6666665459e-1f));
+		result = Lanes::Add(Lanes::Mul(result, x), Lanes::Set(5.0000001201e-1f));
+		result = Lanes::Add(Lanes::Add(Lanes::Mul(result, z), x), Lanes::Set(1.0f));
+
+		// 2^n in two factors, n covers [-150, 128] which doesn't fit a single float exponent
+		const IntRegister half = Lanes::template ShiftRightArithmetic<1>(n);
+		const Register scale0 = Lanes::AsFloat(Lanes::template ShiftLeft<23>(Lanes::AddInt(half, Lanes::SetInt(127))));
+		const Register scale1 = Lanes::AsFloat(Lanes::template ShiftLeft<23>(Lanes::AddInt(Lanes::SubInt(n, half), Lanes::SetInt(127))));
+		return Lanes::Mul(Lanes::Mul(result, scale0), scale1);
+	}
+
+	// Natural logarithm. 0 gives -inf, negative values NaN, +inf stays +inf. Denormal inputs are handled.
+	template<typename Lanes>
+	CU_FORCEINLINE typename Lanes::Register Log(typename Lanes::Register aValue)
+	{
+		using Register = typename Lanes::Register;
+		using IntRegister = typename Lanes::IntRegister;
+
+		// Denormals are scaled into the normal range first
+		const Register isDenormal = Lanes::CmpLt(aValue, Lanes::Set(1.17549435e-38f));
+		Register x = Lanes::Select(isDenormal, Lanes::Mul(aValue, Lanes::Set(8388608.0f)), aValue);
+		const Register exponentBias = Lanes::Select(isDenormal, Lanes::Set(126.0f + 23.0f), Lanes::Set(126.0f));
+
+		// x = m * 2^e with m in [0.5, 1)
+		const IntRegister bits = Lanes::AsInt(x);
+		Register e = Lanes::Sub(Lanes::ToFloat(Lanes::template ShiftRight<23>(bits)), exponentBias);
+		x = Lanes::AsFloat(Lanes::OrInt(Lanes::AndInt(bits, Lanes::SetInt(0x007FFFFF)), Lanes::SetInt(0x3F000000)));
+
+		// Moved to [sqrt(0.5), sqrt(2)) - 1 so the polynomial stays small
+		const Register isSmall = Lanes::CmpLt(x, Lanes::Set(0.707106781186547524f));
+		e = Lanes::Sub(e, Lanes::And(isSmall, Lanes::Set(1.0f)));
+		x = Lanes::Sub(Lanes::Add(x, Lanes::And(isSmall, x)), Lanes::Set(1.0f));
+
+		const Register z = Lanes::Mul(x, x);
+		Register result = Lanes::Set(7.0376836292e-2f);
+		result = Lanes::Add(Lanes::Mul(result, x), Lanes::Set(-1.1514610310e-1f));
+		result = Lanes::Add(Lanes::Mul(result, x), Lanes::Set(1.1676998740e-1f));
+		result = Lanes::Add(Lanes::Mul(result, x), Lanes::Set(-1.2420140846e-1f));
+		result = Lanes::Add(Lanes::Mul(result, x), Lanes::Set(1.4249322787e-1f));
+		result = Lanes::Add(Lanes::Mul(result, x), Lanes::Set(-1.6668057665e-1f));
+		result = Lanes::Add(Lanes::Mul(result, x), Lanes::Set(2.0000714765e-1f));
+		result = Lanes::Add(Lanes::Mul(result, x), Lanes::Set(-2.4999993993e-1f));
+		result = Lanes::Add(Lanes::Mul(result, x), Lanes::Set(3.3333331174e-1f));
+		result = Lanes::Mul(Lanes::Mul(result, x), z);
+
+		result = Lanes::Add(result, Lanes::Mul(e, Lanes::Set(-2.12194440e-4f)));
+		result = Lanes::Sub(result, Lanes::Mul(z, Lanes::Set(0.5f)));
+		result = Lanes::Add(Lanes::Add(x, result), Lanes::Mul(e, Lanes::Set(0.693359375f)));
+
+		const Register zero = Lanes::Set(0.0f);
+		const Register infinity = Lanes::Set(std::numeric_limits<float>::infinity());
+		result = Lanes::Select(Lanes::CmpEq(aValue, infinity), infinity, result);
+		result = Lanes::Select(Lanes::CmpEq(aValue, zero), Lanes::Set(-std::numeric_limits<float>::infinity()), result);
+		return Lanes::Select(Lanes::Or(Lanes::CmpLt(aValue, zero), Lanes::CmpUnordered(aValue, aValue)), Lanes::Set(std::numeric_limits<float>::quiet_NaN()), result);
+	}
+}
+
+#endif
@@ -0,0 +1,258 @@
+#pragma once
+#include <cstdint>
+#include "SIMD.h"
+
+#if CU_SIMD_SSE
+
+// Kernels backing the float specializations of Matrix3x3/Matrix4x4.
+// Matrices are row-major float arrays, same layout as the matrix classes.
+// Every kernel issues its multiplies and adds in the same order as the scalar code (and never uses FMA),
+// so the results are bit-exact with the generic implementation.
+
+namespace CU::SIMD
+{
+	CU_FORCEINLINE __m128 Negate(__m128 aValue)
+	{
+		return _mm_xor_ps(aValue, _mm_set1_ps(-0.0f));
+	}
+
+	CU_FORCEINLINE void MultiplyMatrix4x4(const float* aLhs, const float* aRhs, float* outResult)
+	{
+#if CU_SIMD_AVX2
+		const __m256 row0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(aRhs + 0));
+		const __m256 row1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(aRhs + 4));
+		const __m256 row2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(aRhs + 8));
+		const __m256 row3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(aRhs + 12));
+
+		// Two result rows per iteration, one in each 128-bit lane.
+		for (int i = 0; i < 16; i += 8)
+		{
+			const __m256 lhs = _mm256_loadu_ps(aLhs + i);
+
+			__m256 result = _mm256_mul_ps(_mm256_shuffle_ps(lhs, lhs, _MM_SHUFFLE(0, 0, 0, 0)), row0);
+			result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_shuffle_ps(lhs, lhs, _MM_SHUFFLE(1, 1, 1, 1)), row1));
+			result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_shuffle_ps(lhs, lhs, _MM_SHUFFLE(2, 2, 2, 2)), row2));
+			result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_shuffle_ps(lhs, lhs, _MM_SHUFFLE(3, 3, 3, 3)), row3));
+
+			_mm256_storeu_ps(outResult + i, result);
+		}
+#else
+		const __m128 row0 = _mm_loadu_ps(aRhs + 0);
+		const __m128 row1 = _mm_loadu_ps(aRhs + 4);
+		const __m128 row2 = _mm_loadu_ps(aRhs + 8);
+		const __m128 row3 = _mm_loadu_ps(aRhs + 12);
+
+		for (int i = 0; i < 16; i += 4)
+		{
+			const __m128 lhs = _mm_loadu_ps(aLhs + i);
+
+			__m128 result = _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(0, 0, 0, 0)), row0);
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(1, 1, 1, 1)), row1));
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(2, 2, 2, 2)), row2));
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(3, 3, 3, 3)), row3));
+
+			_mm_storeu_ps(outResult + i, result);
+		}
+#endif
+	}
+
+	CU_FORCEINLINE __m128 TransformVector4(const float* aMatrix, __m128 aVector)
+	{
+		__m128 result = _mm_mul_ps(_mm_shuffle_ps(aVector, aVector, _MM_SHUFFLE(0, 0, 0, 0)), _mm_loadu_ps(aMatrix + 0));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(aVector, aVector, _MM_SHUFFLE(1, 1, 1, 1)), _mm_loadu_ps(aMatrix + 4)));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(aVector, aVector, _MM_SHUFFLE(2, 2, 2, 2)), _mm_loadu_ps(aMatrix + 8)));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(aVector, aVector, _MM_SHUFFLE(3, 3, 3, 3)), _mm_loadu_ps(aMatrix + 12)));
+		return result;
+	}
+
+	CU_FORCEINLINE void TransposeMatrix4x4(const float* aMatrix, float* outResult)
+	{
+		__m128 row0 = _mm_loadu_ps(aMatrix + 0);
+		__m128 row1 = _mm_loadu_ps(aMatrix + 4);
+		__m128 row2 = _mm_loadu_ps(aMatrix + 8);
+		__m128 row3 = _mm_loadu_ps(aMatrix + 12);
+
+		_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+		_mm_storeu_ps(outResult + 0, row0);
+		_mm_storeu_ps(outResult + 4, row1);
+		_mm_storeu_ps(outResult + 8, row2);
+		_mm_storeu_ps(outResult + 12, row3);
+	}
+
+	CU_FORCEINLINE void FastInverseMatrix4x4(const float* aMatrix, float* outResult)
+	{
+		__m128 col0 = _mm_loadu_ps(aMatrix + 0);
+		__m128 col1 = _mm_loadu_ps(aMatrix + 4);
+		__m128 col2 = _mm_loadu_ps(aMatrix + 8);
+		__m128 col3 = _mm_loadu_ps(aMatrix + 12);
+		const __m128 translation = Negate(col3);
+
+		_MM_TRANSPOSE4_PS(col0, col1, col2, col3);
+
+		const __m128 xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+		const __m128 row0 = _mm_and_ps(col0, xyzMask);
+		const __m128 row1 = _mm_and_ps(col1, xyzMask);
+		const __m128 row2 = _mm_and_ps(col2, xyzMask);
+
+		__m128 row3 = _mm_mul_ps(_mm_shuffle_ps(translation, translation, _MM_SHUFFLE(0, 0, 0, 0)), row0);
+		row3 = _mm_add_ps(row3, _mm_mul_ps(_mm_shuffle_ps(translation, translation, _MM_SHUFFLE(1, 1, 1, 1)), row1));
+		row3 = _mm_add_ps(row3, _mm_mul_ps(_mm_shuffle_ps(translation, translation, _MM_SHUFFLE(2, 2, 2, 2)), row2));
+
+		// col3 holds (m14, m24, m34, m44) after the transpose, m44 is kept as is.
+		row3 = _mm_or_ps(_mm_and_ps(xyzMask, row3), _mm_andnot_ps(xyzMask, col3));
+
+		_mm_storeu_ps(outResult + 0, row0);
+		_mm_storeu_ps(outResult + 4, row1);
+		_mm_storeu_ps(outResult + 8, row2);
+		_mm_storeu_ps(outResult + 12, row3);
+	}
+
+	// Writes the normalized right/up/forward rows of aMatrix into a 3x3 matrix and their lengths into outScale.
+	CU_FORCEINLINE void DecomposeBasis(const float* aMatrix, float* outRotation3x3, float* outScale)
+	{
+		__m128 xs = _mm_loadu_ps(aMatrix + 0);
+		__m128 ys = _mm_loadu_ps(aMatrix + 4);
+		__m128 zs = _mm_loadu_ps(aMatrix + 8);
+		__m128 ws = _mm_loadu_ps(aMatrix + 12);
+
+		_MM_TRANSPOSE4_PS(xs, ys, zs, ws);
+
+		__m128 lengthSqr = _mm_mul_ps(xs, xs);
+		lengthSqr = _mm_add_ps(lengthSqr, _mm_mul_ps(ys, ys));
+		lengthSqr = _mm_add_ps(lengthSqr, _mm_mul_ps(zs, zs));
+		const __m128 length = _mm_sqrt_ps(lengthSqr);
+
+		// Vector3::GetNormalized returns zero for a zero vector instead of dividing by zero.
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 isZero = _mm_and_ps(_mm_and_ps(_mm_cmpeq_ps(xs, zero), _mm_cmpeq_ps(ys, zero)), _mm_cmpeq_ps(zs, zero));
+		const __m128 magnitude = _mm_div_ps(_mm_set1_ps(1.0f), length);
+
+		__m128 right = _mm_andnot_ps(isZero, _mm_mul_ps(xs, magnitude));
+		__m128 up = _mm_andnot_ps(isZero, _mm_mul_ps(ys, magnitude));
+		__m128 forward = _mm_andnot_ps(isZero, _mm_mul_ps(zs, magnitude));
+		__m128 unused = zero;
+
+		_MM_TRANSPOSE4_PS(right, up, forward, unused);
+
+		alignas(16) float rows[12];
+		_mm_store_ps(rows + 0, right);
+		_mm_store_ps(rows + 4, up);
+		_mm_store_ps(rows + 8, forward);
+
+		for (int row = 0; row < 3; ++row)
+		{
+			outRotation3x3[row * 3 + 0] = rows[row * 4 + 0];
+			outRotation3x3[row * 3 + 1] = rows[row * 4 + 1];
+			outRotation3x3[row * 3 + 2] = rows[row * 4 + 2];
+		}
+
+		alignas(16) float lengths[4];
+		_mm_store_ps(lengths, length);
+		outScale[0] = lengths[0];
+		outScale[1] = lengths[1];
+		outScale[2] = lengths[2];
+	}
+
+	CU_FORCEINLINE void MultiplyMatrix3x3(const float* aLhs, const float* aRhs, float* outResult)
+	{
+		const __m128 row0 = _mm_loadu_ps(aRhs + 0);
+		const __m128 row1 = _mm_loadu_ps(aRhs + 3);
+		const __m128 row2 = _mm_setr_ps(aRhs[6], aRhs[7], aRhs[8], 0.0f);
+
+		alignas(16) float result[12];
+		for (int i = 0; i < 3; ++i)
+		{
+			__m128 value = _mm_mul_ps(_mm_set1_ps(aLhs[i * 3 + 0]), row0);
+			value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(aLhs[i * 3 + 1]), row1));
+			value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(aLhs[i * 3 + 2]), row2));
+			_mm_store_ps(result + i * 4, value);
+		}
+
+		for (int i = 0; i < 3; ++i)
+		{
+			outResult[i * 3 + 0] = result[i * 4 + 0];
+			outResult[i * 3 + 1] = result[i * 4 + 1];
+			outResult[i * 3 + 2] = result[i * 4 + 2];
+		}
+	}
+
+	// Cofactor expansion from Matrix4x4::GetInverse, one inverse row per register.
+	// Every element is  A0*B0*C0 - A0*B1*C1 - A1*B2*C2 + A1*B3*C3 + A2*B4*C4 - A2*B5*C5  with a checkerboard sign on top,
+	// where the operands are one of three fixed shuffles of a matrix column.
+	// Returns false if the matrix isn't invertible, outResult is left unspecified in that case.
+	inline bool InverseMatrix4x4(const float* aMatrix, float* outResult)
+	{
+		__m128 col0 = _mm_loadu_ps(aMatrix + 0);
+		__m128 col1 = _mm_loadu_ps(aMatrix + 4);
+		__m128 col2 = _mm_loadu_ps(aMatrix + 8);
+		__m128 col3 = _mm_loadu_ps(aMatrix + 12);
+
+		_MM_TRANSPOSE4_PS(col0, col1, col2, col3);
+
+		struct Operands { __m128 s1, s2, s3; };
+		auto shuffle = [](__m128 aColumn) -> Operands
+			{
+				return
+				{
+					_mm_shuffle_ps(aColumn, aColumn, _MM_SHUFFLE(0, 0, 0, 1)),
+					_mm_shuffle_ps(aColumn, aColumn, _MM_SHUFFLE(1, 1, 2, 2)),
+					_mm_shuffle_ps(aColumn, aColumn, _MM_SHUFFLE(2, 3, 3, 3))
+				};
+			};
+
+		const Operands c0 = shuffle(col0);
+		const Operands c1 = shuffle(col1);
+		const Operands c2 = shuffle(col2);
+		const Operands c3 = shuffle(col3);
+
+		const __m128 evenSign = _mm_castsi128_ps(_mm_setr_epi32(0, INT32_MIN, 0, INT32_MIN));
+		const __m128 oddSign = _mm_castsi128_ps(_mm_setr_epi32(INT32_MIN, 0, INT32_MIN, 0));
+
+		// The sign is applied to every term before it's accumulated, exactly like the scalar expression.
+		auto cofactorRow = [](const Operands& aA, const Operands& aP, const Operands& aQ, __m128 aSign) -> __m128
+			{
+				const __m128 negativeSign = _mm_xor_ps(aSign, _mm_set1_ps(-0.0f));
+				auto term = [](__m128 aFirst, __m128 aSecond, __m128 aThird, __m128 aTermSign)
+					{
+						return _mm_xor_ps(_mm_mul_ps(_mm_mul_ps(aFirst, aSecond), aThird), aTermSign);
+					};
+
+				__m128 result = term(aA.s1, aP.s2, aQ.s3, aSign);
+				result = _mm_add_ps(result, term(aA.s1, aQ.s2, aP.s3, negativeSign));
+				result = _mm_add_ps(result, term(aA.s2, aP.s1, aQ.s3, negativeSign));
+				result = _mm_add_ps(result, term(aA.s2, aQ.s1, aP.s3, aSign));
+				result = _mm_add_ps(result, term(aA.s3, aP.s1, aQ.s2, aSign));
+				result = _mm_add_ps(result, term(aA.s3, aQ.s1, aP.s2, negativeSign));
+				return result;
+			};
+
+		const __m128 row0 = cofactorRow(c1, c2, c3, evenSign);
+		const __m128 row1 = cofactorRow(c0, c2, c3, oddSign);
+		const __m128 row2 = cofactorRow(c0, c1, c3, evenSign);
+		const __m128 row3 = cofactorRow(c0, c1, c2, oddSign);
+
+		alignas(16) float cofactors[16];
+		_mm_store_ps(cofactors + 0, row0);
+		_mm_store_ps(cofactors + 4, row1);
+		_mm_store_ps(cofactors + 8, row2);
+		_mm_store_ps(cofactors + 12, row3);
+
+		float determinant = aMatrix[0] * cofactors[0] + aMatrix[1] * cofactors[4] + aMatrix[2] * cofactors[8] + aMatrix[3] * cofactors[12];
+		if (determinant == 0.0f)
+		{
+			return false;
+		}
+
+		determinant = 1.0f / determinant;
+
+		const __m128 scale = _mm_set1_ps(determinant);
+		_mm_storeu_ps(outResult + 0, _mm_mul_ps(row0, scale));
+		_mm_storeu_ps(outResult + 4, _mm_mul_ps(row1, scale));
+		_mm_storeu_ps(outResult + 8, _mm_mul_ps(row2, scale));
+		_mm_storeu_ps(outResult + 12, _mm_mul_ps(row3, scale));
+		return true;
+	}
+}
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+
+// SIMD feature selection for CommonUtilities.
+// Release/Dist builds are compiled with AVX2 (see apply_simd_flags() in premake5.lua), Debug builds only have the x64 SSE2 baseline.
+// Define CU_NO_SIMD to force the scalar code paths everywhere.
+
+#if !defined(CU_NO_SIMD) && (defined(_M_X64) || defined(__SSE2__))
+	#define CU_SIMD_SSE 1
+	#include <immintrin.h>
+#else
+	#define CU_SIMD_SSE 0
+#endif
+
+#if CU_SIMD_SSE && defined(__AVX2__)
+	#define CU_SIMD_AVX2 1
+#else
+	#define CU_SIMD_AVX2 0
+#endif
+
+// MSVC has no __F16C__ macro, every AVX2 capable CPU supports F16C.
+#if CU_SIMD_SSE && (defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__)))
+	#define CU_SIMD_F16C 1
+#else
+	#define CU_SIMD_F16C 0
+#endif
+
+#if defined(_MSC_VER)
+	#define CU_FORCEINLINE __forceinline
+#else
+	#define CU_FORCEINLINE inline __attribute__((always_inline))
+#endif
@@ -0,0 +1,222 @@
+#include "TransformBatch.h"
+#include <algorithm>
+#include "Quaternion.hpp"
+#include "SIMD/MatrixSIMD.hpp"
+
+namespace CU
+{
+	namespace
+	{
+		TransformBatch Slice(const TransformBatch& aTransforms, size_t aOffset, size_t aCount)
+		{
+			TransformBatch result;
+			result.TranslationX = aTransforms.TranslationX.subspan(aOffset, aCount);
+			result.TranslationY = aTransforms.TranslationY.subspan(aOffset, aCount);
+			result.TranslationZ = aTransforms.TranslationZ.subspan(aOffset, aCount);
+			result.RotationX = aTransforms.RotationX.subspan(aOffset, aCount);
+			result.RotationY = aTransforms.RotationY.subspan(aOffset, aCount);
+			result.RotationZ = aTransforms.RotationZ.subspan(aOffset, aCount);
+			result.RotationW = aTransforms.RotationW.subspan(aOffset, aCount);
+			result.ScaleX = aTransforms.ScaleX.subspan(aOffset, aCount);
+			result.ScaleY = aTransforms.ScaleY.subspan(aOffset, aCount);
+			result.ScaleZ = aTransforms.ScaleZ.subspan(aOffset, aCount);
+			return result;
+		}
+
+		void ComposeMatrix(const TransformBatch& aTransforms, size_t aIndex, Matrix4x4f& outMatrix)
+		{
+			const Quatf rotation(aTransforms.RotationW[aIndex], aTransforms.RotationX[aIndex], aTransforms.RotationY[aIndex], aTransforms.RotationZ[aIndex]);
+			const Vector3f right = rotation.GetRight() * aTransforms.ScaleX[aIndex];
+			const Vector3f up = rotation.GetUp() * aTransforms.ScaleY[aIndex];
+			const Vector3f forward = rotation.GetForward() * aTransforms.ScaleZ[aIndex];
+
+			outMatrix = Matrix4x4f::Identity;
+			outMatrix[0] = right.x;
+			outMatrix[1] = right.y;
+			outMatrix[2] = right.z;
+			outMatrix[4] = up.x;
+			outMatrix[5] = up.y;
+			outMatrix[6] = up.z;
+			outMatrix[8] = forward.x;
+			outMatrix[9] = forward.y;
+			outMatrix[10] = forward.z;
+			outMatrix[12] = aTransforms.TranslationX[aIndex];
+			outMatrix[13] = aTransforms.TranslationY[aIndex];
+			outMatrix[14] = aTransforms.TranslationZ[aIndex];
+		}
+
+#if CU_SIMD_SSE
+		struct SSELanes
+		{
+			using Register = __m128;
+			static constexpr size_t Width = 4;
+
+			static Register Load(const float* aData) { return _mm_loadu_ps(aData); }
+			static Register Set(float aValue) { return _mm_set1_ps(aValue); }
+			static Register Add(Register aA, Register aB) { return _mm_add_ps(aA, aB); }
+			static Register Sub(Register aA, Register aB) { return _mm_sub_ps(aA, aB); }
+			static Register Mul(Register aA, Register aB) { return _mm_mul_ps(aA, aB); }
+			static Register Div(Register aA, Register aB) { return _mm_div_ps(aA, aB); }
+			static Register Sqrt(Register aValue) { return _mm_sqrt_ps(aValue); }
+			static Register CmpEq(Register aA, Register aB) { return _mm_cmpeq_ps(aA, aB); }
+			static Register And(Register aA, Register aB) { return _mm_and_ps(aA, aB); }
+			static Register AndNot(Register aMask, Register aValue) { return _mm_andnot_ps(aMask, aValue); }
+			static Register UnpackLo(Register aA, Register aB) { return _mm_unpacklo_ps(aA, aB); }
+			static Register UnpackHi(Register aA, Register aB) { return _mm_unpackhi_ps(aA, aB); }
+			template<int Imm> static Register Shuffle(Register aA, Register aB) { return _mm_shuffle_ps(aA, aB, Imm); }
+
+			// aRow holds one matrix row of transform aLane.
+			static void StoreRow(Register aRow, size_t aLane, float* outMatrices, int aRowIndex)
+			{
+				_mm_storeu_ps(outMatrices + aLane * 16 + aRowIndex * 4, aRow);
+			}
+		};
+
+#if CU_SIMD_AVX2
+		struct AVXLanes
+		{
+			using Register = __m256;
+			static constexpr size_t Width = 8;
+
+			static Register Load(const float* aData) { return _mm256_loadu_ps(aData); }
+			static Register Set(float aValue) { return _mm256_set1_ps(aValue); }
+			static Register Add(Register aA, Register aB) { return _mm256_add_ps(aA, aB); }
+			static Register Sub(Register aA, Register aB) { return _mm256_sub_ps(aA, aB); }
+			static Register Mul(Register aA, Register aB) { return _mm256_mul_ps(aA, aB); }
+			static Register Div(Register aA, Register aB) { return _mm256_div_ps(aA, aB); }
+			static Register Sqrt(Register aValue) { return _mm256_sqrt_ps(aValue); }
+			static Register CmpEq(Register aA, Register aB) { return _mm256_cmp_ps(aA, aB, _CMP_EQ_OQ); }
+			static Register And(Register aA, Register aB) { return _mm256_and_ps(aA, aB); }
+			static Register AndNot(Register aMask, Register aValue) { return _mm256_andnot_ps(aMask, aValue); }
+			static Register UnpackLo(Register aA, Register aB) { return _mm256_unpacklo_ps(aA, aB); }
+			static Register UnpackHi(Register aA, Register aB) { return _mm256_unpackhi_ps(aA, aB); }
+			template<int Imm> static Register Shuffle(Register aA, Register aB) { return _mm256_shuffle_ps(aA, aB, Imm); }
+
+			// The transpose works per 128-bit lane, so the low half belongs to transform aLane and the high half to aLane + 4.
+			static void StoreRow(Register aRow, size_t aLane, float* outMatrices, int aRowIndex)
+			{
+				_mm_storeu_ps(outMatrices + aLane * 16 + aRowIndex * 4, _mm256_castps256_ps128(aRow));
+				_mm_storeu_ps(outMatrices + (aLane + 4) * 16 + aRowIndex * 4, _mm256_extractf128_ps(aRow, 1));
+			}
+		};
+#endif
+
+		// Transposes the (x, y, z, w) component registers into one matrix row per transform and stores them.
+		template<typename Lanes>
+		CU_FORCEINLINE void StoreRows(typename Lanes::Register aX, typename Lanes::Register aY, typename Lanes::Register aZ, typename Lanes::Register aW, float* outMatrices, int aRowIndex)
+		{
+			const auto xy0 = Lanes::UnpackLo(aX, aY);
+			const auto xy1 = Lanes::UnpackHi(aX, aY);
+			const auto zw0 = Lanes::UnpackLo(aZ, aW);
+			const auto zw1 = Lanes::UnpackHi(aZ, aW);
+
+			Lanes::StoreRow(Lanes::template Shuffle<_MM_SHUFFLE(1, 0, 1, 0)>(xy0, zw0), 0, outMatrices, aRowIndex);
+			Lanes::StoreRow(Lanes::template Shuffle<_MM_SHUFFLE(3, 2, 3, 2)>(xy0, zw0), 1, outMatrices, aRowIndex);
+			Lanes::StoreRow(Lanes::template Shuffle<_MM_SHUFFLE(1, 0, 1, 0)>(xy1, zw1), 2, outMatrices, aRowIndex);
+			Lanes::StoreRow(Lanes::template Shuffle<_MM_SHUFFLE(3, 2, 3, 2)>(xy1, zw1), 3, outMatrices, aRowIndex);
+		}
+
+		// Same as Vector3::GetNormalized, zero vectors stay zero.
+		template<typename Lanes>
+		CU_FORCEINLINE void Normalize(typename Lanes::Register& aX, typename Lanes::Register& aY, typename Lanes::Register& aZ)
+		{
+			const auto zero = Lanes::Set(0.0f);
+			const auto isZero = Lanes::And(Lanes::And(Lanes::CmpEq(aX, zero), Lanes::CmpEq(aY, zero)), Lanes::CmpEq(aZ, zero));
+
+			const auto lengthSqr = Lanes::Add(Lanes::Add(Lanes::Mul(aX, aX), Lanes::Mul(aY, aY)), Lanes::Mul(aZ, aZ));
+			const auto magnitude = Lanes::Div(Lanes::Set(1.0f), Lanes::Sqrt(lengthSqr));
+
+			aX = Lanes::AndNot(isZero, Lanes::Mul(aX, magnitude));
+			aY = Lanes::AndNot(isZero, Lanes::Mul(aY, magnitude));
+			aZ = Lanes::AndNot(isZero, Lanes::Mul(aZ, magnitude));
+		}
+
+		// Builds the matrices for transforms [aIndex, aIndex + Lanes::Width), the basis vectors follow Quaternion::GetRight/GetUp/GetForward.
+		template<typename Lanes>
+		void ComposeMatrices(const TransformBatch& aTransforms, size_t aIndex, float* outMatrices)
+		{
+			using Register = typename Lanes::Register;
+
+			const Register x = Lanes::Load(aTransforms.RotationX.data() + aIndex);
+			const Register y = Lanes::Load(aTransforms.RotationY.data() + aIndex);
+			const Register z = Lanes::Load(aTransforms.RotationZ.data() + aIndex);
+			const Register w = Lanes::Load(aTransforms.RotationW.data() + aIndex);
+
+			const Register zero = Lanes::Set(0.0f);
+			const Register one = Lanes::Set(1.0f);
+			const Register two = Lanes::Set(2.0f);
+
+			Register rightX = Lanes::Sub(one, Lanes::Mul(two, Lanes::Add(Lanes::Mul(y, y), Lanes::Mul(z, z))));
+			Register rightY = Lanes::Mul(two, Lanes::Add(Lanes::Mul(x, y), Lanes::Mul(w, z)));
+			Register rightZ = Lanes::Mul(two, Lanes::Sub(Lanes::Mul(x, z), Lanes::Mul(w, y)));
+			Normalize<Lanes>(rightX, rightY, rightZ);
+
+			const Register scaleX = Lanes::Load(aTransforms.ScaleX.data() + aIndex);
+			StoreRows<Lanes>(Lanes::Mul(rightX, scaleX), Lanes::Mul(rightY, scaleX), Lanes::Mul(rightZ, scaleX), zero, outMatrices, 0);
+
+			Register upX = Lanes::Mul(two, Lanes::Sub(Lanes::Mul(x, y), Lanes::Mul(w, z)));
+			Register upY = Lanes::Sub(one, Lanes::Mul(two, Lanes::Add(Lanes::Mul(x, x), Lanes::Mul(z, z))));
+			Register upZ = Lanes::Mul(two, Lanes::Add(Lanes::Mul(y, z), Lanes::Mul(w, x)));
+			Normalize<Lanes>(upX, upY, upZ);
+
+			const Register scaleY = Lanes::Load(aTransforms.ScaleY.data() + aIndex);
+			StoreRows<Lanes>(Lanes::Mul(upX, scaleY), Lanes::Mul(upY, scaleY), Lanes::Mul(upZ, scaleY), zero, outMatrices, 1);
+
+			Register forwardX = Lanes::Mul(two, Lanes::Add(Lanes::Mul(x, z), Lanes::Mul(w, y)));
+			Register forwardY = Lanes::Mul(two, Lanes::Sub(Lanes::Mul(y, z), Lanes::Mul(w, x)));
+			Register forwardZ = Lanes::Sub(one, Lanes::Mul(two, Lanes::Add(Lanes::Mul(x, x), Lanes::Mul(y, y))));
+			Normalize<Lanes>(forwardX, forwardY, forwardZ);
+
+			const Register scaleZ = Lanes::Load(aTransforms.ScaleZ.data() + aIndex);
+			StoreRows<Lanes>(Lanes::Mul(forwardX, scaleZ), Lanes::Mul(forwardY, scaleZ), Lanes::Mul(forwardZ, scaleZ), zero, outMatrices, 2);
+
+			const Register translationX = Lanes::Load(aTransforms.TranslationX.data() + aIndex);
+			const Register translationY = Lanes::Load(aTransforms.TranslationY.data() + aIndex);
+			const Register translationZ = Lanes::Load(aTransforms.TranslationZ.data() + aIndex);
+			StoreRows<Lanes>(translationX, translationY, translationZ, one, outMatrices, 3);
+		}
+#endif
+	}
+
+	void ComposeMatrices(const TransformBatch& aTransforms, std::span<Matrix4x4f> outMatrices)
+	{
+		const size_t count = std::min(aTransforms.Size(), outMatrices.size());
+		size_t i = 0;
+
+#if CU_SIMD_AVX2
+		for (; i + AVXLanes::Width <= count; i += AVXLanes::Width)
+		{
+			ComposeMatrices<AVXLanes>(aTransforms, i, &outMatrices[i][0]);
+		}
+#endif
+#if CU_SIMD_SSE
+		for (; i + SSELanes::Width <= count; i += SSELanes::Width)
+		{
+			ComposeMatrices<SSELanes>(aTransforms, i, &outMatrices[i][0]);
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			ComposeMatrix(aTransforms, i, outMatrices[i]);
+		}
+	}
+
+	void ComposeMatrices(const TransformBatch& aTransforms, std::span<const Matrix4x4f> aParentMatrices, std::span<Matrix4x4f> outMatrices)
+	{
+		const size_t count = std::min({ aTransforms.Size(), aParentMatrices.size(), outMatrices.size() });
+
+		// Work in blocks so the local matrices are still in cache when they get multiplied with their parents.
+		constexpr size_t blockSize = 256;
+		for (size_t blockStart = 0; blockStart < count; blockStart += blockSize)
+		{
+			const size_t blockCount = std::min(blockSize, count - blockStart);
+			ComposeMatrices(Slice(aTransforms, blockStart, blockCount), outMatrices.subspan(blockStart, blockCount));
+
+			for (size_t i = blockStart; i < blockStart + blockCount; ++i)
+			{
+				outMatrices[i] = outMatrices[i] * aParentMatrices[i];
+			}
+		}
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <span>
+#include "Matrix/Matrix.h"
+
+namespace CU
+{
+	// Structure-of-arrays view over a batch of transforms, every span holds one component for the whole batch.
+	// Rotations are unit quaternions, same as Transform::GetRotationQuat().
+	struct TransformBatch
+	{
+		std::span<const float> TranslationX;
+		std::span<const float> TranslationY;
+		std::span<const float> TranslationZ;
+
+		std::span<const float> RotationX;
+		std::span<const float> RotationY;
+		std::span<const float> RotationZ;
+		std::span<const float> RotationW;
+
+		std::span<const float> ScaleX;
+		std::span<const float> ScaleY;
+		std::span<const float> ScaleZ;
+
+		size_t Size() const { return TranslationX.size(); }
+	};
+
+	// Writes Scale * Rotation * Translation for every transform in the batch, the same matrices Transform::GetMatrix() builds
+	// (without the full matrix multiplications, so only the sign of zero elements can differ).
+	// Processes 8 transforms at a time in AVX2 builds and 4 with SSE, outMatrices must hold at least aTransforms.Size() matrices.
+	void ComposeMatrices(const TransformBatch& aTransforms, std::span<Matrix4x4f> outMatrices);
+
+	// Same as above but every local matrix is also multiplied with aParentMatrices[i], giving the world matrix (local * parent).
+	void ComposeMatrices(const TransformBatch& aTransforms, std::span<const Matrix4x4f> aParentMatrices, std::span<Matrix4x4f> outMatrices);
+}
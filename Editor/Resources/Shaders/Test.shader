@@ -5,6 +5,7 @@ Shader "Standard"
         cbuffer CameraBuffer : register(b0)
         {
             float4x4 CB_ViewProj;
+            float4x4 CB_World;
         }
     
         struct VertexInput
@@ -27,7 +28,7 @@ Shader "Standard"
         {
             VertexOutput output;
     
-            output.pos = mul(CB_ViewProj, float4(input.pos, 1));
+            output.pos = mul(CB_ViewProj, mul(CB_World, float4(input.pos, 1)));
             output.color = input.color;
             output.uv = input.uv;
     
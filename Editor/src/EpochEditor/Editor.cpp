@@ -63,7 +63,6 @@ namespace Epoch
 
 		std::shared_ptr<Assets::EditorAssetManager> assetManager = std::make_shared<Assets::EditorAssetManager>();
 		Assets::AssetManager::SetActiveAssetManager(assetManager);
-		assetManager->Init(project->GetAssetDirectory());
 
 		Epoch::EngineSpecification engineSpec;
 		engineSpec.WindowProperties.Title = "Epoch Editor";
@@ -77,6 +76,9 @@ namespace Epoch
 		engine.SetInitCallback
 		([&]()
 		{
+			// Once the engine is initialized, the assets are registered on the job system
+			assetManager->Init(project->GetAssetDirectory());
+
 			LayerStack& layerStack = engine.GetLayerStack();
 			editorLayerID = layerStack.PushLayer(std::make_unique<Editor::EditorLayer>());
 		});
@@ -19,35 +19,17 @@
 
 namespace Epoch::Editor
 {
-	static std::shared_ptr<Assets::MeshAsset> staticChestMesh;
-	static std::shared_ptr<Assets::MeshAsset> staticChestBottomMesh;
-	static std::shared_ptr<Assets::MeshAsset> staticChestLidMesh;
-	static std::shared_ptr<Assets::MeshAsset> staticRaccoonMesh;
-
 	void EditorLayer::OnAttach()
 	{
+		// The renderer uses its white texture until this is loaded
 		TypedAssetHandle<Assets::TextureAsset> textureAssetHandle(1761087208084911085);
-		Engine::GetInstance()->GetRendererInterface()->SetTexture(Assets::AssetManager::GetAsset<Assets::TextureAsset>(textureAssetHandle));
+		myTestTexture = Assets::AssetManager::GetAssetAsync(textureAssetHandle);
 
 		TypedAssetHandle<Assets::ModelAsset> chest1Handle(17818076198096816287); //Merged
 		TypedAssetHandle<Assets::ModelAsset> chest2Handle(2244813137981101981); //Separate
 		TypedAssetHandle<Assets::ModelAsset> raccoonHandle(2826550511294781016);
 		TypedAssetHandle<Assets::ModelAsset> cubeTestHandle(10955629889549739932);
 
-		TypedAssetHandle<Assets::MeshAsset> chest(4615339590844839697);
-		staticChestMesh = Assets::AssetManager::GetAsset<Assets::MeshAsset>(chest);
-
-		TypedAssetHandle<Assets::MeshAsset> bottom(8771711513993537053);
-		staticChestBottomMesh = Assets::AssetManager::GetAsset<Assets::MeshAsset>(bottom);
-
-		TypedAssetHandle<Assets::MeshAsset> lid(8771710414481908842);
-		staticChestLidMesh = Assets::AssetManager::GetAsset<Assets::MeshAsset>(lid);
-
-		TypedAssetHandle<Assets::MeshAsset> raccoon(9950345307428580679);
-		staticRaccoonMesh = Assets::AssetManager::GetAsset<Assets::MeshAsset>(raccoon);
-
-		Engine::GetInstance()->GetRendererInterface()->SetMesh(staticChestMesh);
-
 		myScene = std::make_shared<Scenes::Scene>();
 		
 		Scenes::Entity cubes = myScene->Instantiate(Assets::AssetManager::GetAsset<Assets::ModelAsset>(cubeTestHandle));
@@ -56,32 +38,30 @@ namespace Epoch::Editor
 		myScene->Instantiate(Assets::AssetManager::GetAsset<Assets::ModelAsset>(raccoonHandle));
 
 		myScene->PrintHierarchy();
+
+		Engine::GetInstance()->GetRendererInterface()->SetRenderProxies(&myRenderProxies);
 	}
 
 	void EditorLayer::OnDetach()
 	{
+		Engine::GetInstance()->GetRendererInterface()->SetRenderProxies(nullptr);
 	}
 
 	void EditorLayer::OnUpdate()
 	{
 		EPOCH_PROFILE_FUNC();
 
-		if (Input::IsKeyPressed(KeyCode::D1))
+		if (myTestTexture.IsValid() && myTestTexture.IsReady())
 		{
-			Engine::GetInstance()->GetRendererInterface()->SetMesh(staticChestMesh);
-		}
-		else if (Input::IsKeyPressed(KeyCode::D2))
-		{
-			Engine::GetInstance()->GetRendererInterface()->SetMesh(staticChestBottomMesh);
-		}
-		else if (Input::IsKeyPressed(KeyCode::D3))
-		{
-			Engine::GetInstance()->GetRendererInterface()->SetMesh(staticChestLidMesh);
-		}
-		else if (Input::IsKeyPressed(KeyCode::D4))
-		{
-			Engine::GetInstance()->GetRendererInterface()->SetMesh(staticRaccoonMesh);
+			Engine::GetInstance()->GetRendererInterface()->SetTexture(myTestTexture.Get());
+			myTestTexture = {};
 		}
+
+		myScene->Update(Engine::GetInstance()->GetDeltaTime());
+
+		// The renderer has already drawn this frame, the next one draws what's synced here
+		myScene->SyncRenderProxies(myRenderProxies.GetWriteList());
+		myRenderProxies.Swap();
 	}
 
 	void EditorLayer::OnRenderImGui()
@@ -1,6 +1,13 @@
 #pragma once
 #include <memory>
+#include <EpochAssets/AssetFuture.h>
 #include <EpochEngine/AppLayer/Layer.h>
+#include <EpochScenes/RenderProxy.h>
+
+namespace Epoch::Assets
+{
+	class TextureAsset;
+}
 
 namespace Epoch::Scenes
 {
@@ -23,5 +30,8 @@ namespace Epoch::Editor
 
 	private:
 		std::shared_ptr<Scenes::Scene> myScene;
+		Scenes::RenderProxyBuffer myRenderProxies;
+
+		Assets::AssetFuture<Assets::TextureAsset> myTestTexture;
 	};
 }
@@ -6,6 +6,8 @@ namespace Epoch::Assets
 {
 	enum class AssetState : uint8_t
 	{
+		Loading,	// Requested with GetAssetAsync() and not loaded yet
+		Failed,		// The load didn't produce an asset
 		CPUOnly,
 		GPUReady,
 		DirtyGPU
@@ -0,0 +1,52 @@
+#include "AssetFuture.h"
+
+namespace Epoch::Assets
+{
+	AssetLoad::AssetLoad(std::shared_ptr<Asset> aAsset) : myAsset(std::move(aAsset)), myDone(true)
+	{
+	}
+
+	AssetState AssetLoad::GetState() const
+	{
+		if (!IsDone()) return AssetState::Loading;
+
+		return myAsset ? myAsset->GetAssetState() : AssetState::Failed;
+	}
+
+	std::shared_ptr<Asset> AssetLoad::GetAsset() const
+	{
+		return IsDone() ? myAsset : nullptr;
+	}
+
+	void AssetLoad::Wait()
+	{
+		if (IsDone()) return;
+
+		Core::JobSystem::Wait(myCounter);
+	}
+
+	void AssetLoad::Finish(std::shared_ptr<Asset> aAsset)
+	{
+		std::vector<std::coroutine_handle<>> waiters;
+		{
+			std::scoped_lock lock(myMutex);
+			myAsset = std::move(aAsset);
+			myDone.store(true);
+			waiters.swap(myWaiters);
+		}
+
+		for (std::coroutine_handle<> waiter : waiters)
+		{
+			waiter.resume();
+		}
+	}
+
+	bool AssetLoad::AddWaiter(std::coroutine_handle<> aWaiter)
+	{
+		std::scoped_lock lock(myMutex);
+		if (IsDone()) return false;
+
+		myWaiters.emplace_back(aWaiter);
+		return true;
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+#include <coroutine>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include <EpochCore/JobSystem.h>
+#include "Asset.h"
+
+namespace Epoch::Assets
+{
+	// One load of an asset, shared by every request for it while it runs
+	class AssetLoad
+	{
+	public:
+		// Loading until Finish() is called
+		AssetLoad() = default;
+		// Already finished, for assets that were loaded before they were requested
+		explicit AssetLoad(std::shared_ptr<Asset> aAsset);
+
+		// Loading, then the asset's own state or Failed
+		AssetState GetState() const;
+		bool IsDone() const { return myDone.load(); }
+
+		// nullptr until done
+		std::shared_ptr<Asset> GetAsset() const;
+
+		// Counts the load from when it's handed out until its jobs are done, Wait() runs other jobs while it waits for them
+		Core::JobCounter& GetCounter() { return myCounter; }
+		void Wait();
+
+		// Publishes the asset, nullptr if the load failed, and resumes the awaiting coroutines on the calling thread
+		void Finish(std::shared_ptr<Asset> aAsset);
+		// False if the load is already done, the coroutine goes on right away then
+		bool AddWaiter(std::coroutine_handle<> aWaiter);
+
+	private:
+		std::shared_ptr<Asset> myAsset;
+		std::atomic<bool> myDone = false;
+
+		std::mutex myMutex;
+		std::vector<std::coroutine_handle<>> myWaiters;
+
+		Core::JobCounter myCounter;
+	};
+
+	// The result of AssetManager::GetAssetAsync(). Poll it every frame with Get() and draw a placeholder while it's nullptr,
+	// Wait() for it, or co_await it, which resumes the coroutine on the thread that finished the load.
+	template<typename T>
+	class AssetFuture
+	{
+	public:
+		AssetFuture() = default;
+		explicit AssetFuture(std::shared_ptr<AssetLoad> aLoad) : myLoad(std::move(aLoad)) {}
+
+		// The same load seen as another asset type
+		template<typename U>
+		explicit AssetFuture(const AssetFuture<U>& aOther) : myLoad(aOther.myLoad) {}
+
+		bool IsValid() const { return myLoad != nullptr; }
+		bool IsReady() const { return !myLoad || myLoad->IsDone(); }
+		AssetState GetState() const { return myLoad ? myLoad->GetState() : AssetState::Failed; }
+
+		// nullptr while loading, if the load failed or if the asset isn't a T
+		std::shared_ptr<T> Get() const;
+		// Blocks until the load is done, the calling thread runs other jobs meanwhile
+		std::shared_ptr<T> Wait() const;
+
+		bool await_ready() const { return IsReady(); }
+		bool await_suspend(std::coroutine_handle<> aCoroutine) const { return myLoad->AddWaiter(aCoroutine); }
+		std::shared_ptr<T> await_resume() const { return Get(); }
+
+	private:
+		std::shared_ptr<AssetLoad> myLoad;
+
+		template<typename U>
+		friend class AssetFuture;
+	};
+
+	template<typename T>
+	inline std::shared_ptr<T> AssetFuture<T>::Get() const
+	{
+		if (!IsReady() || !myLoad) return nullptr;
+
+		if constexpr (std::is_same_v<T, Asset>)
+		{
+			return myLoad->GetAsset();
+		}
+		else
+		{
+			return std::dynamic_pointer_cast<T>(myLoad->GetAsset());
+		}
+	}
+
+	template<typename T>
+	inline std::shared_ptr<T> AssetFuture<T>::Wait() const
+	{
+		if (!myLoad) return nullptr;
+
+		myLoad->Wait();
+		return Get();
+	}
+}
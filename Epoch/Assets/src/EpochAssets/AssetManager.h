@@ -22,6 +22,16 @@ namespace Epoch::Assets
 			return std::dynamic_pointer_cast<T>(asset);
 		}
 
+		template<typename T>
+		static AssetFuture<T> GetAssetAsync(TypedAssetHandle<T> aAssetHandle)
+		{
+			static_assert(std::is_base_of<Asset, T>::value, "GetAssetAsync only works for types derived from Asset");
+
+			EPOCH_ASSERT(staticAssetManager, "AssetManager not set!");
+
+			return AssetFuture<T>(staticAssetManager->GetAssetAsync(aAssetHandle.Get()));
+		}
+
 		inline static std::shared_ptr<AssetManagerBase> GetAssetManager() { return staticAssetManager; }
 		inline static std::shared_ptr<EditorAssetManager> GetEditorAssetManager() { return std::static_pointer_cast<EditorAssetManager>(staticAssetManager); }
 
@@ -1,6 +1,7 @@
 #pragma once
 #include <memory>
 #include "EpochAssets/Asset.h"
+#include "EpochAssets/AssetFuture.h"
 
 namespace Epoch::Assets
 {
@@ -13,6 +14,8 @@ namespace Epoch::Assets
 		virtual ~AssetManagerBase() = default;
 
 		virtual std::shared_ptr<Asset> GetAsset(AssetHandle aHandle) = 0;
+		// Loads in the background, requests for an asset that's already loading share its load. Finished right away by default.
+		virtual AssetFuture<Asset> GetAssetAsync(AssetHandle aHandle) { return AssetFuture<Asset>(std::make_shared<AssetLoad>(GetAsset(aHandle))); }
 
 		virtual void AddMemoryOnlyAsset(std::shared_ptr<Asset> aAsset, std::string_view aName = {}) = 0;
 
@@ -0,0 +1,87 @@
+#include "ConcurrentAssetMap.h"
+
+namespace Epoch::Assets
+{
+	ConcurrentAssetMap::~ConcurrentAssetMap()
+	{
+		for (Shard& shard : myShards)
+		{
+			delete shard.Current.load();
+			for (const Table* table : shard.Retired)
+			{
+				delete table;
+			}
+		}
+	}
+
+	std::shared_ptr<Asset> ConcurrentAssetMap::Find(AssetHandle aHandle) const
+	{
+		const Shard& shard = myShards[GetShardIndex(aHandle)];
+
+		// Counted before the table is loaded, a writer that sees no readers knows nobody can be in a table it replaced
+		shard.Readers.fetch_add(1);
+
+		std::shared_ptr<Asset> asset;
+		if (const Table* table = shard.Current.load())
+		{
+			if (auto it = table->find(aHandle); it != table->end())
+			{
+				asset = it->second;
+			}
+		}
+
+		shard.Readers.fetch_sub(1);
+		return asset;
+	}
+
+	void ConcurrentAssetMap::Insert(AssetHandle aHandle, std::shared_ptr<Asset> aAsset)
+	{
+		Shard& shard = myShards[GetShardIndex(aHandle)];
+		std::scoped_lock lock(shard.WriteMutex);
+
+		const Table* current = shard.Current.load();
+		auto table = current ? std::make_unique<Table>(*current) : std::make_unique<Table>();
+		table->insert_or_assign(aHandle, std::move(aAsset));
+
+		Publish(shard, table.release());
+	}
+
+	void ConcurrentAssetMap::Erase(AssetHandle aHandle)
+	{
+		Shard& shard = myShards[GetShardIndex(aHandle)];
+		std::scoped_lock lock(shard.WriteMutex);
+
+		const Table* current = shard.Current.load();
+		if (!current || !current->contains(aHandle)) return;
+
+		auto table = std::make_unique<Table>(*current);
+		table->erase(aHandle);
+
+		Publish(shard, table.release());
+	}
+
+	uint32_t ConcurrentAssetMap::GetShardIndex(AssetHandle aHandle)
+	{
+		// The top bits of a multiplicative hash, the tables' own buckets use the low ones
+		const uint64_t hash = static_cast<uint64_t>(aHandle) * 0x9E3779B97F4A7C15ull;
+		return static_cast<uint32_t>(hash >> (64 - ShardBits));
+	}
+
+	void ConcurrentAssetMap::Publish(Shard& aShard, const Table* aTable)
+	{
+		if (const Table* previous = aShard.Current.exchange(aTable))
+		{
+			aShard.Retired.emplace_back(previous);
+		}
+
+		// A reader that comes after the exchange only sees the new table
+		if (aShard.Readers.load() == 0)
+		{
+			for (const Table* table : aShard.Retired)
+			{
+				delete table;
+			}
+			aShard.Retired.clear();
+		}
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "EpochAssets/Asset.h"
+
+namespace Epoch::Assets
+{
+	// Handle to asset map for many readers and few writers. It's split in shards by handle, every shard an immutable table
+	// that writers copy, change and swap in under the shard's lock. Find() takes no lock, it only counts itself as a reader
+	// of the shard so a table it may still be in isn't freed. Replaced tables are freed by the next write that sees no readers.
+	class ConcurrentAssetMap
+	{
+	public:
+		ConcurrentAssetMap() = default;
+		~ConcurrentAssetMap();
+
+		ConcurrentAssetMap(const ConcurrentAssetMap&) = delete;
+		ConcurrentAssetMap& operator=(const ConcurrentAssetMap&) = delete;
+
+		// nullptr if there's no asset with the handle
+		std::shared_ptr<Asset> Find(AssetHandle aHandle) const;
+		bool Contains(AssetHandle aHandle) const { return Find(aHandle) != nullptr; }
+
+		// Replaces the asset if there already is one with the handle
+		void Insert(AssetHandle aHandle, std::shared_ptr<Asset> aAsset);
+		void Erase(AssetHandle aHandle);
+
+	private:
+		using Table = std::unordered_map<AssetHandle, std::shared_ptr<Asset>>;
+
+		struct alignas(64) Shard
+		{
+			std::atomic<const Table*> Current = nullptr;
+			mutable std::atomic<uint32_t> Readers = 0;
+
+			std::mutex WriteMutex;
+			std::vector<const Table*> Retired;	// Replaced, but some reader may still be in them
+		};
+
+		static constexpr uint32_t ShardBits = 6;
+		static constexpr uint32_t ShardCount = 1u << ShardBits;
+
+		static uint32_t GetShardIndex(AssetHandle aHandle);
+		// With the shard's write lock held
+		static void Publish(Shard& aShard, const Table* aTable);
+
+		std::array<Shard, ShardCount> myShards;
+	};
+}
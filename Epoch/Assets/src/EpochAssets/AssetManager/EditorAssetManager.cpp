@@ -1,5 +1,8 @@
 #include "EditorAssetManager.h"
+#include <unordered_set>
 #include <CommonUtilities/StringUtils.h>
+#include <CommonUtilities/Timer.h>
+#include <EpochCore/Log.h>
 #include "EpochAssets/AssetExtensions.h"
 #include "EpochAssets/AssetImporter.h"
 #include "EpochAssets/Metadata/AssetMetadataSerializer.h"
@@ -8,8 +11,59 @@ namespace Epoch::Assets
 {
 	static AssetMetadata staticNullMetadata;
 
+	namespace
+	{
+		struct DirectoryListing
+		{
+			std::mutex Mutex;
+			std::vector<std::filesystem::path> Files;
+			Core::JobCounter Counter;
+		};
+
+		// Starts a job per subdirectory, symlinked ones are skipped like recursive_directory_iterator does by default
+		void ListDirectory(const std::filesystem::path& aDirectory, DirectoryListing& aListing)
+		{
+			std::vector<std::filesystem::path> files;
+
+			std::error_code error;
+			for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(aDirectory, error))
+			{
+				if (entry.is_directory(error))
+				{
+					if (!entry.is_symlink(error))
+					{
+						Core::JobSystem::Run([&aListing, directory = entry.path()]() { ListDirectory(directory, aListing); }, &aListing.Counter);
+					}
+					continue;
+				}
+
+				files.emplace_back(entry.path());
+			}
+
+			std::scoped_lock lock(aListing.Mutex);
+			aListing.Files.insert(aListing.Files.end(), std::make_move_iterator(files.begin()), std::make_move_iterator(files.end()));
+		}
+	}
+
 	EditorAssetManager::EditorAssetManager() = default;
-	EditorAssetManager::~EditorAssetManager() = default;
+
+	EditorAssetManager::~EditorAssetManager()
+	{
+		// The loads still running use the manager
+		std::vector<std::shared_ptr<AssetLoad>> loads;
+		{
+			std::scoped_lock lock(myLoadsMutex);
+			for (auto& [handle, load] : myLoads)
+			{
+				loads.emplace_back(load);
+			}
+		}
+
+		for (auto& load : loads)
+		{
+			Core::JobSystem::Wait(load->GetCounter());
+		}
+	}
 
 	void EditorAssetManager::Init(const std::filesystem::path& aAssetDirectory)
 	{
@@ -23,51 +77,143 @@ namespace Epoch::Assets
 
 	std::shared_ptr<Asset> EditorAssetManager::GetAsset(AssetHandle aHandle)
 	{
-		if (auto it = myMemoryAssets.find(aHandle); it != myMemoryAssets.end())
+		if (auto asset = myAssets.Find(aHandle))
 		{
-			return it->second;
+			return asset;
 		}
 
-		if (auto it = myLoadedAssets.find(aHandle); it != myLoadedAssets.end())
+		return GetAssetAsync(aHandle).Wait();
+	}
+
+	AssetFuture<Asset> EditorAssetManager::GetAssetAsync(AssetHandle aHandle)
+	{
+		return AssetFuture<Asset>(StartLoad(aHandle));
+	}
+
+	std::shared_ptr<AssetLoad> EditorAssetManager::StartLoad(AssetHandle aHandle)
+	{
+		if (auto asset = myAssets.Find(aHandle))
 		{
-			return it->second;
+			return std::make_shared<AssetLoad>(asset);
 		}
 
-		const AssetMetadata& metadata = GetMetadata(aHandle);
+		const AssetMetadata metadata = GetMetadata(aHandle);
 		if (!metadata.IsValid())
 		{
-			return nullptr;
+			return std::make_shared<AssetLoad>(nullptr);
 		}
 
-		if (metadata.IsMemoryAsset)
+		auto load = std::make_shared<AssetLoad>();
 		{
-			auto parentIt = myAssetParents.find(aHandle);
-			if (parentIt == myAssetParents.end()) return nullptr;
+			std::scoped_lock lock(myLoadsMutex);
 
-			if (!GetAsset(parentIt->second)) return nullptr;
+			if (auto it = myLoads.find(aHandle); it != myLoads.end())
+			{
+				return it->second;
+			}
 
-			auto subIt = myMemoryAssets.find(aHandle);
-			return subIt != myMemoryAssets.end() ? subIt->second : nullptr;
+			// A load that finished since the lookup above may already be released
+			if (auto asset = myAssets.Find(aHandle))
+			{
+				return std::make_shared<AssetLoad>(asset);
+			}
+
+			ReleaseFinishedLoads();
+
+			// Held until its job is started, a request that finds it in the meantime waits for the job instead of returning right away
+			Core::JobSystem::Hold(load->GetCounter());
+			myLoads.emplace(aHandle, load);
+		}
+
+		// The jobs use a plain pointer, myLoads keeps the load alive until they're done
+		if (metadata.IsMemoryAsset)
+		{
+			AssetHandle parent = 0;
+			{
+				std::shared_lock lock(myRegistryMutex);
+				if (auto it = myAssetParents.find(aHandle); it != myAssetParents.end())
+				{
+					parent = it->second;
+				}
+			}
+
+			if (parent == 0)
+			{
+				load->Finish(nullptr);
+			}
+			else
+			{
+				// The parent's importer adds the sub asset to the memory assets
+				std::shared_ptr<AssetLoad> parentLoad = StartLoad(parent);
+				Core::JobSystem::RunAfter(parentLoad->GetCounter(), [this, load = load.get(), aHandle]() { load->Finish(myAssets.Find(aHandle)); }, &load->GetCounter());
+			}
 		}
 		else
 		{
-			if (myAssetParents.contains(aHandle))
 			{
+				// The importer adds the sub assets again
+				std::unique_lock lock(myRegistryMutex);
 				myAssetParents.erase(aHandle);
+				myAssetSubAssets.erase(aHandle);
 			}
 
-			if (myAssetSubAssets.contains(aHandle))
+			Core::JobSystem::Run([this, load = load.get(), metadata]() { LoadAsset(*load, metadata); }, &load->GetCounter());
+		}
+
+		Core::JobSystem::Release(load->GetCounter());
+		return load;
+	}
+
+	void EditorAssetManager::LoadAsset(AssetLoad& aLoad, const AssetMetadata& aMetadata)
+	{
+		std::shared_ptr<Asset> asset;
+		if (AssetImporter::TryLoadData(aMetadata, asset))
+		{
 			{
-				myAssetSubAssets.erase(aHandle);
+				// Unless it was removed while it loaded, removing takes the lock exclusively
+				std::shared_lock lock(myRegistryMutex);
+				if (myAssetRegistry.contains(aMetadata.Handle))
+				{
+					myAssets.Insert(aMetadata.Handle, asset);
+				}
 			}
+			AssetMetadataSerializer::Serialize(GetMetaFilePath(aMetadata.Handle), aMetadata);
+		}
+		else
+		{
+			asset = nullptr;
+		}
 
-			std::shared_ptr<Asset> asset;
-			if (AssetImporter::TryLoadData(metadata, asset))
+		aLoad.Finish(std::move(asset));
+	}
+
+	void EditorAssetManager::ReleaseFinishedLoads()
+	{
+		for (auto it = myLoads.begin(); it != myLoads.end(); )
+		{
+			AssetLoad& load = *it->second;
+			if (load.GetCounter().IsDone() && load.GetAsset())
 			{
-				myLoadedAssets[aHandle] = asset;
-				AssetMetadataSerializer::Serialize(GetMetaFilePath(aHandle), metadata);
+				// Returns right away, but only once the job that finished the counter has let go of it
+				Core::JobSystem::Wait(load.GetCounter());
+				it = myLoads.erase(it);
 			}
-			return asset;
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	void EditorAssetManager::ReleaseLoad(AssetHandle aHandle)
+	{
+		std::scoped_lock lock(myLoadsMutex);
+
+		// A load that's still running finishes on its own, it doesn't publish an asset that was removed meanwhile
+		if (auto it = myLoads.find(aHandle); it != myLoads.end() && it->second->GetCounter().IsDone())
+		{
+			Core::JobSystem::Wait(it->second->GetCounter());
+			myLoads.erase(it);
 		}
 	}
 
@@ -83,77 +229,79 @@ namespace Epoch::Assets
 			metadata.FilePath = aName;
 		}
 
+		std::unique_lock lock(myRegistryMutex);
 		myAssetRegistry[metadata.Handle] = metadata;
-		myMemoryAssets[metadata.Handle] = std::move(aAsset);
+		myAssets.Insert(metadata.Handle, std::move(aAsset));
 	}
 
 	void EditorAssetManager::AddSubAsset(AssetHandle aParentAsset, std::shared_ptr<Asset> aAsset, std::string_view aName)
 	{
-		AddMemoryOnlyAsset(aAsset, aName);
-		RegisterSubAsset(aParentAsset, aAsset->GetHandle());
+		const AssetHandle handle = aAsset->GetHandle();
+		AddMemoryOnlyAsset(std::move(aAsset), aName);
+		RegisterSubAsset(aParentAsset, handle);
 	}
 
 	void EditorAssetManager::ReloadAsset(AssetHandle aHandle)
 	{
-		auto& metadata = GetMetadata(aHandle);
+		const AssetMetadata metadata = GetMetadata(aHandle);
 		EPOCH_ASSERT(metadata.IsValid(), "Trying to reload invalid asset!");
 
-		const auto& subAssets = GetSubAssets(aHandle);
-		for (auto subAsset : subAssets)
+		for (auto subAsset : GetSubAssets(aHandle))
 		{
 			RemoveAsset(subAsset);
 		}
-		if (myLoadedAssets.contains(aHandle))
-		{
-			myLoadedAssets.erase(aHandle);
-		}
+		myAssets.Erase(aHandle);
+		ReleaseLoad(aHandle);
 
+		// The importer adds the sub assets again
 		std::shared_ptr<Asset> asset;
 		if (AssetImporter::TryLoadData(metadata, asset))
 		{
-			myLoadedAssets[aHandle] = asset;
+			std::shared_lock lock(myRegistryMutex);
+			if (myAssetRegistry.contains(aHandle))
+			{
+				myAssets.Insert(aHandle, asset);
+			}
 		}
 	}
 
 	void EditorAssetManager::RemoveAsset(AssetHandle aHandle)
 	{
-		const auto& subAssets = GetSubAssets(aHandle);
-		for (auto subAsset : subAssets)
+		for (auto subAsset : GetSubAssets(aHandle))
 		{
 			RemoveAsset(subAsset);
 		}
 
-		if (myAssetParents.contains(aHandle))
-		{
-			myAssetParents.erase(aHandle);
-		}
-
-		if (myAssetSubAssets.contains(aHandle))
 		{
+			std::unique_lock lock(myRegistryMutex);
+			if (auto parent = myAssetParents.find(aHandle); parent != myAssetParents.end())
+			{
+				if (auto siblings = myAssetSubAssets.find(parent->second); siblings != myAssetSubAssets.end())
+				{
+					siblings->second.erase(aHandle);
+				}
+				myAssetParents.erase(parent);
+			}
 			myAssetSubAssets.erase(aHandle);
+			if (auto it = myAssetRegistry.find(aHandle); it != myAssetRegistry.end())
+			{
+				if (auto path = myAssetPaths.find(it->second.FilePath); path != myAssetPaths.end() && path->second == aHandle)
+				{
+					myAssetPaths.erase(path);
+				}
+				myAssetRegistry.erase(it);
+			}
+			myAssets.Erase(aHandle);
 		}
 
-		if (myLoadedAssets.contains(aHandle))
-		{
-			myLoadedAssets.erase(aHandle);
-		}
-
-		if (myMemoryAssets.contains(aHandle))
-		{
-			myMemoryAssets.erase(aHandle);
-		}
-
-		if (myAssetRegistry.contains(aHandle))
-		{
-			myAssetRegistry.erase(aHandle);
-		}
+		ReleaseLoad(aHandle);
 	}
 
 	AssetHandle EditorAssetManager::ImportAsset(const std::filesystem::path& aFilepath)
 	{
 		std::filesystem::path path = GetRelativePath(aFilepath);
 
-		if (const auto& metadata = GetMetadata(path); metadata.IsValid())
+		if (const auto metadata = GetMetadata(path); metadata.IsValid())
 		{
 			return metadata.Handle;
 		}
@@ -161,7 +309,8 @@ namespace Epoch::Assets
 		AssetMetadata metadata;
 
 		std::filesystem::path metaPath = GetMetaFilePath(path);
-		if (std::filesystem::exists(metaPath))
+		const bool hasMetaFile = std::filesystem::exists(metaPath);
+		if (hasMetaFile)
 		{
 			metadata = AssetMetadataSerializer::Deserialize(metaPath);
 			metadata.FilePath = path;
@@ -179,17 +328,32 @@ namespace Epoch::Assets
 			metadata.Type = type;
 
 			metadata.ImportSettings = ImportSettingsFactory::CreateDefault(type);
+		}
 
-			AssetMetadataSerializer::Serialize(metaPath, metadata);
+		{
+			// Another thread may have imported the same file meanwhile, the first one wins
+			std::unique_lock lock(myRegistryMutex);
+			if (const AssetMetadata* imported = FindMetadata(path))
+			{
+				return imported->Handle;
+			}
+			myAssetRegistry.insert_or_assign(metadata.Handle, metadata);
+			IndexPath(metadata);
 		}
 
-		myAssetRegistry.insert_or_assign(metadata.Handle, metadata);
+		// Only written by the thread that registered the handle
+		if (!hasMetaFile)
+		{
+			AssetMetadataSerializer::Serialize(metaPath, metadata);
+		}
 
 		return metadata.Handle;
 	}
 
-	const AssetMetadata& EditorAssetManager::GetMetadata(AssetHandle aHandle)
+	AssetMetadata EditorAssetManager::GetMetadata(AssetHandle aHandle) const
 	{
+		std::shared_lock lock(myRegistryMutex);
+
 		if (auto it = myAssetRegistry.find(aHandle); it != myAssetRegistry.end())
 		{
 			return it->second;
@@ -198,16 +362,15 @@ namespace Epoch::Assets
 		return staticNullMetadata;
 	}
 
-	const AssetMetadata& EditorAssetManager::GetMetadata(const std::filesystem::path& aFilepath)
+	AssetMetadata EditorAssetManager::GetMetadata(const std::filesystem::path& aFilepath) const
 	{
 		const auto relativePath = GetRelativePath(aFilepath);
 
-		for (auto& [handle, metadata] : myAssetRegistry)
+		std::shared_lock lock(myRegistryMutex);
+
+		if (const AssetMetadata* metadata = FindMetadata(relativePath))
 		{
-			if (metadata.FilePath == relativePath)
-			{
-				return metadata;
-			}
+			return *metadata;
 		}
 
 		return staticNullMetadata;
@@ -215,6 +378,8 @@ namespace Epoch::Assets
 
 	std::set<AssetHandle> EditorAssetManager::GetSubAssets(AssetHandle aHandle) const
 	{
+		std::shared_lock lock(myRegistryMutex);
+
 		if (auto it = myAssetSubAssets.find(aHandle); it != myAssetSubAssets.end())
 		{
 			return it->second;
@@ -233,17 +398,17 @@ namespace Epoch::Assets
 		return AssetType::None;
 	}
 
-	std::filesystem::path EditorAssetManager::GetFileSystemPath(AssetHandle aHandle)
+	std::filesystem::path EditorAssetManager::GetFileSystemPath(AssetHandle aHandle) const
 	{
 		return myAssetDirectory / GetMetadata(aHandle).FilePath;
 	}
 
-	std::filesystem::path EditorAssetManager::GetFileSystemPath(const std::filesystem::path& aRelativePath)
+	std::filesystem::path EditorAssetManager::GetFileSystemPath(const std::filesystem::path& aRelativePath) const
 	{
 		return myAssetDirectory / aRelativePath;
 	}
 
-	std::filesystem::path EditorAssetManager::GetRelativePath(const std::filesystem::path& aFilepath)
+	std::filesystem::path EditorAssetManager::GetRelativePath(const std::filesystem::path& aFilepath) const
 	{
 		std::filesystem::path relativePath = aFilepath.lexically_normal();
 		std::string temp = aFilepath.string();
@@ -258,34 +423,160 @@ namespace Epoch::Assets
 		return relativePath;
 	}
 
-	std::filesystem::path EditorAssetManager::GetMetaFilePath(AssetHandle aHandle)
+	std::filesystem::path EditorAssetManager::GetMetaFilePath(AssetHandle aHandle) const
 	{
 		return (GetFileSystemPath(aHandle) += ".meta");
 	}
 
-	std::filesystem::path EditorAssetManager::GetMetaFilePath(const std::filesystem::path& aRelativePath)
+	std::filesystem::path EditorAssetManager::GetMetaFilePath(const std::filesystem::path& aRelativePath) const
 	{
 		return (GetFileSystemPath(aRelativePath) += ".meta");
 	}
 
 	void EditorAssetManager::RegisterAssets()
 	{
-		for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(myAssetDirectory))
+		CU::Timer timer;
+		CU::Timer phaseTimer;
+
+		// Every directory is listed by its own job
+		DirectoryListing listing;
+		ListDirectory(myAssetDirectory, listing);
+		Core::JobSystem::Wait(listing.Counter);
+
+		// The listing tells which files have a .meta, there's no need to ask the file system per file
+		std::unordered_set<std::filesystem::path, PathHash> metaFiles;
+		std::vector<std::filesystem::path> assetFiles;
+		for (std::filesystem::path& file : listing.Files)
 		{
-			if (entry.is_directory()) continue;
+			if (file.extension() == ".meta")
+			{
+				metaFiles.emplace(std::move(file));
+			}
+			else
+			{
+				assetFiles.emplace_back(std::move(file));
+			}
+		}
 
-			ImportAsset(entry.path());
+		const float listingTime = phaseTimer.ElapsedMillis();
+		phaseTimer.Reset();
+
+		struct FoundAsset
+		{
+			AssetMetadata Metadata;
+			std::vector<AssetMetadata> SubAssets;
+			bool HasMetaFile = false;
+		};
+
+		std::vector<FoundAsset> foundAssets(assetFiles.size());
+		Core::JobSystem::ParallelFor(static_cast<uint32_t>(assetFiles.size()), [&](uint32_t aBegin, uint32_t aEnd)
+			{
+				for (uint32_t i = aBegin; i < aEnd; ++i)
+				{
+					// Listed from the asset directory, no need for the file system to make it relative
+					const std::filesystem::path path = assetFiles[i].lexically_relative(myAssetDirectory).lexically_normal();
+					FoundAsset& found = foundAssets[i];
+
+					std::filesystem::path metaPath = assetFiles[i];
+					metaPath += ".meta";
+					if (metaFiles.contains(metaPath))
+					{
+						found.Metadata = AssetMetadataSerializer::Deserialize(metaPath, found.SubAssets);
+						found.Metadata.FilePath = path;
+						found.HasMetaFile = true;
+						continue;
+					}
+
+					const AssetType type = GetAssetTypeFromExtension(path.extension().string());
+					if (type == AssetType::None) continue;
+
+					found.Metadata.Handle = AssetHandle();
+					found.Metadata.FilePath = path;
+					found.Metadata.Type = type;
+					found.Metadata.ImportSettings = ImportSettingsFactory::CreateDefault(type);
+				}
+			}, 16);
+
+		const float readingTime = phaseTimer.ElapsedMillis();
+		phaseTimer.Reset();
+
+		size_t registeredCount = 0;
+		std::vector<const AssetMetadata*> newAssets;
+		{
+			std::unique_lock lock(myRegistryMutex);
+			for (const FoundAsset& found : foundAssets)
+			{
+				if (!found.Metadata.IsValid() || FindMetadata(found.Metadata.FilePath)) continue;
+
+				myAssetRegistry.insert_or_assign(found.Metadata.Handle, found.Metadata);
+				IndexPath(found.Metadata);
+				++registeredCount;
+
+				for (const AssetMetadata& subMeta : found.SubAssets)
+				{
+					myAssetRegistry.insert_or_assign(subMeta.Handle, subMeta);
+					myAssetSubAssets[found.Metadata.Handle].insert(subMeta.Handle);
+					myAssetParents[subMeta.Handle] = found.Metadata.Handle;
+				}
+
+				if (!found.HasMetaFile)
+				{
+					newAssets.emplace_back(&found.Metadata);
+				}
+			}
 		}
+
+		const float registeringTime = phaseTimer.ElapsedMillis();
+		phaseTimer.Reset();
+
+		Core::JobSystem::ParallelFor(static_cast<uint32_t>(newAssets.size()), [&](uint32_t aBegin, uint32_t aEnd)
+			{
+				for (uint32_t i = aBegin; i < aEnd; ++i)
+				{
+					AssetMetadataSerializer::Serialize(GetMetaFilePath(newAssets[i]->FilePath), *newAssets[i]);
+				}
+			}, 16);
+
+		const float writingTime = phaseTimer.ElapsedMillis();
+
+		LOG_INFO("Registered {} assets from '{}' Time: {:.1f}ms (listing {} files: {:.1f}ms, reading metadata: {:.1f}ms, registering: {:.1f}ms, writing {} new metadata files: {:.1f}ms)",
+			registeredCount, myAssetDirectory.string(), timer.ElapsedMillis(), listing.Files.size(), listingTime, readingTime, registeringTime, newAssets.size(), writingTime);
 	}
 
 	void EditorAssetManager::RegisterMetadata(const AssetMetadata& aMetadata)
 	{
+		std::unique_lock lock(myRegistryMutex);
+
 		myAssetRegistry.insert_or_assign(aMetadata.Handle, aMetadata);
+		IndexPath(aMetadata);
 	}
 
 	void EditorAssetManager::RegisterSubAsset(AssetHandle aAsset, AssetHandle aSubAsset)
 	{
+		std::unique_lock lock(myRegistryMutex);
+
 		myAssetSubAssets[aAsset].insert(aSubAsset);
 		myAssetParents[aSubAsset] = aAsset;
 	}
+
+	const AssetMetadata* EditorAssetManager::FindMetadata(const std::filesystem::path& aRelativePath) const
+	{
+		if (auto path = myAssetPaths.find(aRelativePath); path != myAssetPaths.end())
+		{
+			if (auto it = myAssetRegistry.find(path->second); it != myAssetRegistry.end())
+			{
+				return &it->second;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void EditorAssetManager::IndexPath(const AssetMetadata& aMetadata)
+	{
+		if (!aMetadata.IsMemoryAsset)
+		{
+			myAssetPaths.insert_or_assign(aMetadata.FilePath, aMetadata.Handle);
+		}
+	}
 }
@@ -1,12 +1,17 @@
 #pragma once
 #include <filesystem>
+#include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 #include <set>
 #include "AssetManagerBase.h"
+#include "ConcurrentAssetMap.h"
 #include "EpochAssets/Metadata/AssetMetadata.h"
 
 namespace Epoch::Assets
 {
+	// Safe to use from any thread. Getting an asset that's already loaded takes no lock, the registry is behind a
+	// reader writer lock and the running loads behind their own. None of the locks are held while an asset decodes.
 	class EditorAssetManager : public AssetManagerBase
 	{
 	public:
@@ -15,7 +20,10 @@ namespace Epoch::Assets
 
 		void Init(const std::filesystem::path& aAssetDirectory);
 
+		// Waits for the load if the asset isn't loaded, running other jobs meanwhile
 		std::shared_ptr<Asset> GetAsset(AssetHandle aHandle) override;
+		// Loads on the job system. A sub asset waits for its parent's load and is then taken from the assets it added.
+		AssetFuture<Asset> GetAssetAsync(AssetHandle aHandle) override;
 
 		void AddMemoryOnlyAsset(std::shared_ptr<Asset> aAsset, std::string_view aName = {}) override;
 		void AddSubAsset(AssetHandle aParentAsset, std::shared_ptr<Asset> aAsset, std::string_view aName = {});
@@ -25,34 +33,57 @@ namespace Epoch::Assets
 
 		AssetHandle ImportAsset(const std::filesystem::path& aFilepath);
 
-		const AssetMetadata& GetMetadata(AssetHandle aHandle);
-		const AssetMetadata& GetMetadata(const std::filesystem::path& aFilepath);
+		// Copies, the registry may change on another thread
+		AssetMetadata GetMetadata(AssetHandle aHandle) const;
+		AssetMetadata GetMetadata(const std::filesystem::path& aFilepath) const;
 		
 		std::set<AssetHandle> GetSubAssets(AssetHandle aHandle) const;
 
 		AssetType GetAssetTypeFromExtension(const std::string& aExtension);
 
-		std::filesystem::path GetFileSystemPath(AssetHandle aHandle);
-		std::filesystem::path GetFileSystemPath(const std::filesystem::path& aRelativePath);
-		std::filesystem::path GetRelativePath(const std::filesystem::path& aFilepath);
+		std::filesystem::path GetFileSystemPath(AssetHandle aHandle) const;
+		std::filesystem::path GetFileSystemPath(const std::filesystem::path& aRelativePath) const;
+		std::filesystem::path GetRelativePath(const std::filesystem::path& aFilepath) const;
 
-		std::filesystem::path GetMetaFilePath(AssetHandle aHandle);
-		std::filesystem::path GetMetaFilePath(const std::filesystem::path& aRelativePath);
+		std::filesystem::path GetMetaFilePath(AssetHandle aHandle) const;
+		std::filesystem::path GetMetaFilePath(const std::filesystem::path& aRelativePath) const;
 
 	private:
 		void RegisterAssets();
 		void RegisterMetadata(const AssetMetadata& aMetadata);
 		void RegisterSubAsset(AssetHandle aAsset, AssetHandle aSubAsset);
+		// Only assets with a file, with myRegistryMutex held
+		const AssetMetadata* FindMetadata(const std::filesystem::path& aRelativePath) const;
+		void IndexPath(const AssetMetadata& aMetadata);
+		// The running load of the asset, a new one, or a finished one if there's nothing to load
+		std::shared_ptr<AssetLoad> StartLoad(AssetHandle aHandle);
+		void LoadAsset(AssetLoad& aLoad, const AssetMetadata& aMetadata);
+		// Drops the loads that succeeded, their assets are in myAssets now. With myLoadsMutex held.
+		void ReleaseFinishedLoads();
+		void ReleaseLoad(AssetHandle aHandle);
 
 	private:
+		struct PathHash
+		{
+			size_t operator()(const std::filesystem::path& aPath) const { return std::filesystem::hash_value(aPath); }
+		};
+
 		std::filesystem::path myAssetDirectory;
 
 		std::unordered_map<AssetHandle, AssetMetadata> myAssetRegistry;
 		std::unordered_map<AssetHandle, std::set<AssetHandle>> myAssetSubAssets; //ParentAsset -> SubAssets
 		std::unordered_map<AssetHandle, AssetHandle> myAssetParents; //SubAsset -> ParentAsset
+		std::unordered_map<std::filesystem::path, AssetHandle, PathHash> myAssetPaths; //FilePath -> Asset, not memory assets
+
+		// The registry, sub assets and parents. Never held while calling out, the importers call back into the manager.
+		mutable std::shared_mutex myRegistryMutex;
+
+		// Loaded and memory only assets
+		ConcurrentAssetMap myAssets;
 
-		AssetMap myLoadedAssets;
-		AssetMap myMemoryAssets;
+		// Started loads, failed ones stay until the asset is reloaded or removed so they aren't retried every frame
+		std::unordered_map<AssetHandle, std::shared_ptr<AssetLoad>> myLoads;
+		std::mutex myLoadsMutex;
 
 		friend class AssetMetadataSerializer;
 	};
@@ -1,6 +1,7 @@
 #include "TextureSerializer.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image/stb_image.h>
+#include <CommonUtilities/ColorConversion.h>
 #include <EpochCore/Log.h>
 #include <EpochCore/FileSystem.h>
 #include "EpochAssets/AssetManager.h"
@@ -54,7 +55,6 @@ namespace Epoch::Assets
 		}
 
 		unsigned char* bitmap;
-		int bytesPerPixel = channels * (isHDR ? 4 : 1);
 
 		if (isHDR)
 		{
@@ -93,7 +93,7 @@ namespace Epoch::Assets
 			//}
 			case 4:
 			{
-				outTextureData.Format = isHDR ? ImageFormat::RGBA32F : ImageFormat::RGBA;
+				outTextureData.Format = isHDR ? ImageFormat::RGBA16F : ImageFormat::RGBA;
 				break;
 			}
 			default:
@@ -105,9 +105,23 @@ namespace Epoch::Assets
 			}
 		}
 
+		const size_t pixelCount = (size_t)width * (size_t)height;
+
 		outTextureData.Width = (uint32_t)width;
 		outTextureData.Height = (uint32_t)height;
-		outTextureData.Data = Core::Buffer::Copy({ (void*)bitmap, (uint64_t)(bytesPerPixel * width * height) });
+
+		if (isHDR)
+		{
+			// Half floats are plenty for HDR source images and take half the memory and upload bandwidth
+			outTextureData.Data.Allocate(pixelCount * 4 * sizeof(uint16_t));
+			CU::ConvertRGBA32FToRGBA16F(
+				std::span<const float>(reinterpret_cast<const float*>(bitmap), pixelCount * 4),
+				std::span<uint16_t>(static_cast<uint16_t*>(outTextureData.Data.data), pixelCount * 4));
+		}
+		else
+		{
+			outTextureData.Data = Core::Buffer::Copy({ (void*)bitmap, (uint64_t)(pixelCount * 4) });
+		}
 		stbi_image_free(bitmap);
 
 		outTextureData.FilterMode = aImportSettings.FilterMode;
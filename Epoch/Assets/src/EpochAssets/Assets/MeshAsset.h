@@ -1,5 +1,7 @@
 #pragma once
 #include <vector>
+#include <CommonUtilities/Math/Geometry/AABB.h>
+#include <EpochDataTypes/MeshBVH.h>
 #include <EpochDataTypes/MeshData.h>
 #include "EpochAssets/Asset.h"
 
@@ -15,12 +17,29 @@ namespace Epoch::Assets
 		AssetType GetAssetType() const override { return GetStaticType(); }
 
 		const DataTypes::MeshData& GetData() const { return myData; }
+		// Local space bounds of all vertices, invalid for an empty mesh
+		const CU::AABB& GetBounds() const { return myBounds; }
+		// Triangle BVH for exact raycasts in mesh space, built at import
+		const DataTypes::MeshBVH& GetBVH() const { return myBVH; }
 
 	private:
-		void SetData(DataTypes::MeshData&& aData) { myData = std::move(aData); }
+		void SetData(DataTypes::MeshData&& aData)
+		{
+			myData = std::move(aData);
+
+			myBounds = CU::AABB();
+			for (const auto& vertex : myData.Vertices)
+			{
+				myBounds.Encapsulate(vertex.Position);
+			}
+
+			myBVH.Build(myData);
+		}
 
 	private:
 		DataTypes::MeshData myData;
+		CU::AABB myBounds;
+		DataTypes::MeshBVH myBVH;
 
 		friend class MeshImporter;
 	};
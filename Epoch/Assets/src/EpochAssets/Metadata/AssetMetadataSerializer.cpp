@@ -128,6 +128,21 @@ namespace Epoch::Assets
 	}
 
 	AssetMetadata AssetMetadataSerializer::Deserialize(const std::filesystem::path& aPath)
+	{
+		std::vector<AssetMetadata> subAssets;
+		AssetMetadata metadata = Deserialize(aPath, subAssets);
+
+		auto assetManager = AssetManager::GetEditorAssetManager();
+		for (const AssetMetadata& subMeta : subAssets)
+		{
+			assetManager->RegisterMetadata(subMeta);
+			assetManager->RegisterSubAsset(metadata.Handle, subMeta.Handle);
+		}
+
+		return metadata;
+	}
+
+	AssetMetadata AssetMetadataSerializer::Deserialize(const std::filesystem::path& aPath, std::vector<AssetMetadata>& outSubAssets)
 	{
 		std::ifstream stream(aPath);
 		EPOCH_ASSERT((bool)stream, "Failed to deserialize metadata!");
@@ -148,17 +163,13 @@ namespace Epoch::Assets
 
 		if (node["SubAssets"])
 		{
-			auto assetManager = AssetManager::GetEditorAssetManager();
 			for (const auto& subNode : node["SubAssets"])
 			{
-				AssetMetadata subMeta;
+				AssetMetadata& subMeta = outSubAssets.emplace_back();
 				subMeta.Handle = subNode["Handle"].as<AssetHandle>();
 				subMeta.Type = Utils::AssetTypeFromString(subNode["Type"].as<std::string>());
 				subMeta.FilePath = subNode["Name"].as<std::string>();
 				subMeta.IsMemoryAsset = true;
-
-				assetManager->RegisterMetadata(subMeta);
-				assetManager->RegisterSubAsset(metadata.Handle, subMeta.Handle);
 			}
 		}
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <vector>
 #include "AssetMetadata.h"
 
 namespace YAML
@@ -35,6 +36,9 @@ namespace Epoch::Assets
 		static void Init();
 
 		static void Serialize(const std::filesystem::path& aPath, const AssetMetadata& aMetadata);
+		// Registers the sub assets with the editor asset manager
 		static AssetMetadata Deserialize(const std::filesystem::path& aPath);
+		// Returns the sub assets instead, for reading many files on several threads and registering them at once
+		static AssetMetadata Deserialize(const std::filesystem::path& aPath, std::vector<AssetMetadata>& outSubAssets);
 	};
 }
@@ -0,0 +1,311 @@
+#include "epch.h"
+#include "JobSystem.h"
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace Epoch::Core
+{
+	namespace
+	{
+		// Yields before a thread goes to sleep, new jobs often show up right after a queue runs empty
+		constexpr uint32_t SpinCount = 64;
+
+		struct alignas(64) JobQueue
+		{
+			std::mutex Mutex;
+			std::deque<Job> Jobs;
+		};
+
+		struct JobSystemData
+		{
+			std::vector<std::unique_ptr<JobQueue>> Queues;	// Indexed by worker, 0 is shared by the other threads
+			std::vector<std::thread> Workers;
+			std::atomic<uint32_t> QueuedJobs = 0;
+			std::atomic<bool> Stopping = false;
+
+			// Workers sleep until a job is queued, waiting threads until a job is queued or a counter is done
+			std::mutex SleepMutex;
+			std::condition_variable WakeUp;
+			std::atomic<uint32_t> SleepingThreads = 0;
+			std::atomic<uint32_t> SleepingWaiters = 0;
+		};
+
+		std::unique_ptr<JobSystemData> staticData;
+		thread_local uint32_t staticQueueIndex = 0;
+
+		bool HasWorkers()
+		{
+			return staticData && !staticData->Workers.empty();
+		}
+
+		bool TryPop(uint32_t aQueue, bool aOldest, Job& outJob)
+		{
+			JobQueue& queue = *staticData->Queues[aQueue];
+
+			std::scoped_lock lock(queue.Mutex);
+			if (queue.Jobs.empty()) return false;
+
+			if (aOldest)
+			{
+				outJob = queue.Jobs.front();
+				queue.Jobs.pop_front();
+			}
+			else
+			{
+				outJob = queue.Jobs.back();
+				queue.Jobs.pop_back();
+			}
+
+			staticData->QueuedJobs.fetch_sub(1);
+			return true;
+		}
+
+		void Push(const Job& aJob)
+		{
+			JobQueue& queue = *staticData->Queues[staticQueueIndex];
+			{
+				std::scoped_lock lock(queue.Mutex);
+				queue.Jobs.push_back(aJob);
+			}
+
+			staticData->QueuedJobs.fetch_add(1);
+			if (staticData->SleepingThreads.load() > 0)
+			{
+				std::scoped_lock lock(staticData->SleepMutex);
+				staticData->WakeUp.notify_one();
+			}
+		}
+	}
+
+	void JobSystem::Initialize(uint32_t aThreadCount)
+	{
+		EPOCH_ASSERT(!staticData, "The job system is already initialized!");
+
+		const uint32_t threadCount = aThreadCount > 0 ? aThreadCount : std::max(std::thread::hardware_concurrency(), 1u);
+
+		staticData = std::make_unique<JobSystemData>();
+		for (uint32_t i = 0; i < threadCount; ++i)
+		{
+			staticData->Queues.emplace_back(std::make_unique<JobQueue>());
+		}
+
+		for (uint32_t i = 1; i < threadCount; ++i)
+		{
+			staticData->Workers.emplace_back(RunWorker, i);
+		}
+	}
+
+	void JobSystem::Shutdown()
+	{
+		if (!staticData) return;
+
+		{
+			std::scoped_lock lock(staticData->SleepMutex);
+			staticData->Stopping.store(true);
+		}
+		staticData->WakeUp.notify_all();
+
+		for (std::thread& worker : staticData->Workers)
+		{
+			worker.join();
+		}
+		staticData->Workers.clear();
+
+		// Without workers the jobs started by these run right away
+		while (TryRunJob()) {}
+
+		staticData.reset();
+	}
+
+	bool JobSystem::IsInitialized()
+	{
+		return staticData != nullptr;
+	}
+
+	uint32_t JobSystem::GetThreadCount()
+	{
+		return staticData ? static_cast<uint32_t>(staticData->Workers.size()) + 1 : 1;
+	}
+
+	void JobSystem::Wait(JobCounter& aCounter)
+	{
+		if (!HasWorkers())
+		{
+			EPOCH_ASSERT(aCounter.IsDone(), "The counter can't finish without workers, it waits for a job that was never started!");
+		}
+		else
+		{
+			while (!aCounter.IsDone())
+			{
+				if (TryRunJob()) continue;
+
+				// The counter's jobs are running on other threads, or waiting for another counter
+				bool canContinue = false;
+				for (uint32_t i = 0; i < SpinCount && !canContinue; ++i)
+				{
+					std::this_thread::yield();
+					canContinue = aCounter.IsDone() || staticData->QueuedJobs.load() > 0;
+				}
+				if (canContinue) continue;
+
+				std::unique_lock lock(staticData->SleepMutex);
+				staticData->SleepingThreads.fetch_add(1);
+				staticData->SleepingWaiters.fetch_add(1);
+				staticData->WakeUp.wait(lock, [&aCounter]() { return aCounter.IsDone() || staticData->QueuedJobs.load() > 0; });
+				staticData->SleepingWaiters.fetch_sub(1);
+				staticData->SleepingThreads.fetch_sub(1);
+			}
+		}
+
+		// The last job may still hold the lock, the counter is only safe to destroy once it's released
+		std::scoped_lock lock(aCounter.myMutex);
+	}
+
+	void JobSystem::Hold(JobCounter& aCounter)
+	{
+		aCounter.myCount.fetch_add(1);
+	}
+
+	void JobSystem::Release(JobCounter& aCounter)
+	{
+		Finish(&aCounter);
+	}
+
+	void JobSystem::Submit(Job aJob)
+	{
+		if (JobCounter* counter = aJob.GetCounter())
+		{
+			counter->myCount.fetch_add(1);
+		}
+
+		Schedule(aJob);
+	}
+
+	void JobSystem::SubmitAfter(JobCounter& aDependency, Job aJob)
+	{
+		if (JobCounter* counter = aJob.GetCounter())
+		{
+			counter->myCount.fetch_add(1);
+		}
+
+		{
+			// The last job of the dependency takes the continuations with the lock held, one added here can't be missed
+			std::scoped_lock lock(aDependency.myMutex);
+			if (!aDependency.IsDone())
+			{
+				aDependency.myContinuations.emplace_back(aJob);
+				return;
+			}
+		}
+
+		Schedule(aJob);
+	}
+
+	void JobSystem::Schedule(const Job& aJob)
+	{
+		if (HasWorkers())
+		{
+			Push(aJob);
+			return;
+		}
+
+		Job job = aJob;
+		job.Execute();
+		Finish(job.GetCounter());
+	}
+
+	bool JobSystem::TryRunJob()
+	{
+		if (!staticData || staticData->QueuedJobs.load() == 0) return false;
+
+		// The newest job of the own queue, it's the one most likely still in the cache, or the oldest one of another queue
+		Job job;
+		bool found = TryPop(staticQueueIndex, false, job);
+
+		const uint32_t queueCount = static_cast<uint32_t>(staticData->Queues.size());
+		for (uint32_t i = 1; !found && i < queueCount; ++i)
+		{
+			found = TryPop((staticQueueIndex + i) % queueCount, true, job);
+		}
+
+		if (!found) return false;
+
+		job.Execute();
+		Finish(job.GetCounter());
+		return true;
+	}
+
+	void JobSystem::Finish(JobCounter* aCounter)
+	{
+		if (!aCounter) return;
+
+		uint32_t count = aCounter->myCount.load();
+		while (true)
+		{
+			EPOCH_ASSERT(count > 0, "Finished more jobs than were started with the counter!");
+
+			if (count > 1)
+			{
+				if (aCounter->myCount.compare_exchange_weak(count, count - 1)) return;
+				continue;
+			}
+
+			// The last job, unless another one was started with the counter since
+			std::vector<Job> continuations;
+			{
+				std::scoped_lock lock(aCounter->myMutex);
+				if (!aCounter->myCount.compare_exchange_strong(count, 0)) continue;
+				continuations.swap(aCounter->myContinuations);
+			}
+
+			// The counter may be gone from here on
+			for (const Job& continuation : continuations)
+			{
+				Schedule(continuation);
+			}
+
+			if (staticData && staticData->SleepingWaiters.load() > 0)
+			{
+				std::scoped_lock lock(staticData->SleepMutex);
+				staticData->WakeUp.notify_all();
+			}
+			return;
+		}
+	}
+
+	bool JobSystem::IsLocalQueueEmpty()
+	{
+		if (!staticData) return true;
+
+		JobQueue& queue = *staticData->Queues[staticQueueIndex];
+		std::scoped_lock lock(queue.Mutex);
+		return queue.Jobs.empty();
+	}
+
+	void JobSystem::RunWorker(uint32_t aIndex)
+	{
+		staticQueueIndex = aIndex;
+
+		const std::string name = "Job Worker " + std::to_string(aIndex);
+		EPOCH_PROFILE_THREAD(name.c_str());
+
+		while (!staticData->Stopping.load())
+		{
+			if (TryRunJob()) continue;
+
+			bool hasWork = false;
+			for (uint32_t i = 0; i < SpinCount && !hasWork; ++i)
+			{
+				std::this_thread::yield();
+				hasWork = staticData->QueuedJobs.load() > 0;
+			}
+			if (hasWork) continue;
+
+			std::unique_lock lock(staticData->SleepMutex);
+			staticData->SleepingThreads.fetch_add(1);
+			staticData->WakeUp.wait(lock, []() { return staticData->Stopping.load() || staticData->QueuedJobs.load() > 0; });
+			staticData->SleepingThreads.fetch_sub(1);
+		}
+	}
+}
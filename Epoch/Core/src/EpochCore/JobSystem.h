@@ -0,0 +1,195 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Epoch::Core
+{
+	class JobCounter;
+
+	// A function and the counter it finishes. Small trivially copyable functions, like lambdas capturing references and indices,
+	// are stored in the job itself, anything else is moved to the heap.
+	class Job
+	{
+	public:
+		Job() = default;
+
+		template<typename Function>
+		static Job Create(Function&& aFunction, JobCounter* aCounter);
+
+		// Only once, a function on the heap is freed after it ran
+		void Execute() { myInvoke(myStorage); }
+
+		JobCounter* GetCounter() const { return myCounter; }
+
+	private:
+		static constexpr size_t StorageSize = 48;
+
+		void(*myInvoke)(void*) = nullptr;
+		JobCounter* myCounter = nullptr;
+		alignas(std::max_align_t) std::byte myStorage[StorageSize];
+	};
+
+	// Counts the unfinished jobs started with it, JobSystem::Wait() returns once it reaches zero and
+	// JobSystem::RunAfter() holds jobs back until then. It can be reused once it's done,
+	// but it has to outlive its jobs, so don't destroy it without a Wait() first.
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+		~JobCounter() = default;
+
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		bool IsDone() const { return myCount.load() == 0; }
+
+	private:
+		std::atomic<uint32_t> myCount = 0;
+		std::mutex myMutex;
+		std::vector<Job> myContinuations;	// Started by the last job to finish
+
+		friend class JobSystem;
+	};
+
+	// Work stealing thread pool. Every worker has its own queue, it runs its newest job first and steals the oldest one
+	// of another queue when it runs out. Threads that aren't workers share one queue and run jobs too while they Wait().
+	// Jobs run on the calling thread right away if there are no workers.
+	class JobSystem
+	{
+	public:
+		// Threads running jobs including the calling one, 0 uses one per core
+		static void Initialize(uint32_t aThreadCount = 0);
+		// Runs the jobs still queued on the calling thread
+		static void Shutdown();
+
+		static bool IsInitialized();
+		// Workers and the calling thread, 1 when not initialized
+		static uint32_t GetThreadCount();
+
+		template<typename Function>
+		static void Run(Function&& aFunction, JobCounter* aCounter = nullptr);
+
+		// Queued once aDependency is done, right away if it already is. aCounter counts the job from now.
+		template<typename Function>
+		static void RunAfter(JobCounter& aDependency, Function&& aFunction, JobCounter* aCounter = nullptr);
+
+		// Runs queued jobs until the counter is done, sleeps only when there's nothing left to help with
+		static void Wait(JobCounter& aCounter);
+
+		// Counts work that isn't a job yet, so a counter handed out before its jobs are started isn't done meanwhile.
+		// Every Hold() needs a Release(), which finishes the counter like a job would if nothing else is left.
+		static void Hold(JobCounter& aCounter);
+		static void Release(JobCounter& aCounter);
+
+		// Calls aFunction(begin, end) for parts of [0, aCount) and returns once all of them are done, the calling thread runs a part too.
+		// The range is split in halves until every thread has a part, after that only while the splitting thread has nothing queued,
+		// so the parts get small when threads go idle and stay big when they don't. No part is smaller than aMinBatchSize.
+		template<typename Function>
+		static void ParallelFor(uint32_t aCount, Function&& aFunction, uint32_t aMinBatchSize = 1);
+
+	private:
+		template<typename FunctionType>
+		struct ParallelForRange
+		{
+			FunctionType* Function;
+			JobCounter Counter;
+			uint32_t EagerSize;
+			uint32_t BatchSize;
+		};
+
+		template<typename Function>
+		static void SplitRange(ParallelForRange<Function>& aRange, uint32_t aBegin, uint32_t aEnd);
+
+		static void Submit(Job aJob);
+		static void SubmitAfter(JobCounter& aDependency, Job aJob);
+		// Queues the job, or runs it right away without workers
+		static void Schedule(const Job& aJob);
+		static bool TryRunJob();
+		static void Finish(JobCounter* aCounter);
+		static bool IsLocalQueueEmpty();
+		static void RunWorker(uint32_t aIndex);
+	};
+
+	template<typename Function>
+	inline Job Job::Create(Function&& aFunction, JobCounter* aCounter)
+	{
+		using Type = std::decay_t<Function>;
+
+		Job job;
+		job.myCounter = aCounter;
+
+		if constexpr (sizeof(Type) <= StorageSize && alignof(Type) <= alignof(std::max_align_t) && std::is_trivially_copyable_v<Type>)
+		{
+			new (job.myStorage) Type(std::forward<Function>(aFunction));
+			job.myInvoke = [](void* aStorage) { (*std::launder(reinterpret_cast<Type*>(aStorage)))(); };
+		}
+		else
+		{
+			new (job.myStorage) Type*(new Type(std::forward<Function>(aFunction)));
+			job.myInvoke = [](void* aStorage)
+				{
+					Type* function = *std::launder(reinterpret_cast<Type**>(aStorage));
+					(*function)();
+					delete function;
+				};
+		}
+
+		return job;
+	}
+
+	template<typename Function>
+	inline void JobSystem::Run(Function&& aFunction, JobCounter* aCounter)
+	{
+		Submit(Job::Create(std::forward<Function>(aFunction), aCounter));
+	}
+
+	template<typename Function>
+	inline void JobSystem::RunAfter(JobCounter& aDependency, Function&& aFunction, JobCounter* aCounter)
+	{
+		SubmitAfter(aDependency, Job::Create(std::forward<Function>(aFunction), aCounter));
+	}
+
+	template<typename Function>
+	inline void JobSystem::ParallelFor(uint32_t aCount, Function&& aFunction, uint32_t aMinBatchSize)
+	{
+		if (aCount == 0) return;
+
+		aMinBatchSize = std::max(aMinBatchSize, 1u);
+
+		const uint32_t threadCount = GetThreadCount();
+		if (threadCount == 1 || aCount <= aMinBatchSize)
+		{
+			aFunction(0u, aCount);
+			return;
+		}
+
+		ParallelForRange<std::remove_reference_t<Function>> range;
+		range.Function = &aFunction;
+		range.EagerSize = std::max(aCount / threadCount, aMinBatchSize);
+		range.BatchSize = std::max(aCount / (threadCount * 8), aMinBatchSize);
+
+		SplitRange(range, 0, aCount);
+		Wait(range.Counter);
+	}
+
+	template<typename Function>
+	inline void JobSystem::SplitRange(ParallelForRange<Function>& aRange, uint32_t aBegin, uint32_t aEnd)
+	{
+		// The upper half is queued for someone to steal and the lower half split again
+		while (aEnd - aBegin > aRange.BatchSize && (aEnd - aBegin > aRange.EagerSize || IsLocalQueueEmpty()))
+		{
+			const uint32_t middle = aBegin + (aEnd - aBegin) / 2;
+			Run([&aRange, middle, aEnd]() { SplitRange(aRange, middle, aEnd); }, &aRange.Counter);
+			aEnd = middle;
+		}
+
+		(*aRange.Function)(aBegin, aEnd);
+	}
+}
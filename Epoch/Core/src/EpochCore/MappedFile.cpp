@@ -0,0 +1,127 @@
+#include "epch.h"
+#include "MappedFile.h"
+#include <utility>
+
+#ifndef PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Epoch::Core
+{
+	MappedFile::MappedFile(MappedFile&& aOther) noexcept
+	{
+		*this = std::move(aOther);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& aOther) noexcept
+	{
+		if (this != &aOther)
+		{
+			Close();
+
+			myData = std::exchange(aOther.myData, nullptr);
+			mySize = std::exchange(aOther.mySize, 0);
+#ifdef PLATFORM_WINDOWS
+			myFileHandle = std::exchange(aOther.myFileHandle, nullptr);
+			myMappingHandle = std::exchange(aOther.myMappingHandle, nullptr);
+#endif
+		}
+
+		return *this;
+	}
+
+#ifdef PLATFORM_WINDOWS
+	bool MappedFile::Open(const std::filesystem::path& aFilepath)
+	{
+		Close();
+
+		HANDLE file = CreateFileW(aFilepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!data)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		myFileHandle = file;
+		myMappingHandle = mapping;
+		myData = static_cast<const byte*>(data);
+		mySize = static_cast<uint64_t>(size.QuadPart);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (myData) UnmapViewOfFile(myData);
+		if (myMappingHandle) CloseHandle(myMappingHandle);
+		if (myFileHandle) CloseHandle(myFileHandle);
+
+		myData = nullptr;
+		mySize = 0;
+		myFileHandle = nullptr;
+		myMappingHandle = nullptr;
+	}
+#else
+	bool MappedFile::Open(const std::filesystem::path& aFilepath)
+	{
+		Close();
+
+		const int file = open(aFilepath.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			return false;
+		}
+
+		struct stat status;
+		if (fstat(file, &status) != 0 || status.st_size == 0)
+		{
+			close(file);
+			return false;
+		}
+
+		// The mapping keeps the file alive, the descriptor isn't needed after this
+		void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+
+		if (data == MAP_FAILED)
+		{
+			return false;
+		}
+
+		myData = static_cast<const byte*>(data);
+		mySize = static_cast<uint64_t>(status.st_size);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (myData) munmap(const_cast<byte*>(myData), static_cast<size_t>(mySize));
+
+		myData = nullptr;
+		mySize = 0;
+	}
+#endif
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include "Buffer.h"
+
+namespace Epoch::Core
+{
+	// Read-only view of a whole file mapped into memory. Nothing is copied, the OS pages the file in on first access.
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::filesystem::path& aFilepath) { Open(aFilepath); }
+		~MappedFile() { Close(); }
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& aOther) noexcept;
+		MappedFile& operator=(MappedFile&& aOther) noexcept;
+
+		// Fails for missing and empty files
+		bool Open(const std::filesystem::path& aFilepath);
+		void Close();
+
+		bool IsOpen() const { return myData != nullptr; }
+
+		const byte* GetData() const { return myData; }
+		uint64_t GetSize() const { return mySize; }
+		std::span<const byte> GetBytes() const { return { myData, static_cast<size_t>(mySize) }; }
+
+	private:
+		const byte* myData = nullptr;
+		uint64_t mySize = 0;
+
+#ifdef PLATFORM_WINDOWS
+		void* myFileHandle = nullptr;
+		void* myMappingHandle = nullptr;
+#endif
+	};
+}
@@ -5,8 +5,10 @@
 #define EPOCH_PROFILE_MARK_FRAME	FrameMark
 #define EPOCH_PROFILE_FUNC(...)		ZoneScoped##__VA_OPT__(N(__VA_ARGS__))
 #define EPOCH_PROFILE_SCOPE(NAME)	ZoneScoped; ZoneName(NAME, strlen(NAME))
+#define EPOCH_PROFILE_THREAD(NAME)	tracy::SetThreadName(NAME)
 #else
 #define EPOCH_PROFILE_MARK_FRAME
 #define EPOCH_PROFILE_FUNC(...)
 #define EPOCH_PROFILE_SCOPE(NAME)
+#define EPOCH_PROFILE_THREAD(NAME)
 #endif
@@ -1,13 +1,13 @@
 #include "epch.h"
 #include "UUID.h"
+#include <CommonUtilities/Math/RandomEngine.h>
 
 namespace Epoch
 {
-	static std::random_device staticRandomDevice;
-	static std::mt19937_64 staticEngine(staticRandomDevice());
-	static std::uniform_int_distribution<uint64_t> staticUniformDistribution;
+	// One randomly seeded stream per thread, so entities and assets can be created from any thread without locking.
+	static thread_local CU::RandomEngine staticEngine = CU::RandomEngine::CreateRandomlySeeded();
 
-	UUID::UUID() : myUUID(staticUniformDistribution(staticEngine)) {}
+	UUID::UUID() : myUUID(staticEngine.NextUInt64()) {}
 
 	UUID::UUID(uint64_t aUID) : myUUID(aUID) {}
 }
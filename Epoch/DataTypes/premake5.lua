@@ -1,6 +1,8 @@
 project "EpochDataTypes"
     kind "StaticLib"
 
+	apply_simd_flags()
+
     targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
     objdir ("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
 
@@ -0,0 +1,572 @@
+#include "MeshBVH.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <CommonUtilities/Math/Geometry/AABB.h>
+#include <CommonUtilities/Math/SIMD/SIMD.h>
+
+namespace Epoch::DataTypes
+{
+	namespace
+	{
+		constexpr uint32_t BinCount = 16;
+		constexpr uint32_t MaxLeafTriangles = 4;
+		// Cost of visiting a node relative to testing one triangle
+		constexpr float TraversalCost = 1.0f;
+		// Deeper nodes become leaves whatever their size, which bounds the traversal stacks
+		constexpr uint32_t MaxDepth = 48;
+		// A wide node pushes at most three children more than it pops
+		constexpr size_t StackSize = 3 * MaxDepth + 1;
+
+		struct BuildTriangle
+		{
+			CU::AABB Bounds;
+			CU::Vector3f Centroid;
+		};
+
+		struct Bin
+		{
+			CU::AABB Bounds;
+			uint32_t Count = 0;
+		};
+
+		struct StackEntry
+		{
+			uint32_t Node;
+			float Distance;
+		};
+
+		float GetAxis(const CU::Vector3f& aVector, uint32_t aAxis)
+		{
+			return aAxis == 0 ? aVector.x : (aAxis == 1 ? aVector.y : aVector.z);
+		}
+
+		uint32_t GetBin(float aCentroid, float aMin, float aScale)
+		{
+			return CU::Math::Min(static_cast<uint32_t>((aCentroid - aMin) * aScale), BinCount - 1);
+		}
+
+		// Entry and exit distance of one slab. A ray parallel to the slab with its origin on one of its planes
+		// gives 0 * inf = NaN, it runs along the boundary and the slab doesn't limit it, like a parallel ray inside.
+		void GetSlab(float aMin, float aMax, float aOrigin, float aInverseDirection, float& outNear, float& outFar)
+		{
+			const float t0 = (aMin - aOrigin) * aInverseDirection;
+			const float t1 = (aMax - aOrigin) * aInverseDirection;
+
+			if (std::isnan(t0) || std::isnan(t1))
+			{
+				outNear = -std::numeric_limits<float>::infinity();
+				outFar = std::numeric_limits<float>::infinity();
+				return;
+			}
+
+			outNear = CU::Math::Min(t0, t1);
+			outFar = CU::Math::Max(t0, t1);
+		}
+
+#if CU_SIMD_SSE
+		// GetSlab for four boxes. SSE min/max return the second operand if either is NaN,
+		// so NaN turns into -inf for the near and inf for the far distance.
+		CU_FORCEINLINE void GetSlab(__m128 aT0, __m128 aT1, __m128& outNear, __m128& outFar)
+		{
+			const __m128 infinity = _mm_set1_ps(std::numeric_limits<float>::infinity());
+			const __m128 negativeInfinity = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+			outNear = _mm_min_ps(_mm_max_ps(aT0, negativeInfinity), _mm_max_ps(aT1, negativeInfinity));
+			outFar = _mm_max_ps(_mm_min_ps(aT0, infinity), _mm_min_ps(aT1, infinity));
+		}
+#endif
+
+		// Slab test, outDistance is clamped to 0 for rays starting inside
+		bool IntersectBox(const CU::Vector3f& aMin, const CU::Vector3f& aMax, const CU::Vector3f& aOrigin, const CU::Vector3f& aInverseDirection, float aMaxDistance, float& outDistance)
+		{
+			float nearX, farX, nearY, farY, nearZ, farZ;
+			GetSlab(aMin.x, aMax.x, aOrigin.x, aInverseDirection.x, nearX, farX);
+			GetSlab(aMin.y, aMax.y, aOrigin.y, aInverseDirection.y, nearY, farY);
+			GetSlab(aMin.z, aMax.z, aOrigin.z, aInverseDirection.z, nearZ, farZ);
+
+			const float entryDistance = CU::Math::Max(CU::Math::Max(nearX, nearY), CU::Math::Max(nearZ, 0.0f));
+			const float exitDistance = CU::Math::Min(CU::Math::Min(farX, farY), CU::Math::Min(farZ, aMaxDistance));
+
+			outDistance = entryDistance;
+			return entryDistance <= exitDistance;
+		}
+	}
+
+	void MeshBVH::Build(const MeshData& aData, Layout aLayout)
+	{
+		Clear();
+		myLayout = aLayout;
+
+		const uint32_t triangleCount = static_cast<uint32_t>(aData.Indices.size() / 3);
+		if (triangleCount == 0) return;
+
+		std::vector<BuildTriangle> triangles(triangleCount);
+		for (uint32_t i = 0; i < triangleCount; ++i)
+		{
+			BuildTriangle& triangle = triangles[i];
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				triangle.Bounds.Encapsulate(aData.Vertices[aData.Indices[i * 3 + corner]].Position);
+			}
+			triangle.Centroid = triangle.Bounds.GetCenter();
+		}
+
+		std::vector<uint32_t> order(triangleCount);
+		std::iota(order.begin(), order.end(), 0u);
+
+		// Children are allocated in pairs, a tree over n triangles has at most 2n - 1 nodes
+		myNodes.reserve(triangleCount * 2);
+		myNodes.emplace_back().TriangleCount = triangleCount;
+
+		struct BuildEntry
+		{
+			uint32_t Node;
+			uint32_t Depth;
+		};
+		std::vector<BuildEntry> stack;
+		stack.push_back({ 0, 0 });
+
+		while (!stack.empty())
+		{
+			const BuildEntry entry = stack.back();
+			stack.pop_back();
+
+			// LeftOrFirst and TriangleCount hold the node's range of order until it's split
+			const uint32_t first = myNodes[entry.Node].LeftOrFirst;
+			const uint32_t count = myNodes[entry.Node].TriangleCount;
+
+			CU::AABB bounds;
+			CU::AABB centroidBounds;
+			for (uint32_t i = first; i < first + count; ++i)
+			{
+				bounds.Encapsulate(triangles[order[i]].Bounds);
+				centroidBounds.Encapsulate(triangles[order[i]].Centroid);
+			}
+			myNodes[entry.Node].Min = bounds.min;
+			myNodes[entry.Node].Max = bounds.max;
+
+			if (count <= 1 || entry.Depth >= MaxDepth) continue;
+
+			// Costs are scaled by the node's area, which doesn't change which split is cheapest
+			const float nodeArea = bounds.GetSurfaceArea();
+			const float leafCost = count * nodeArea;
+
+			float bestCost = FLT_MAX;
+			uint32_t bestAxis = 0;
+			uint32_t bestSplit = 0;
+
+			for (uint32_t axis = 0; axis < 3; ++axis)
+			{
+				const float min = GetAxis(centroidBounds.min, axis);
+				const float extent = GetAxis(centroidBounds.max, axis) - min;
+				if (extent <= 0.0f) continue;
+
+				const float scale = BinCount / extent;
+
+				std::array<Bin, BinCount> bins;
+				for (uint32_t i = first; i < first + count; ++i)
+				{
+					const BuildTriangle& triangle = triangles[order[i]];
+					Bin& bin = bins[GetBin(GetAxis(triangle.Centroid, axis), min, scale)];
+					bin.Bounds.Encapsulate(triangle.Bounds);
+					++bin.Count;
+				}
+
+				// Right side costs swept from the back, split i puts bins [0, i] on the left
+				std::array<float, BinCount - 1> rightCosts;
+				CU::AABB rightBounds;
+				uint32_t rightCount = 0;
+				for (uint32_t i = BinCount - 1; i > 0; --i)
+				{
+					rightBounds.Encapsulate(bins[i].Bounds);
+					rightCount += bins[i].Count;
+					rightCosts[i - 1] = rightCount > 0 ? rightCount * rightBounds.GetSurfaceArea() : 0.0f;
+				}
+
+				CU::AABB leftBounds;
+				uint32_t leftCount = 0;
+				for (uint32_t i = 0; i < BinCount - 1; ++i)
+				{
+					leftBounds.Encapsulate(bins[i].Bounds);
+					leftCount += bins[i].Count;
+					if (leftCount == 0 || leftCount == count) continue;
+
+					const float cost = TraversalCost * nodeArea + leftCount * leftBounds.GetSurfaceArea() + rightCosts[i];
+					if (cost < bestCost)
+					{
+						bestCost = cost;
+						bestAxis = axis;
+						bestSplit = i;
+					}
+				}
+			}
+
+			const bool hasSplit = bestCost < FLT_MAX;
+			if (count <= MaxLeafTriangles && (!hasSplit || bestCost >= leafCost)) continue;
+
+			uint32_t leftCount;
+			if (hasSplit)
+			{
+				const float min = GetAxis(centroidBounds.min, bestAxis);
+				const float scale = BinCount / (GetAxis(centroidBounds.max, bestAxis) - min);
+
+				auto middle = std::partition(order.begin() + first, order.begin() + first + count, [&](uint32_t aTriangle)
+					{
+						return GetBin(GetAxis(triangles[aTriangle].Centroid, bestAxis), min, scale) <= bestSplit;
+					});
+				leftCount = static_cast<uint32_t>(middle - order.begin()) - first;
+			}
+			else
+			{
+				// Every centroid in the same spot, any split is as good as another
+				leftCount = count / 2;
+			}
+
+			const uint32_t left = static_cast<uint32_t>(myNodes.size());
+			myNodes.emplace_back();
+			myNodes.emplace_back();
+
+			myNodes[left].LeftOrFirst = first;
+			myNodes[left].TriangleCount = leftCount;
+			myNodes[left + 1].LeftOrFirst = first + leftCount;
+			myNodes[left + 1].TriangleCount = count - leftCount;
+
+			myNodes[entry.Node].LeftOrFirst = left;
+			myNodes[entry.Node].TriangleCount = 0;
+
+			stack.push_back({ left + 1, entry.Depth + 1 });
+			stack.push_back({ left, entry.Depth + 1 });
+		}
+
+		myTriangles.resize(triangleCount);
+		for (uint32_t i = 0; i < triangleCount; ++i)
+		{
+			const uint32_t index = order[i];
+			const CU::Vector3f& vertex0 = aData.Vertices[aData.Indices[index * 3 + 0]].Position;
+			const CU::Vector3f& vertex1 = aData.Vertices[aData.Indices[index * 3 + 1]].Position;
+			const CU::Vector3f& vertex2 = aData.Vertices[aData.Indices[index * 3 + 2]].Position;
+
+			myTriangles[i] = { vertex0, vertex1 - vertex0, vertex2 - vertex0, index };
+		}
+
+		if (myLayout == Layout::Wide)
+		{
+			Collapse();
+			myNodes = std::vector<Node>();
+		}
+		else
+		{
+			myNodes.shrink_to_fit();
+		}
+	}
+
+	void MeshBVH::Clear()
+	{
+		myNodes.clear();
+		myWideNodes.clear();
+		myTriangles.clear();
+	}
+
+	void MeshBVH::Collapse()
+	{
+		myWideNodes.reserve(myNodes.size() / 2 + 1);
+		myWideNodes.emplace_back();
+
+		struct CollapseEntry
+		{
+			uint32_t Node;
+			uint32_t WideNode;
+		};
+		std::vector<CollapseEntry> stack;
+		stack.push_back({ 0, 0 });
+
+		while (!stack.empty())
+		{
+			const CollapseEntry entry = stack.back();
+			stack.pop_back();
+
+			// A leaf root is the only child of the wide root
+			std::array<uint32_t, 4> children = { entry.Node };
+			uint32_t childCount = 1;
+			if (myNodes[entry.Node].TriangleCount == 0)
+			{
+				children = { myNodes[entry.Node].LeftOrFirst, myNodes[entry.Node].LeftOrFirst + 1 };
+				childCount = 2;
+			}
+
+			// Opens the inner child with the largest area until all four slots are used
+			while (childCount < 4)
+			{
+				int32_t largest = -1;
+				float largestArea = -1.0f;
+				for (uint32_t i = 0; i < childCount; ++i)
+				{
+					const Node& child = myNodes[children[i]];
+					if (child.TriangleCount > 0) continue;
+
+					const float area = CU::AABB(child.Min, child.Max).GetSurfaceArea();
+					if (area > largestArea)
+					{
+						largest = static_cast<int32_t>(i);
+						largestArea = area;
+					}
+				}
+				if (largest < 0) break;
+
+				const uint32_t opened = myNodes[children[largest]].LeftOrFirst;
+				children[largest] = opened;
+				children[childCount++] = opened + 1;
+			}
+
+			WideNode wide = {};
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				if (i >= childCount)
+				{
+					wide.Child[i] = UnusedChild;
+					continue;
+				}
+
+				const Node& child = myNodes[children[i]];
+				wide.MinX[i] = child.Min.x;
+				wide.MinY[i] = child.Min.y;
+				wide.MinZ[i] = child.Min.z;
+				wide.MaxX[i] = child.Max.x;
+				wide.MaxY[i] = child.Max.y;
+				wide.MaxZ[i] = child.Max.z;
+				wide.TriangleCount[i] = child.TriangleCount;
+
+				if (child.TriangleCount > 0)
+				{
+					wide.Child[i] = child.LeftOrFirst;
+				}
+				else
+				{
+					wide.Child[i] = static_cast<uint32_t>(myWideNodes.size());
+					myWideNodes.emplace_back();
+					stack.push_back({ children[i], wide.Child[i] });
+				}
+			}
+			myWideNodes[entry.WideNode] = wide;
+		}
+
+		myWideNodes.shrink_to_fit();
+	}
+
+	bool MeshBVH::Raycast(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance, Hit& outHit) const
+	{
+		if (myTriangles.empty()) return false;
+
+		return myLayout == Layout::Wide ?
+			RaycastWide(aOrigin, aDirection, aMaxDistance, outHit) :
+			RaycastBinary(aOrigin, aDirection, aMaxDistance, outHit);
+	}
+
+	bool MeshBVH::RaycastBinary(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance, Hit& outHit) const
+	{
+		const CU::Vector3f inverseDirection(1.0f / aDirection.x, 1.0f / aDirection.y, 1.0f / aDirection.z);
+
+		Hit hit;
+		hit.Distance = aMaxDistance;
+		bool found = false;
+
+		float rootDistance;
+		if (!IntersectBox(myNodes[0].Min, myNodes[0].Max, aOrigin, inverseDirection, hit.Distance, rootDistance)) return false;
+
+		std::array<StackEntry, StackSize> stack;
+		size_t stackSize = 0;
+		stack[stackSize++] = { 0, rootDistance };
+
+		while (stackSize > 0)
+		{
+			const StackEntry entry = stack[--stackSize];
+
+			// A closer hit may have clipped the ray since this node was pushed
+			if (entry.Distance > hit.Distance) continue;
+
+			const Node& node = myNodes[entry.Node];
+			if (node.TriangleCount > 0)
+			{
+				found |= IntersectTriangles(aOrigin, aDirection, node.LeftOrFirst, node.TriangleCount, hit);
+				continue;
+			}
+
+			const Node& left = myNodes[node.LeftOrFirst];
+			const Node& right = myNodes[node.LeftOrFirst + 1];
+
+			float leftDistance, rightDistance;
+			const bool hitLeft = IntersectBox(left.Min, left.Max, aOrigin, inverseDirection, hit.Distance, leftDistance);
+			const bool hitRight = IntersectBox(right.Min, right.Max, aOrigin, inverseDirection, hit.Distance, rightDistance);
+
+			// The far child goes on the stack first so the near one is visited first
+			if (hitLeft && hitRight)
+			{
+				if (leftDistance <= rightDistance)
+				{
+					stack[stackSize++] = { node.LeftOrFirst + 1, rightDistance };
+					stack[stackSize++] = { node.LeftOrFirst, leftDistance };
+				}
+				else
+				{
+					stack[stackSize++] = { node.LeftOrFirst, leftDistance };
+					stack[stackSize++] = { node.LeftOrFirst + 1, rightDistance };
+				}
+			}
+			else if (hitLeft)
+			{
+				stack[stackSize++] = { node.LeftOrFirst, leftDistance };
+			}
+			else if (hitRight)
+			{
+				stack[stackSize++] = { node.LeftOrFirst + 1, rightDistance };
+			}
+		}
+
+		if (found) outHit = hit;
+		return found;
+	}
+
+	bool MeshBVH::RaycastWide(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance, Hit& outHit) const
+	{
+		const CU::Vector3f inverseDirection(1.0f / aDirection.x, 1.0f / aDirection.y, 1.0f / aDirection.z);
+
+#if CU_SIMD_SSE
+		const __m128 originX = _mm_set1_ps(aOrigin.x);
+		const __m128 originY = _mm_set1_ps(aOrigin.y);
+		const __m128 originZ = _mm_set1_ps(aOrigin.z);
+		const __m128 inverseX = _mm_set1_ps(inverseDirection.x);
+		const __m128 inverseY = _mm_set1_ps(inverseDirection.y);
+		const __m128 inverseZ = _mm_set1_ps(inverseDirection.z);
+		const __m128i unused = _mm_set1_epi32(static_cast<int>(UnusedChild));
+#endif
+
+		Hit hit;
+		hit.Distance = aMaxDistance;
+		bool found = false;
+
+		std::array<StackEntry, StackSize> stack;
+		size_t stackSize = 0;
+		stack[stackSize++] = { 0, 0.0f };
+
+		while (stackSize > 0)
+		{
+			const StackEntry entry = stack[--stackSize];
+			if (entry.Distance > hit.Distance) continue;
+
+			const WideNode& node = myWideNodes[entry.Node];
+
+			alignas(16) std::array<float, 4> distances;
+			uint32_t hitMask = 0;
+
+#if CU_SIMD_SSE
+			const __m128 x0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MinX), originX), inverseX);
+			const __m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MaxX), originX), inverseX);
+			const __m128 y0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MinY), originY), inverseY);
+			const __m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MaxY), originY), inverseY);
+			const __m128 z0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MinZ), originZ), inverseZ);
+			const __m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MaxZ), originZ), inverseZ);
+
+			__m128 nearX, farX, nearY, farY, nearZ, farZ;
+			GetSlab(x0, x1, nearX, farX);
+			GetSlab(y0, y1, nearY, farY);
+			GetSlab(z0, z1, nearZ, farZ);
+
+			const __m128 entryDistance = _mm_max_ps(_mm_max_ps(nearX, nearY), _mm_max_ps(nearZ, _mm_setzero_ps()));
+			const __m128 exitDistance = _mm_min_ps(_mm_min_ps(farX, farY), _mm_min_ps(farZ, _mm_set1_ps(hit.Distance)));
+
+			const int unusedMask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(node.Child)), unused)));
+			hitMask = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(entryDistance, exitDistance)) & ~unusedMask);
+			_mm_store_ps(distances.data(), entryDistance);
+#else
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				if (node.Child[i] == UnusedChild) continue;
+
+				const CU::Vector3f min(node.MinX[i], node.MinY[i], node.MinZ[i]);
+				const CU::Vector3f max(node.MaxX[i], node.MaxY[i], node.MaxZ[i]);
+				if (IntersectBox(min, max, aOrigin, inverseDirection, hit.Distance, distances[i]))
+				{
+					hitMask |= 1u << i;
+				}
+			}
+#endif
+
+			if (hitMask == 0) continue;
+
+			// Hit children sorted near to far
+			std::array<uint32_t, 4> order;
+			uint32_t hitCount = 0;
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				if ((hitMask & (1u << i)) == 0) continue;
+
+				uint32_t slot = hitCount++;
+				while (slot > 0 && distances[order[slot - 1]] > distances[i])
+				{
+					order[slot] = order[slot - 1];
+					--slot;
+				}
+				order[slot] = i;
+			}
+
+			// Leaves are tested right away so the closer hits clip the inner nodes pushed after them
+			for (uint32_t i = 0; i < hitCount; ++i)
+			{
+				const uint32_t child = order[i];
+				if (node.TriangleCount[child] > 0 && distances[child] <= hit.Distance)
+				{
+					found |= IntersectTriangles(aOrigin, aDirection, node.Child[child], node.TriangleCount[child], hit);
+				}
+			}
+
+			for (uint32_t i = hitCount; i > 0; --i)
+			{
+				const uint32_t child = order[i - 1];
+				if (node.TriangleCount[child] == 0)
+				{
+					stack[stackSize++] = { node.Child[child], distances[child] };
+				}
+			}
+		}
+
+		if (found) outHit = hit;
+		return found;
+	}
+
+	bool MeshBVH::IntersectTriangles(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, uint32_t aFirst, uint32_t aCount, Hit& ioHit) const
+	{
+		bool found = false;
+
+		for (uint32_t i = aFirst; i < aFirst + aCount; ++i)
+		{
+			const Triangle& triangle = myTriangles[i];
+
+			const CU::Vector3f p = aDirection.Cross(triangle.Edge2);
+			const float determinant = triangle.Edge1.Dot(p);
+			// Parallel to the triangle's plane
+			if (determinant == 0.0f) continue;
+
+			const float inverseDeterminant = 1.0f / determinant;
+			const CU::Vector3f s = aOrigin - triangle.Vertex0;
+			const float u = s.Dot(p) * inverseDeterminant;
+			if (u < 0.0f || u > 1.0f) continue;
+
+			const CU::Vector3f q = s.Cross(triangle.Edge1);
+			const float v = aDirection.Dot(q) * inverseDeterminant;
+			if (v < 0.0f || u + v > 1.0f) continue;
+
+			const float distance = triangle.Edge2.Dot(q) * inverseDeterminant;
+			if (distance < 0.0f || distance >= ioHit.Distance) continue;
+
+			ioHit.Distance = distance;
+			ioHit.Triangle = triangle.Index;
+			ioHit.U = u;
+			ioHit.V = v;
+			found = true;
+		}
+
+		return found;
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+#include <CommonUtilities/Math/Vector/Vector.h>
+#include "MeshData.h"
+
+namespace Epoch::DataTypes
+{
+	// Triangle BVH over all submeshes of a mesh for exact ray hits, built once at import and kept next to the mesh data.
+	// The tree is built top down with a binned surface area heuristic. The wide layout collapses it into nodes with four children
+	// whose boxes are tested at once with SSE, the binary layout keeps the compact two child nodes.
+	// Triangles are stored reordered into leaf order as one vertex and two edges, ready for the Moller-Trumbore test.
+	class MeshBVH
+	{
+	public:
+		enum class Layout : uint8_t { Binary, Wide };
+
+		struct Hit
+		{
+			float Distance = FLT_MAX;
+			uint32_t Triangle = 0;	// The triangle's indices start at MeshData::Indices[Triangle * 3]
+			float U = 0.0f;			// Barycentric weight of the triangle's second vertex
+			float V = 0.0f;			// Barycentric weight of the triangle's third vertex
+		};
+
+		MeshBVH() = default;
+		explicit MeshBVH(const MeshData& aData, Layout aLayout = Layout::Wide) { Build(aData, aLayout); }
+
+		void Build(const MeshData& aData, Layout aLayout = Layout::Wide);
+		void Clear();
+
+		// Closest triangle hit within aMaxDistance, triangles are hit from both sides.
+		// Distances are in units of aDirection's length, a world space ray transformed into mesh space
+		// by the inverse world matrix without normalizing its direction still gets world space distances.
+		bool Raycast(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance, Hit& outHit) const;
+
+		bool IsEmpty() const { return myTriangles.empty(); }
+		Layout GetLayout() const { return myLayout; }
+		size_t GetTriangleCount() const { return myTriangles.size(); }
+		size_t GetNodeCount() const { return myLayout == Layout::Wide ? myWideNodes.size() : myNodes.size(); }
+		size_t GetMemoryUsage() const { return myNodes.size() * sizeof(Node) + myWideNodes.size() * sizeof(WideNode) + myTriangles.size() * sizeof(Triangle); }
+
+	private:
+		struct Node
+		{
+			CU::Vector3f Min;
+			uint32_t LeftOrFirst = 0;		// The right child is LeftOrFirst + 1, first triangle for leaves
+			CU::Vector3f Max;
+			uint32_t TriangleCount = 0;		// 0 for inner nodes
+		};
+		static_assert(sizeof(Node) == 32);
+
+		struct alignas(16) WideNode
+		{
+			float MinX[4], MinY[4], MinZ[4];
+			float MaxX[4], MaxY[4], MaxZ[4];
+			uint32_t Child[4];				// Node index, first triangle for leaves and UnusedChild for empty slots
+			uint32_t TriangleCount[4];		// 0 for inner nodes
+		};
+		static_assert(sizeof(WideNode) == 128);
+
+		struct Triangle
+		{
+			CU::Vector3f Vertex0;
+			CU::Vector3f Edge1;
+			CU::Vector3f Edge2;
+			uint32_t Index;
+		};
+
+		static constexpr uint32_t UnusedChild = UINT32_MAX;
+
+		void Collapse();
+		bool RaycastBinary(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance, Hit& outHit) const;
+		bool RaycastWide(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, float aMaxDistance, Hit& outHit) const;
+		// Tests the triangles in [aFirst, aFirst + aCount) and shortens ioHit.Distance for every closer hit
+		bool IntersectTriangles(const CU::Vector3f& aOrigin, const CU::Vector3f& aDirection, uint32_t aFirst, uint32_t aCount, Hit& ioHit) const;
+
+	private:
+		std::vector<Node> myNodes;			// Root first, only kept for the binary layout
+		std::vector<WideNode> myWideNodes;	// Root first
+		std::vector<Triangle> myTriangles;
+		Layout myLayout = Layout::Wide;
+	};
+}
@@ -86,7 +86,10 @@ namespace Epoch
 		RG16F,
 		RG16UNORM,
 
-		DEPTH32
+		DEPTH32,
+
+		// New formats go last so the values of the existing ones don't change
+		RGBA16F
 	};
 }
 
@@ -2,6 +2,7 @@
 #include "EpochCore/Input/Input.h"
 #include "EpochCore/Profiler.h"
 #include "EpochCore/FileSystem.h"
+#include "EpochCore/JobSystem.h"
 #include <EpochRendering/IRenderer.h>
 #include <EpochRendering/IImGuiRenderer.h>
 #include <EpochProjects/Project.h>
@@ -130,6 +131,7 @@ namespace Epoch
 		Input::Initialize(myWindow.get());
 
 		Core::FileSystem::Initialize();
+		Core::JobSystem::Initialize();
 
 		if (myInitCallback)
 		{
@@ -144,6 +146,7 @@ namespace Epoch
 			myShutdownCallback();
 		}
 
+		Core::JobSystem::Shutdown();
 		Core::FileSystem::Shutdown();
 	}
 
@@ -10,6 +10,8 @@
 #include "Resources/ConstantBuffer.h"
 
 #include <EpochCore/Window/Window.h>
+#include <EpochAssets/AssetManager.h>
+#include <EpochScenes/RenderProxy.h>
 
 //TEMP
 #include <nvrhi/utils.h>
@@ -68,6 +70,9 @@ namespace Epoch::Rendering
 			myRendererResources.FlatNormalTexture = std::make_shared<Texture2D>(spec);
 		}
 
+		// Until a texture is set, or while it loads
+		myTestTexture = myRendererResources.WhiteTexture;
+
 		//TEMP
 		myCommandList = RenderContext::Get().DeviceManager->GetDeviceHandle()->createCommandList();
 
@@ -99,7 +104,7 @@ namespace Epoch::Rendering
 
 
 		ConstantBufferSpecification cbs;
-		cbs.SizeInBytes = sizeof(CU::Matrix4x4f);
+		cbs.SizeInBytes = sizeof(CU::Matrix4x4f) * 2; // View projection and the world matrix of the current draw
 		myTestCamBuffer = std::make_shared<ConstantBuffer>(cbs);
 
 
@@ -179,27 +184,44 @@ namespace Epoch::Rendering
 		graphicsState.setFramebuffer(myTestPipelineState->GetTargetFrameBuffer()->GetHandle());
 		graphicsState.viewport.addViewportAndScissorRect(myTestPipelineState->GetTargetFrameBuffer()->GetHandle()->getFramebufferInfo().getViewport());
 		
-		nvrhi::VertexBufferBinding vbb = nvrhi::VertexBufferBinding()
-			.setBuffer(myTestMesh->GetVertexBuffer()->GetHandle())
-			.setSlot(0)
-			.setOffset(0);
-		graphicsState.addVertexBuffer(vbb);
-
-		nvrhi::IndexBufferBinding ibb = nvrhi::IndexBufferBinding()
-			.setBuffer(myTestMesh->GetIndexBuffer()->GetHandle())
-			.setFormat(nvrhi::Format::R32_UINT)
-			.setOffset(0);
-		graphicsState.setIndexBuffer(ibb);
-		
-		myCommandList->setGraphicsState(graphicsState);
-
-		const auto& subMeshses = myTestMesh->GetSubMeshes();
-		for (const auto& subMesh : subMeshses)
+		// The proxies are sorted by mesh, the buffers are only rebound when it changes
+		if (myRenderProxies)
 		{
-			auto drawArguments = nvrhi::DrawArguments()
-				.setVertexCount(subMesh.IndexCount)
-				.setStartIndexLocation(subMesh.IndexOffset);
-			myCommandList->drawIndexed(drawArguments);
+			AssetHandle boundMesh = 0;
+			Mesh* mesh = nullptr;
+
+			for (const Scenes::RenderProxy& proxy : myRenderProxies->GetReadList().Proxies)
+			{
+				if (proxy.Mesh != boundMesh)
+				{
+					boundMesh = proxy.Mesh;
+					mesh = GetMesh(proxy.Mesh);
+					if (!mesh) continue;
+
+					graphicsState.vertexBuffers.clear();
+					graphicsState.addVertexBuffer(nvrhi::VertexBufferBinding()
+						.setBuffer(mesh->GetVertexBuffer()->GetHandle())
+						.setSlot(0)
+						.setOffset(0));
+
+					graphicsState.setIndexBuffer(nvrhi::IndexBufferBinding()
+						.setBuffer(mesh->GetIndexBuffer()->GetHandle())
+						.setFormat(nvrhi::Format::R32_UINT)
+						.setOffset(0));
+				}
+
+				if (!mesh || proxy.SubMesh >= mesh->GetSubMeshes().size()) continue;
+
+				// Writing the buffer between draws needs the state to be set again
+				myCommandList->writeBuffer(myTestCamBuffer->GetHandle(), &proxy.Transform, sizeof(CU::Matrix4x4f), sizeof(CU::Matrix4x4f));
+				myCommandList->setGraphicsState(graphicsState);
+
+				const auto& subMesh = mesh->GetSubMeshes()[proxy.SubMesh];
+				auto drawArguments = nvrhi::DrawArguments()
+					.setVertexCount(subMesh.IndexCount)
+					.setStartIndexLocation(subMesh.IndexOffset);
+				myCommandList->drawIndexed(drawArguments);
+			}
 		}
 
 		myCommandList->endMarker();
@@ -233,6 +255,12 @@ namespace Epoch::Rendering
 
 	void Renderer::SetTexture(std::shared_ptr<Assets::TextureAsset> aTexture)
 	{
+		if (!aTexture)
+		{
+			myTestTexture = myRendererResources.WhiteTexture;
+			return;
+		}
+
 		const auto& textureData = aTexture->GetData();
 
 		TextureSpecification spec;
@@ -249,10 +277,19 @@ namespace Epoch::Rendering
 		myTestTexture = std::make_shared<Texture2D>(spec);
 	}
 	
-	void Renderer::SetMesh(std::shared_ptr<Assets::MeshAsset> aMesh)
+	Mesh* Renderer::GetMesh(AssetHandle aMesh)
 	{
-		const auto& data = aMesh->GetData();
+		if (auto it = myMeshes.find(aMesh); it != myMeshes.end())
+		{
+			return it->second.get();
+		}
+
+		// Not drawn until it's loaded, the frame doesn't wait for the import
+		auto asset = Assets::AssetManager::GetAssetAsync(TypedAssetHandle<Assets::MeshAsset>(aMesh)).Get();
+		if (!asset || !asset->GetData().IsValid()) return nullptr;
 
-		myTestMesh = std::make_shared<Mesh>("Test Mesh", data.Vertices, data.Indices, data.SubMeshes);
+		const auto& data = asset->GetData();
+		auto mesh = std::make_shared<Mesh>("Mesh", data.Vertices, data.Indices, data.SubMeshes);
+		return myMeshes.emplace(aMesh, std::move(mesh)).first->second.get();
 	}
 }
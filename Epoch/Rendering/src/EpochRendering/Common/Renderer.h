@@ -1,4 +1,6 @@
 #pragma once
+#include <unordered_map>
+#include <EpochAssets/AssetHandle.h>
 #include "EpochRendering/IRenderer.h"
 #include "DeviceManager.h"
 #include "SwapChain.h"
@@ -14,7 +16,6 @@ namespace Epoch
 	namespace Assets
 	{
 		class TextureAsset;
-		class MeshAsset;
 	}
 }
 
@@ -40,9 +41,14 @@ namespace Epoch::Rendering
 
 		void SetClearColor(const CU::Color& aColor) override;
 
+		void SetRenderProxies(const Scenes::RenderProxyBuffer* aProxies) override { myRenderProxies = aProxies; }
+
 		//TEMP
 		void SetTexture(std::shared_ptr<Assets::TextureAsset> aTexture) override;
-		void SetMesh(std::shared_ptr<Assets::MeshAsset> aMesh) override;
+
+	private:
+		// Created from the mesh asset the first time it's drawn, nullptr while the asset isn't loaded
+		Mesh* GetMesh(AssetHandle aMesh);
 
 	private:
 		std::unique_ptr<DeviceManager> myDeviceManager;
@@ -55,6 +61,9 @@ namespace Epoch::Rendering
 			std::shared_ptr<Texture2D> FlatNormalTexture;
 		} myRendererResources;
 
+		const Scenes::RenderProxyBuffer* myRenderProxies = nullptr;
+		std::unordered_map<AssetHandle, std::shared_ptr<Mesh>> myMeshes;
+
 		//TEMP
 		CU::Color myClearColor = CU::Color::Black;
 
@@ -63,7 +72,6 @@ namespace Epoch::Rendering
 		std::shared_ptr<Shader> myTestShader;
 		std::shared_ptr<PipelineState> myTestPipelineState;
 
-		std::shared_ptr<Mesh> myTestMesh;
 		std::shared_ptr<ConstantBuffer> myTestCamBuffer;
 		std::shared_ptr<Texture2D> myTestTexture;
 	};
@@ -11,6 +11,7 @@ namespace Epoch::Rendering
 			switch (aFormat)
 			{
 				case ImageFormat::RGBA:			return 4;
+				case ImageFormat::RGBA16F:		return 4 * sizeof(uint16_t);
 				case ImageFormat::RGBA32F:		return 4 * sizeof(uint32_t);
 				case ImageFormat::R11G11B10F:	return 4;
 				case ImageFormat::RG16F:			return 2 * sizeof(uint16_t);
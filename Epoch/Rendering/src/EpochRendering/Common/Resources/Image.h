@@ -12,6 +12,7 @@ namespace Epoch::Rendering
 			switch (aFormat)
 			{
 				case ImageFormat::RGBA:				return nvrhi::Format::RGBA8_UNORM;
+				case ImageFormat::RGBA16F:			return nvrhi::Format::RGBA16_FLOAT;
 				case ImageFormat::RGBA32F:			return nvrhi::Format::RGBA32_FLOAT;
 				case ImageFormat::R11G11B10F:		return nvrhi::Format::R11G11B10_FLOAT;
 				case ImageFormat::RG16F:			return nvrhi::Format::RG16_FLOAT;
@@ -9,7 +9,11 @@ namespace Epoch
 	namespace Assets
 	{
 		class TextureAsset;
-		class MeshAsset;
+	}
+
+	namespace Scenes
+	{
+		class RenderProxyBuffer;
 	}
 }
 
@@ -31,8 +35,10 @@ namespace Epoch::Rendering
 
 		virtual void SetClearColor(const CU::Color& aColor) = 0;
 
+		// The renderer draws the read list of the buffer every frame, the owner swaps it once the next frame's proxies are extracted
+		virtual void SetRenderProxies(const Scenes::RenderProxyBuffer* aProxies) = 0;
+
 		//TEMP
 		virtual void SetTexture(std::shared_ptr<Assets::TextureAsset> aTexture) = 0;
-		virtual void SetMesh(std::shared_ptr<Assets::MeshAsset> aMesh) = 0;
 	};
 }
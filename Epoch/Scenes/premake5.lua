@@ -31,12 +31,14 @@ project "EpochScenes"
 		"%{wks.location}/Epoch/Core/src",
 		"%{wks.location}/Epoch/DataTypes/src",
 		"%{wks.location}/Epoch/Assets/src",
+		"%{wks.location}/Epoch/Serialization/src",
     }
 
     links
 	{
         "EpochCore",
         "EpochAssets",
+		"EpochSerialization",
 
 		"yaml-cpp",
     }
@@ -1,7 +1,7 @@
 #pragma once
 #include <string>
 #include <entt/entt.hpp>
-#include <CommonUtilities/Math/Transform.h>
+#include <CommonUtilities/Math/CompactTransform.h>
 #include <EpochCore/UUID.h>
 
 #include <EpochAssets/Assets/MeshAsset.h>
@@ -30,28 +30,39 @@ namespace Epoch::Scenes
 		NameComponent(const std::string& aName) : Name(aName) {}
 	};
 
+	// Only the local transform, 40 bytes so hierarchy updates stream as many as possible through the cache.
+	// Code still using CU::Transform can convert both ways (CompactTransform(transform) / LocalTransform.ToTransform()).
 	struct TransformComponent
 	{
-		CU::Transform LocalTransform;
-		CU::Matrix4x4f WorldMatrix;
-
-		bool WorldDirty = true;
+		CU::CompactTransform LocalTransform;
 
 		TransformComponent() = default;
+		TransformComponent(const CU::CompactTransform& aTransform) : LocalTransform(aTransform) {}
 		TransformComponent(const CU::Vector3f& aPosition, const CU::Vector3f& aRotation = CU::Vector3f::Zero, const CU::Vector3f& aScale = CU::Vector3f::One) : LocalTransform(aPosition, aRotation, aScale) {}
 	};
 
-	struct ParentComponent
+	// Written by the scene's TransformSystem, mark changed entities with Scene::MarkTransformDirty.
+	struct WorldTransformComponent
 	{
-		entt::entity Parent = entt::null;
+		CU::Matrix4x4f Matrix;
 
-		ParentComponent() = default;
-		ParentComponent(entt::entity aParent) : Parent(aParent) {}
+		// Set while the entity is queued for the next update
+		bool IsDirty = false;
 	};
 
-	struct ChildrenComponent
+	// Intrusive hierarchy links, every scene entity has one. The children of an entity form a doubly linked list
+	// through the siblings, so (re)parenting and ancestor queries never allocate or search a container.
+	// Only change it through Scene::ParentEntity/UnparentEntity.
+	struct HierarchyComponent
 	{
-		std::vector<entt::entity> Children;
+		entt::entity Parent = entt::null;
+		entt::entity FirstChild = entt::null;
+		entt::entity LastChild = entt::null;
+		entt::entity PrevSibling = entt::null;
+		entt::entity NextSibling = entt::null;
+
+		uint32_t ChildCount = 0;
+		uint32_t Depth = 0; // Roots are at depth 0
 	};
 
 	struct MeshRendererComponent
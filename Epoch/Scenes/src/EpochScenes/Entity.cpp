@@ -5,78 +5,42 @@ namespace Epoch::Scenes
 {
 	Entity Entity::GetParent() const
 	{
-		if (!HasParent()) return Entity{};
-		return { GetComponent<ParentComponent>().Parent, myScene };
+		return { GetComponent<HierarchyComponent>().Parent, myScene };
 	}
 
 	void Entity::SetParent(Entity aParent)
 	{
-		bool hasParent = HasParent();
+		if (GetParent() == aParent) return;
 
-		if (hasParent)
+		if (aParent)
 		{
-			Entity currentParent = { GetComponent<ParentComponent>().Parent, myScene };
-			if (currentParent == aParent)  return;
-
-			currentParent.RemoveChild(*this);
-		}
-
-		if (!aParent)
-		{
-			if (hasParent) RemoveComponent<ParentComponent>();
-			return;
-		}
-
-		if (!hasParent)
-		{
-			AddComponent<ParentComponent>(aParent);
+			myScene->ParentEntity(*this, aParent);
 		}
 		else
 		{
-			GetComponent<ParentComponent>().Parent = aParent;
+			myScene->UnparentEntity(*this);
 		}
-
-		aParent.GetOrAddComponent<ChildrenComponent>().Children.emplace_back(myEntityHandle);
 	}
 
 	void Entity::RemoveChild(Entity aChild)
 	{
-		if (!HasComponent<ChildrenComponent>()) return;
-		
-		auto& children = GetComponent<ChildrenComponent>().Children;
-		auto it = std::find(children.begin(), children.end(), aChild);
-		if (it != children.end())
-		{
-			children.erase(it);
-		}
+		if (aChild.GetParent() != *this) return;
 
-		if (children.empty())
-		{
-			RemoveComponent<ChildrenComponent>();
-		}
+		myScene->UnparentEntity(aChild);
 	}
 
 	bool Entity::IsAncestorOf(Entity aEntity) const
 	{
-		if (!HasComponent<ChildrenComponent>())
-		{
-			return false;
-		}
+		const uint32_t depth = GetDepth();
+		const auto& hierarchies = myScene->myRegistry.storage<HierarchyComponent>();
 
-		const auto& children = GetComponent<ChildrenComponent>().Children;
-		for (auto child : children)
+		// Only the ancestors of aEntity that are deeper than this entity have to be looked at
+		entt::entity ancestor = aEntity;
+		for (uint32_t ancestorDepth = aEntity.GetDepth(); ancestorDepth > depth; --ancestorDepth)
 		{
-			if (child == aEntity)
-			{
-				return true;
-			}
-
-			if (Entity(child, myScene).IsAncestorOf(aEntity))
-			{
-				return true;
-			}
+			ancestor = hierarchies.get(ancestor).Parent;
 		}
 
-		return false;
+		return ancestor == myEntityHandle && aEntity.myEntityHandle != myEntityHandle;
 	}
 }
@@ -36,10 +36,16 @@ namespace Epoch::Scenes
 		UUID GetUUID() { return GetComponent<IDComponent>().ID; }
 		const std::string& GetName() { return GetComponent<NameComponent>().Name; }
 
-		bool HasParent() const { return HasComponent<ParentComponent>(); }
+		bool HasParent() const { return GetComponent<HierarchyComponent>().Parent != entt::null; }
 		Entity GetParent() const;
 		void SetParent(Entity aParent);
 
+		// Children are visited with GetFirstChild() and GetNextSibling() until an invalid entity is returned
+		Entity GetFirstChild() const { return { GetComponent<HierarchyComponent>().FirstChild, myScene }; }
+		Entity GetNextSibling() const { return { GetComponent<HierarchyComponent>().NextSibling, myScene }; }
+		uint32_t GetChildCount() const { return GetComponent<HierarchyComponent>().ChildCount; }
+		uint32_t GetDepth() const { return GetComponent<HierarchyComponent>().Depth; }
+
 		void RemoveChild(Entity aChild);
 
 		bool IsAncestorOf(Entity aEntity) const;
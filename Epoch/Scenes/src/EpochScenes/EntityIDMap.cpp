@@ -0,0 +1,128 @@
+#include "EntityIDMap.h"
+#include <algorithm>
+#include <bit>
+
+namespace Epoch::Scenes
+{
+	namespace
+	{
+		constexpr size_t MinCapacity = 16;
+
+		// Fibonacci hashing, spreads sequential or otherwise structured IDs as well as random ones
+		constexpr uint64_t HashMultiplier = 0x9E3779B97F4A7C15ull;
+	}
+
+	void EntityIDMap::Reserve(size_t aCount)
+	{
+		// Kept at most half full, linear probing stays short at that load
+		const size_t capacity = std::bit_ceil(std::max(MinCapacity, aCount * 2));
+		if (capacity > mySlots.size())
+		{
+			Rehash(capacity);
+		}
+	}
+
+	void EntityIDMap::Insert(UUID aID, entt::entity aEntity)
+	{
+		if ((myCount + 1) * 2 > mySlots.size())
+		{
+			Rehash(std::max(MinCapacity, mySlots.size() * 2));
+		}
+
+		const uint64_t id = aID;
+		const size_t mask = mySlots.size() - 1;
+		for (size_t index = GetHomeSlot(id);; index = (index + 1) & mask)
+		{
+			Slot& slot = mySlots[index];
+			if (slot.Entity == entt::null)
+			{
+				slot.ID = id;
+				slot.Entity = aEntity;
+				++myCount;
+				return;
+			}
+
+			if (slot.ID == id)
+			{
+				slot.Entity = aEntity;
+				return;
+			}
+		}
+	}
+
+	bool EntityIDMap::Erase(UUID aID)
+	{
+		if (myCount == 0) return false;
+
+		const uint64_t id = aID;
+		const size_t mask = mySlots.size() - 1;
+
+		size_t hole = GetHomeSlot(id);
+		while (mySlots[hole].ID != id || mySlots[hole].Entity == entt::null)
+		{
+			if (mySlots[hole].Entity == entt::null) return false;
+			hole = (hole + 1) & mask;
+		}
+
+		// Moves back every following entry of the run that is allowed to sit in the hole,
+		// that is every entry whose home slot isn't between the hole and where it is now.
+		for (size_t index = (hole + 1) & mask; mySlots[index].Entity != entt::null; index = (index + 1) & mask)
+		{
+			const size_t home = GetHomeSlot(mySlots[index].ID);
+			if (((index - home) & mask) >= ((index - hole) & mask))
+			{
+				mySlots[hole] = mySlots[index];
+				hole = index;
+			}
+		}
+
+		mySlots[hole] = Slot();
+		--myCount;
+		return true;
+	}
+
+	void EntityIDMap::Clear()
+	{
+		std::fill(mySlots.begin(), mySlots.end(), Slot());
+		myCount = 0;
+	}
+
+	entt::entity EntityIDMap::Find(UUID aID) const
+	{
+		if (myCount == 0) return entt::null;
+
+		const uint64_t id = aID;
+		const size_t mask = mySlots.size() - 1;
+		for (size_t index = GetHomeSlot(id);; index = (index + 1) & mask)
+		{
+			const Slot& slot = mySlots[index];
+			if (slot.Entity == entt::null) return entt::null;
+			if (slot.ID == id) return slot.Entity;
+		}
+	}
+
+	size_t EntityIDMap::GetHomeSlot(uint64_t aID) const
+	{
+		return static_cast<size_t>((aID * HashMultiplier) >> myShift);
+	}
+
+	void EntityIDMap::Rehash(size_t aCapacity)
+	{
+		std::vector<Slot> oldSlots(aCapacity);
+		mySlots.swap(oldSlots);
+		myShift = 64 - std::countr_zero(aCapacity);
+
+		const size_t mask = aCapacity - 1;
+		for (const Slot& slot : oldSlots)
+		{
+			if (slot.Entity == entt::null) continue;
+
+			size_t index = GetHomeSlot(slot.ID);
+			while (mySlots[index].Entity != entt::null)
+			{
+				index = (index + 1) & mask;
+			}
+			mySlots[index] = slot;
+		}
+	}
+}
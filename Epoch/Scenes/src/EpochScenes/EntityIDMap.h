@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include <entt/entt.hpp>
+#include <EpochCore/UUID.h>
+
+namespace Epoch::Scenes
+{
+	// UUID -> entity lookup, open addressing with linear probing in one flat array.
+	// Insert and Erase don't allocate unless the table has to grow, erasing shifts the following entries back
+	// instead of leaving tombstones so lookups never slow down over time.
+	// The reverse direction is the IDComponent of the entity.
+	class EntityIDMap
+	{
+	public:
+		EntityIDMap() = default;
+		~EntityIDMap() = default;
+
+		// Makes room for aCount entries without growing
+		void Reserve(size_t aCount);
+
+		// Replaces the entity if the UUID is already in the map
+		void Insert(UUID aID, entt::entity aEntity);
+		bool Erase(UUID aID);
+		void Clear();
+
+		// entt::null if the UUID isn't in the map
+		entt::entity Find(UUID aID) const;
+		bool Contains(UUID aID) const { return Find(aID) != entt::null; }
+
+		size_t Size() const { return myCount; }
+
+	private:
+		struct Slot
+		{
+			uint64_t ID = 0;
+			entt::entity Entity = entt::null; // Null marks an empty slot, any ID is valid
+		};
+
+		size_t GetHomeSlot(uint64_t aID) const;
+		void Rehash(size_t aCapacity);
+
+	private:
+		std::vector<Slot> mySlots;
+		size_t myCount = 0;
+		uint32_t myShift = 64;
+	};
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <CommonUtilities/Math/Matrix/Matrix4x4.hpp>
+#include <EpochAssets/AssetHandle.h>
+
+namespace Epoch::Scenes
+{
+	// One submesh of a MeshRendererComponent entity, copied out of the scene so the renderer never touches the registry
+	struct RenderProxy
+	{
+		CU::Matrix4x4f Transform;
+		uint64_t SortKey = 0;
+		AssetHandle Mesh = 0;
+		uint32_t SubMesh = 0;
+	};
+
+	// The flat draw list of one frame, sorted by SortKey so the draws of a mesh are next to each other
+	struct RenderProxyList
+	{
+		std::vector<RenderProxy> Proxies;
+		// The RenderProxyTable::Sync() call that wrote the list last, 0 if it was filled some other way
+		uint64_t SyncedCount = 0;
+
+		// Mesh in the high bits and submesh in the low ones, the handle is folded since it's a random 64 bit ID
+		static uint64_t CreateSortKey(AssetHandle aMesh, uint32_t aSubMesh)
+		{
+			const uint64_t mesh = static_cast<uint64_t>(aMesh);
+			return ((mesh ^ (mesh >> 48)) << 16) | (aSubMesh & 0xFFFF);
+		}
+	};
+
+	// Two proxy lists, the simulation extracts frame N+1 into the write list while the renderer draws frame N from the read list.
+	// Swap() is the sync point between them, it must only be called once the extraction is done and the renderer is done reading.
+	class RenderProxyBuffer
+	{
+	public:
+		RenderProxyList& GetWriteList() { return myLists[myWriteIndex]; }
+		const RenderProxyList& GetReadList() const { return myLists[myWriteIndex ^ 1]; }
+
+		// The lists keep their capacity, a frame doesn't allocate once the scene stops growing
+		void Swap() { myWriteIndex ^= 1; }
+
+	private:
+		RenderProxyList myLists[2];
+		uint32_t myWriteIndex = 0;
+	};
+}
@@ -0,0 +1,264 @@
+#include "RenderProxyTable.h"
+#include <algorithm>
+#include <EpochCore/Assert.h>
+#include <EpochCore/Profiler.h>
+#include <EpochAssets/AssetManager.h>
+#include "Components.h"
+
+namespace Epoch::Scenes
+{
+	void RenderProxyTable::OnMeshRendererChanged(entt::registry& /*aRegistry*/, entt::entity aEntity)
+	{
+		myChangedEntities.emplace_back(aEntity);
+	}
+
+	void RenderProxyTable::OnMeshRendererRemoved(entt::registry& /*aRegistry*/, entt::entity aEntity)
+	{
+		myRemovedEntities.emplace_back(aEntity);
+	}
+
+	void RenderProxyTable::Update(const entt::registry& aRegistry, std::span<const entt::entity> aMovedEntities)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		if (!myChangedEntities.empty() || !myRemovedEntities.empty())
+		{
+			for (entt::entity entity : myRemovedEntities)
+			{
+				Remove(entity);
+			}
+
+			// The mesh may be another one now, the entity is added again at the end of its mesh's instances
+			for (entt::entity entity : myChangedEntities)
+			{
+				Remove(entity);
+				Add(aRegistry, entity);
+			}
+
+			myRemovedEntities.clear();
+			myChangedEntities.clear();
+
+			Layout(aRegistry);
+		}
+
+		if (myProxies.empty() || aMovedEntities.empty()) return;
+
+		const auto* worlds = aRegistry.storage<WorldTransformComponent>();
+		if (!worlds) return;
+
+		for (entt::entity entity : aMovedEntities)
+		{
+			const EntityRecord* record = GetRecord(entity);
+			if (!record) continue;
+
+			const MeshRun& run = myRuns[record->Run];
+			const CU::Matrix4x4f& matrix = worlds->get(entity).Matrix;
+
+			size_t row = run.Offset + record->Rank;
+			for (uint32_t subMesh = 0; subMesh < run.SubMeshCount; ++subMesh, row += run.LaidOutCount)
+			{
+				myProxies[row].Transform = matrix;
+				myDirtyRows.emplace_back(static_cast<uint32_t>(row));
+			}
+		}
+
+		// Nothing is syncing the table, patching a list would cost more than copying it by now
+		if (myDirtyRows.size() > myProxies.size())
+		{
+			myDirtyRows.clear();
+			myLayoutSync = mySyncCount + 1;
+		}
+	}
+
+	void RenderProxyTable::Rebuild(const entt::registry& aRegistry)
+	{
+		Clear();
+
+		if (const auto* renderers = aRegistry.storage<MeshRendererComponent>())
+		{
+			myChangedEntities.assign(renderers->data(), renderers->data() + renderers->size());
+		}
+
+		Update(aRegistry, {});
+	}
+
+	void RenderProxyTable::Sync(RenderProxyList& outList)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		const uint64_t sync = ++mySyncCount;
+
+		const bool sameLayout = outList.SyncedCount != 0 && outList.SyncedCount >= myLayoutSync && outList.Proxies.size() == myProxies.size();
+		const bool missedPrevious = outList.SyncedCount + 2 == sync;
+
+		if (sameLayout && (outList.SyncedCount + 1 == sync || missedPrevious))
+		{
+			if (missedPrevious)
+			{
+				for (uint32_t row : myPreviousDirtyRows)
+				{
+					outList.Proxies[row].Transform = myProxies[row].Transform;
+				}
+			}
+
+			for (uint32_t row : myDirtyRows)
+			{
+				outList.Proxies[row].Transform = myProxies[row].Transform;
+			}
+		}
+		else
+		{
+			outList.Proxies.assign(myProxies.begin(), myProxies.end());
+		}
+
+		outList.SyncedCount = sync;
+
+		myPreviousDirtyRows.swap(myDirtyRows);
+		myDirtyRows.clear();
+	}
+
+	void RenderProxyTable::Clear()
+	{
+		myProxies.clear();
+		myRuns.clear();
+		myRunIndices.clear();
+		myEntityRecords.clear();
+		myChangedEntities.clear();
+		myRemovedEntities.clear();
+		myDirtyRows.clear();
+		myPreviousDirtyRows.clear();
+
+		// mySyncCount keeps counting so the lists synced before can't be mistaken for up to date ones
+		myLayoutSync = mySyncCount + 1;
+	}
+
+	void RenderProxyTable::Remove(entt::entity aEntity)
+	{
+		EntityRecord* record = GetRecord(aEntity);
+		if (!record) return;
+
+		myRuns[record->Run].Instances[record->Rank] = entt::null;
+		record->Run = UINT32_MAX;
+	}
+
+	void RenderProxyTable::Add(const entt::registry& aRegistry, entt::entity aEntity)
+	{
+		if (!aRegistry.valid(aEntity)) return;
+
+		const auto* renderer = aRegistry.try_get<MeshRendererComponent>(aEntity);
+		if (!renderer || !renderer->Mesh.IsValid()) return;
+
+		const uint32_t runIndex = GetRun(renderer->Mesh);
+		MeshRun& run = myRuns[runIndex];
+		if (run.SubMeshCount == 0) return;
+
+		const size_t index = static_cast<size_t>(entt::to_entity(aEntity));
+		if (index >= myEntityRecords.size())
+		{
+			myEntityRecords.resize(std::max(index + 1, myEntityRecords.size() * 2));
+		}
+
+		myEntityRecords[index] = { runIndex, static_cast<uint32_t>(run.Instances.size()) };
+		run.Instances.emplace_back(aEntity);
+	}
+
+	void RenderProxyTable::Layout(const entt::registry& aRegistry)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		// Same order as ExtractRenderProxies(), by mesh and then submesh
+		myRunOrder.clear();
+		for (uint32_t i = 0; i < myRuns.size(); ++i)
+		{
+			if (!myRuns[i].Instances.empty()) myRunOrder.emplace_back(i);
+		}
+		std::sort(myRunOrder.begin(), myRunOrder.end(), [this](uint32_t aLeft, uint32_t aRight)
+			{
+				return RenderProxyList::CreateSortKey(myRuns[aLeft].Mesh, 0) < RenderProxyList::CreateSortKey(myRuns[aRight].Mesh, 0);
+			});
+
+		size_t proxyCount = 0;
+		for (uint32_t index : myRunOrder)
+		{
+			const MeshRun& run = myRuns[index];
+			proxyCount += run.SubMeshCount * static_cast<size_t>(std::count_if(run.Instances.begin(), run.Instances.end(), [](entt::entity aEntity) { return aEntity != entt::null; }));
+		}
+		myScratch.resize(proxyCount);
+
+		const auto* worlds = aRegistry.storage<WorldTransformComponent>();
+
+		size_t offset = 0;
+		for (uint32_t index : myRunOrder)
+		{
+			MeshRun& run = myRuns[index];
+			const size_t liveCount = static_cast<size_t>(std::count_if(run.Instances.begin(), run.Instances.end(), [](entt::entity aEntity) { return aEntity != entt::null; }));
+
+			// The instances are compacted in place, the ones already laid out take their matrix from the old rows
+			uint32_t rank = 0;
+			for (uint32_t oldRank = 0; oldRank < run.Instances.size(); ++oldRank)
+			{
+				const entt::entity entity = run.Instances[oldRank];
+				if (entity == entt::null) continue;
+
+				EPOCH_ASSERT(oldRank < run.LaidOutCount || worlds, "Mesh renderer without a world transform!");
+				const CU::Matrix4x4f& matrix = oldRank < run.LaidOutCount ? myProxies[run.Offset + oldRank].Transform : worlds->get(entity).Matrix;
+
+				size_t row = offset + rank;
+				for (uint32_t subMesh = 0; subMesh < run.SubMeshCount; ++subMesh, row += liveCount)
+				{
+					myScratch[row] = { matrix, RenderProxyList::CreateSortKey(run.Mesh, subMesh), run.Mesh, subMesh };
+				}
+
+				run.Instances[rank] = entity;
+				myEntityRecords[static_cast<size_t>(entt::to_entity(entity))].Rank = rank;
+				++rank;
+			}
+
+			run.Instances.resize(rank);
+			run.Offset = offset;
+			run.LaidOutCount = rank;
+			offset += liveCount * run.SubMeshCount;
+		}
+
+		myProxies.swap(myScratch);
+
+		myDirtyRows.clear();
+		myLayoutSync = mySyncCount + 1;
+	}
+
+	uint32_t RenderProxyTable::GetRun(AssetHandle aMesh)
+	{
+		auto it = myRunIndices.find(aMesh);
+		if (it == myRunIndices.end())
+		{
+			it = myRunIndices.emplace(aMesh, static_cast<uint32_t>(myRuns.size())).first;
+			myRuns.emplace_back().Mesh = aMesh;
+		}
+
+		// Looked up again until the mesh is loaded, a run only has instances once it knows its submeshes
+		MeshRun& run = myRuns[it->second];
+		if (run.SubMeshCount == 0 && Assets::AssetManager::GetAssetManager())
+		{
+			if (auto mesh = Assets::AssetManager::GetAsset(TypedAssetHandle<Assets::MeshAsset>(aMesh)))
+			{
+				run.SubMeshCount = static_cast<uint32_t>(mesh->GetData().SubMeshes.size());
+			}
+		}
+
+		return it->second;
+	}
+
+	RenderProxyTable::EntityRecord* RenderProxyTable::GetRecord(entt::entity aEntity)
+	{
+		const size_t index = static_cast<size_t>(entt::to_entity(aEntity));
+		if (index >= myEntityRecords.size()) return nullptr;
+
+		EntityRecord& record = myEntityRecords[index];
+		if (record.Run == UINT32_MAX) return nullptr;
+
+		const auto& instances = myRuns[record.Run].Instances;
+		if (record.Rank >= instances.size() || instances[record.Rank] != aEntity) return nullptr;
+
+		return &record;
+	}
+}
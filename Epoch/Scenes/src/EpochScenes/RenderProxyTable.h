@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include <entt/entt.hpp>
+#include "RenderProxy.h"
+
+namespace Epoch::Scenes
+{
+	// Persistent render proxies of every entity with a MeshRendererComponent, owned and kept up to date by the Scene.
+	// The proxies of a mesh form one block per submesh with the instances in the same order in each of them,
+	// so the rows of an entity are found from its mesh and its rank without a search.
+	// Moved entities only get their own rows patched, adding, changing or removing a mesh renderer lays the table out again,
+	// a linear copy of the rows without looking at the registry or the assets.
+	class RenderProxyTable
+	{
+	public:
+		RenderProxyTable() = default;
+		~RenderProxyTable() = default;
+
+		// Connected to the MeshRendererComponent signals by the Scene, the changes are applied on the next Update().
+		// An entity whose mesh isn't loaded at that point gets no proxies until its MeshRendererComponent changes again.
+		void OnMeshRendererChanged(entt::registry& aRegistry, entt::entity aEntity);
+		void OnMeshRendererRemoved(entt::registry& aRegistry, entt::entity aEntity);
+
+		// Applies the queued changes and copies the world matrices of aMovedEntities, entities without proxies are skipped
+		void Update(const entt::registry& aRegistry, std::span<const entt::entity> aMovedEntities);
+		// Clears the table and queues every mesh renderer in the registry
+		void Rebuild(const entt::registry& aRegistry);
+
+		// Brings outList up to the table's state. Only the rows changed since the list was last synced are copied if that was
+		// one of the last two Sync() calls, which is the case for both lists of a RenderProxyBuffer swapped every frame.
+		void Sync(RenderProxyList& outList);
+
+		void Clear();
+
+		const std::vector<RenderProxy>& GetProxies() const { return myProxies; }
+
+	private:
+		struct MeshRun
+		{
+			AssetHandle Mesh;
+			uint32_t SubMeshCount = 0;
+			size_t Offset = 0;					// Of the submesh 0 block, the other submeshes' blocks follow it
+			std::vector<entt::entity> Instances;	// Indexed by rank, entt::null for removed ones until the next layout
+			uint32_t LaidOutCount = 0;			// Instances with rows in the table, the ones after them were added since
+		};
+
+		struct EntityRecord
+		{
+			uint32_t Run = UINT32_MAX;
+			uint32_t Rank = 0;
+		};
+
+		void Remove(entt::entity aEntity);
+		void Add(const entt::registry& aRegistry, entt::entity aEntity);
+		void Layout(const entt::registry& aRegistry);
+		uint32_t GetRun(AssetHandle aMesh);
+		EntityRecord* GetRecord(entt::entity aEntity);
+
+	private:
+		std::vector<RenderProxy> myProxies;
+		std::vector<MeshRun> myRuns;
+		std::unordered_map<AssetHandle, uint32_t> myRunIndices;
+		std::vector<EntityRecord> myEntityRecords;	// Indexed by entity index, the instance at the rank has to match including the version
+
+		std::vector<entt::entity> myChangedEntities;
+		std::vector<entt::entity> myRemovedEntities;
+
+		// Rows patched since the last Sync() and in the one before it
+		std::vector<uint32_t> myDirtyRows;
+		std::vector<uint32_t> myPreviousDirtyRows;
+
+		// Sync() calls so far, and the one that first sees the last layout
+		uint64_t mySyncCount = 0;
+		uint64_t myLayoutSync = 0;
+
+		// Kept between layouts so a frame doesn't allocate once the table has grown
+		std::vector<RenderProxy> myScratch;
+		std::vector<uint32_t> myRunOrder;
+	};
+}
@@ -1,15 +1,101 @@
 #include "Scene.h"
+#include <algorithm>
+#include <unordered_map>
 #include <EpochCore/UUID.h>
+#include <EpochCore/Profiler.h>
+#include <EpochAssets/AssetManager.h>
+#include <EpochAssets/Assets/MeshAsset.h>
 #include <EpochAssets/Assets/ModelAsset.h>
 
 namespace Epoch::Scenes
 {
+	namespace
+	{
+		// Next entity of a pre-order walk over the subtree below aRoot, no stack needed since every node knows its parent and next sibling
+		template<typename Storage>
+		entt::entity NextInSubtree(const Storage& aHierarchies, entt::entity aEntity, entt::entity aRoot)
+		{
+			const auto& hierarchy = aHierarchies.get(aEntity);
+			if (hierarchy.FirstChild != entt::null) return hierarchy.FirstChild;
+
+			while (aEntity != aRoot)
+			{
+				const auto& current = aHierarchies.get(aEntity);
+				if (current.NextSibling != entt::null) return current.NextSibling;
+				aEntity = current.Parent;
+			}
+
+			return entt::null;
+		}
+
+		template<typename T>
+		void SnapshotPool(const entt::registry& aRegistry, ComponentPoolSnapshot<T>& outPool)
+		{
+			const auto* pool = aRegistry.storage<T>();
+			const size_t count = pool ? pool->size() : 0;
+
+			outPool.Entities.resize(count);
+			outPool.Components.resize(count);
+			if (count == 0) return;
+
+			std::copy_n(pool->data(), count, outPool.Entities.data());
+
+			// Pages are fixed size blocks in packed order, std::copy_n turns into a memmove for trivially copyable components
+			constexpr size_t pageSize = entt::component_traits<T>::page_size;
+			const auto pages = pool->raw();
+			for (size_t offset = 0; offset < count; offset += pageSize)
+			{
+				std::copy_n(pages[offset / pageSize], std::min(pageSize, count - offset), outPool.Components.data() + offset);
+			}
+		}
+
+		template<typename T>
+		void RestorePool(entt::registry& aRegistry, const ComponentPoolSnapshot<T>& aPool)
+		{
+			auto& pool = aRegistry.storage<T>();
+			const size_t count = aPool.Entities.size();
+
+			const bool sameEntities = pool.size() == count && std::equal(aPool.Entities.begin(), aPool.Entities.end(), pool.data());
+			if (!sameEntities)
+			{
+				pool.clear();
+				pool.reserve(count);
+				pool.insert(aPool.Entities.begin(), aPool.Entities.end(), aPool.Components.begin());
+				return;
+			}
+
+			constexpr size_t pageSize = entt::component_traits<T>::page_size;
+			const auto pages = pool.raw();
+			for (size_t offset = 0; offset < count; offset += pageSize)
+			{
+				std::copy_n(aPool.Components.data() + offset, std::min(pageSize, count - offset), pages[offset / pageSize]);
+			}
+		}
+
+		template<typename... ComponentTypes>
+		bool IsAnyOf(entt::id_type aID)
+		{
+			return ((aID == entt::type_hash<ComponentTypes>::value()) || ...);
+		}
+
+		bool IsIdentity(const CU::Matrix4x4f& aMatrix)
+		{
+			for (int i = 0; i < 16; ++i)
+			{
+				if (aMatrix[i] != CU::Matrix4x4f::Identity[i]) return false;
+			}
+			return true;
+		}
+	}
+
 	Scene::Scene()
 	{
+		ConnectSignals();
 	}
 
 	Scene::~Scene()
 	{
+		DisconnectSignals();
 	}
 
 	Entity Scene::CreateEntity(std::string_view aName)
@@ -24,33 +110,56 @@ namespace Epoch::Scenes
 
 		entity.AddComponent<IDComponent>(uuid);
 		entity.AddComponent<NameComponent>(aName);
+		entity.AddComponent<HierarchyComponent>();
 		entity.AddComponent<TransformComponent>();
+		entity.AddComponent<WorldTransformComponent>();
+		MarkTransformDirty(entity);
 
 		if (aParent)
 		{
 			ParentEntity(entity, aParent);
 		}
+		else
+		{
+			myHierarchyChanged = true;
+		}
 
-		myIDToEntityMap.insert_or_assign(uuid, entity);
-		myEntityToIDMap.insert_or_assign(entity, uuid);
+		myIDToEntityMap.Insert(uuid, entity);
 
 		return entity;
 	}
 
+	void Scene::DestroyEntity(Entity aEntity)
+	{
+		DetachFromParent(aEntity);
+
+		auto& hierarchies = myRegistry.storage<HierarchyComponent>();
+		const auto& ids = myRegistry.storage<IDComponent>();
+
+		myDestroyQueue.clear();
+		for (entt::entity entity = aEntity; entity != entt::null; entity = NextInSubtree(hierarchies, entity, aEntity))
+		{
+			myDestroyQueue.emplace_back(entity);
+			myIDToEntityMap.Erase(ids.get(entity).ID);
+		}
+
+		myRegistry.destroy(myDestroyQueue.begin(), myDestroyQueue.end());
+		myHierarchyChanged = true;
+	}
+
 	Entity Scene::GetEntityWithUUID(UUID aUUID)
 	{
-		EPOCH_ASSERT(myIDToEntityMap.contains(aUUID), "Entity doesn't exist in scene!");
-		return Entity{ myIDToEntityMap.at(aUUID), this };
+		const entt::entity entity = myIDToEntityMap.Find(aUUID);
+		EPOCH_ASSERT(entity != entt::null, "Entity doesn't exist in scene!");
+		return Entity{ entity, this };
 	}
 
 	Entity Scene::TryGetEntityWithUUID(UUID aUUID)
 	{
-		if (auto it = myIDToEntityMap.find(aUUID); it != myIDToEntityMap.end())
-		{
-			return Entity{ it->second, this };
-		}
+		const entt::entity entity = myIDToEntityMap.Find(aUUID);
+		if (entity == entt::null) return Entity{};
 
-		return Entity{};
+		return Entity{ entity, this };
 	}
 
 	void Scene::ParentEntity(Entity aEntity, Entity aParent)
@@ -68,76 +177,485 @@ namespace Epoch::Scenes
 		}
 		else
 		{
-			Entity previousParent = aEntity.GetParent();
-			if (previousParent)
+			DetachFromParent(aEntity);
+		}
+
+		AttachChild(aEntity, aParent);
+		SetSubtreeDepth(aEntity, aParent.GetDepth() + 1);
+		myHierarchyChanged = true;
+
+		MarkTransformDirty(aEntity);
+	}
+
+	void Scene::UnparentEntity(Entity aEntity)
+	{
+		if (!aEntity.HasParent()) return;
+
+		DetachFromParent(aEntity);
+		SetSubtreeDepth(aEntity, 0);
+		myHierarchyChanged = true;
+
+		MarkTransformDirty(aEntity);
+	}
+
+	void Scene::ConnectSignals()
+	{
+		myRegistry.on_construct<MeshRendererComponent>().connect<&SceneBVH::OnMeshRendererChanged>(myBVH);
+		myRegistry.on_update<MeshRendererComponent>().connect<&SceneBVH::OnMeshRendererChanged>(myBVH);
+		myRegistry.on_destroy<MeshRendererComponent>().connect<&SceneBVH::OnMeshRendererRemoved>(myBVH);
+
+		myRegistry.on_construct<MeshRendererComponent>().connect<&RenderProxyTable::OnMeshRendererChanged>(myRenderProxyTable);
+		myRegistry.on_update<MeshRendererComponent>().connect<&RenderProxyTable::OnMeshRendererChanged>(myRenderProxyTable);
+		myRegistry.on_destroy<MeshRendererComponent>().connect<&RenderProxyTable::OnMeshRendererRemoved>(myRenderProxyTable);
+	}
+
+	void Scene::DisconnectSignals()
+	{
+		myRegistry.on_construct<MeshRendererComponent>().disconnect(&myBVH);
+		myRegistry.on_update<MeshRendererComponent>().disconnect(&myBVH);
+		myRegistry.on_destroy<MeshRendererComponent>().disconnect(&myBVH);
+
+		myRegistry.on_construct<MeshRendererComponent>().disconnect(&myRenderProxyTable);
+		myRegistry.on_update<MeshRendererComponent>().disconnect(&myRenderProxyTable);
+		myRegistry.on_destroy<MeshRendererComponent>().disconnect(&myRenderProxyTable);
+	}
+
+	void Scene::AttachChild(entt::entity aEntity, entt::entity aParent)
+	{
+		auto& hierarchies = myRegistry.storage<HierarchyComponent>();
+		auto& hierarchy = hierarchies.get(aEntity);
+		auto& parent = hierarchies.get(aParent);
+
+		hierarchy.Parent = aParent;
+		hierarchy.PrevSibling = parent.LastChild;
+		hierarchy.NextSibling = entt::null;
+
+		if (parent.LastChild != entt::null)
+		{
+			hierarchies.get(parent.LastChild).NextSibling = aEntity;
+		}
+		else
+		{
+			parent.FirstChild = aEntity;
+		}
+
+		parent.LastChild = aEntity;
+		++parent.ChildCount;
+	}
+
+	void Scene::DetachFromParent(entt::entity aEntity)
+	{
+		auto& hierarchies = myRegistry.storage<HierarchyComponent>();
+		auto& hierarchy = hierarchies.get(aEntity);
+		if (hierarchy.Parent == entt::null) return;
+
+		auto& parent = hierarchies.get(hierarchy.Parent);
+
+		if (hierarchy.PrevSibling != entt::null)
+		{
+			hierarchies.get(hierarchy.PrevSibling).NextSibling = hierarchy.NextSibling;
+		}
+		else
+		{
+			parent.FirstChild = hierarchy.NextSibling;
+		}
+
+		if (hierarchy.NextSibling != entt::null)
+		{
+			hierarchies.get(hierarchy.NextSibling).PrevSibling = hierarchy.PrevSibling;
+		}
+		else
+		{
+			parent.LastChild = hierarchy.PrevSibling;
+		}
+
+		--parent.ChildCount;
+
+		hierarchy.Parent = entt::null;
+		hierarchy.PrevSibling = entt::null;
+		hierarchy.NextSibling = entt::null;
+	}
+
+	void Scene::SetSubtreeDepth(entt::entity aEntity, uint32_t aDepth)
+	{
+		auto& hierarchies = myRegistry.storage<HierarchyComponent>();
+
+		// The rest of the subtree is always one level below its parent, so it's only stale if the root moved
+		auto& root = hierarchies.get(aEntity);
+		if (root.Depth == aDepth) return;
+
+		root.Depth = aDepth;
+		for (entt::entity entity = NextInSubtree(hierarchies, aEntity, aEntity); entity != entt::null; entity = NextInSubtree(hierarchies, entity, aEntity))
+		{
+			auto& hierarchy = hierarchies.get(entity);
+			hierarchy.Depth = hierarchies.get(hierarchy.Parent).Depth + 1;
+		}
+	}
+
+	void Scene::SortHierarchy()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		auto& hierarchies = myRegistry.storage<HierarchyComponent>();
+
+		myHierarchyOrder.clear();
+		myHierarchyOrder.reserve(hierarchies.size());
+
+		for (auto [root, hierarchy] : hierarchies.each())
+		{
+			if (hierarchy.Parent != entt::null) continue;
+
+			for (entt::entity entity = root; entity != entt::null; entity = NextInSubtree(hierarchies, entity, root))
 			{
-				UnparentEntity(aEntity);
+				myHierarchyOrder.emplace_back(entity);
 			}
 		}
 
-		aEntity.GetOrAddComponent<ParentComponent>().Parent = aParent;
-		aParent.GetOrAddComponent<ChildrenComponent>().Children.emplace_back(aEntity);
+		hierarchies.sort_as(myHierarchyOrder.begin(), myHierarchyOrder.end());
+		myRegistry.sort<TransformComponent, HierarchyComponent>();
+		myRegistry.sort<WorldTransformComponent, HierarchyComponent>();
+
+		myHierarchyChanged = false;
 	}
 
-	void Scene::UnparentEntity(Entity aEntity)
+	void Scene::MarkTransformDirty(Entity aEntity)
 	{
-		Entity parent = aEntity.GetParent();
-		if (!parent) return;
+		myTransformSystem.MarkDirty(myRegistry, aEntity);
+	}
 
-		auto& children = parent.GetComponent<ChildrenComponent>().Children;
-		children.erase(std::remove(children.begin(), children.end(), aEntity), children.end());
+	void Scene::Update(float aDeltaTime)
+	{
+		EPOCH_PROFILE_FUNC();
 
-		aEntity.RemoveComponent<ParentComponent>();
+		mySystemScheduler.Run(myRegistry, myTransformSystem, aDeltaTime);
+		UpdateWorldTransforms();
 	}
 
-	Entity Scene::Instantiate(std::shared_ptr<Assets::ModelAsset> aModel)
+	void Scene::UpdateWorldTransforms()
 	{
-		return InstantiateChild(aModel, {});
+		if (myHierarchyChanged)
+		{
+			SortHierarchy();
+		}
+
+		myTransformSystem.Update(myRegistry);
+		myBVH.Update(myRegistry, myTransformSystem.GetUpdatedEntities());
+		myRenderProxyTable.Update(myRegistry, myTransformSystem.GetUpdatedEntities());
 	}
 
-	Entity Scene::InstantiateChild(std::shared_ptr<Assets::ModelAsset> aModel, Entity aParent)
+	Entity Scene::Raycast(const CU::Ray& aRay, float aMaxDistance, float& outDistance)
 	{
-		const auto& modelData = aModel->GetData();
+		EPOCH_PROFILE_FUNC();
+
+		if (!Assets::AssetManager::GetAssetManager()) return {};
+
+		const auto& renderers = myRegistry.storage<MeshRendererComponent>();
+		const auto& worlds = myRegistry.storage<WorldTransformComponent>();
+
+		entt::entity closest = entt::null;
+		float closestDistance = aMaxDistance;
+
+		myBVH.Raycast(aRay, aMaxDistance, [&](entt::entity aEntity, float)
+			{
+				auto mesh = Assets::AssetManager::GetAsset(TypedAssetHandle<Assets::MeshAsset>(renderers.get(aEntity).Mesh));
+				if (!mesh) return closestDistance;
+
+				// The direction isn't normalized after the transform, so mesh space hit distances stay in world units even with scaling
+				const CU::Matrix4x4f inverse = worlds.get(aEntity).Matrix.GetInverse();
+				const CU::Vector3f origin(CU::Vector4f(aRay.origin, 1.0f) * inverse);
+				const CU::Vector3f direction(CU::Vector4f(aRay.direction, 0.0f) * inverse);
+
+				DataTypes::MeshBVH::Hit hit;
+				if (mesh->GetBVH().Raycast(origin, direction, closestDistance, hit))
+				{
+					closest = aEntity;
+					closestDistance = hit.Distance;
+				}
+				return closestDistance;
+			});
+
+		if (closest == entt::null) return {};
+
+		outDistance = closestDistance;
+		return Entity{ closest, this };
+	}
+
+	void Scene::ExtractRenderProxies(RenderProxyList& outList) const
+	{
+		EPOCH_PROFILE_FUNC();
+
+		outList.Proxies.clear();
+		outList.SyncedCount = 0;
+
+		if (!Assets::AssetManager::GetAssetManager()) return;
+
+		struct MeshRun
+		{
+			AssetHandle Mesh;
+			uint32_t SubMeshCount;
+			uint32_t InstanceCount = 0;
+			uint32_t WrittenCount = 0;
+			size_t Offset = 0;		// Of the submesh 0 run, the runs of the other submeshes follow it
+		};
+
+		std::vector<MeshRun> meshes;
+		std::unordered_map<AssetHandle, uint32_t> meshIndices;
+
+		// Most entities share their mesh with the one before them, the map is only asked when the mesh changes
+		AssetHandle lastMesh = 0;
+		uint32_t lastIndex = UINT32_MAX;
+		auto getMeshIndex = [&](AssetHandle aMesh)
+			{
+				if (aMesh == lastMesh && lastIndex != UINT32_MAX) return lastIndex;
+
+				auto it = meshIndices.find(aMesh);
+				if (it == meshIndices.end())
+				{
+					auto asset = aMesh != 0 ? Assets::AssetManager::GetAsset(TypedAssetHandle<Assets::MeshAsset>(aMesh)) : nullptr;
+					it = meshIndices.emplace(aMesh, static_cast<uint32_t>(meshes.size())).first;
+					meshes.push_back({ aMesh, asset ? static_cast<uint32_t>(asset->GetData().SubMeshes.size()) : 0 });
+				}
+
+				lastMesh = aMesh;
+				lastIndex = it->second;
+				return lastIndex;
+			};
+
+		auto view = myRegistry.view<const MeshRendererComponent, const WorldTransformComponent>();
+
+		// A counting sort instead of sorting the proxies, the first pass counts the instances of every mesh
+		// and the second one writes each proxy straight to its place in the list
+		for (auto [entity, renderer, world] : view.each())
+		{
+			++meshes[getMeshIndex(renderer.Mesh)].InstanceCount;
+		}
 
-		if (!modelData.IsValid()) return {};
+		std::vector<uint32_t> order(meshes.size());
+		for (uint32_t i = 0; i < order.size(); ++i)
+		{
+			order[i] = i;
+		}
+		std::sort(order.begin(), order.end(), [&meshes](uint32_t aLeft, uint32_t aRight)
+			{
+				return RenderProxyList::CreateSortKey(meshes[aLeft].Mesh, 0) < RenderProxyList::CreateSortKey(meshes[aRight].Mesh, 0);
+			});
 
-		std::vector<Entity> entityMap(modelData.Hierarchy.size());
+		size_t proxyCount = 0;
+		for (uint32_t index : order)
+		{
+			meshes[index].Offset = proxyCount;
+			proxyCount += static_cast<size_t>(meshes[index].SubMeshCount) * meshes[index].InstanceCount;
+		}
+		outList.Proxies.resize(proxyCount);
 
-		for (size_t i = 0; i < modelData.Hierarchy.size(); ++i)
+		for (auto [entity, renderer, world] : view.each())
 		{
-			const auto& node = modelData.Hierarchy[i];
-			Entity entity;
+			MeshRun& mesh = meshes[getMeshIndex(renderer.Mesh)];
 
-			if (!node.IsRoot())
+			size_t proxy = mesh.Offset + mesh.WrittenCount++;
+			for (uint32_t subMesh = 0; subMesh < mesh.SubMeshCount; ++subMesh, proxy += mesh.InstanceCount)
 			{
-				Entity parent = entityMap[node.Parent];
-				entity = CreateChildEntity(parent, node.Name);
+				outList.Proxies[proxy] = { world.Matrix, RenderProxyList::CreateSortKey(mesh.Mesh, subMesh), mesh.Mesh, subMesh };
 			}
-			else
+		}
+	}
+
+	SceneSnapshot Scene::Snapshot() const
+	{
+		SceneSnapshot snapshot;
+		Snapshot(snapshot);
+		return snapshot;
+	}
+
+	void Scene::Snapshot(SceneSnapshot& outSnapshot) const
+	{
+		EPOCH_PROFILE_FUNC();
+
+		const auto& entities = *myRegistry.storage<entt::entity>();
+		outSnapshot.myEntities.assign(entities.data(), entities.data() + entities.size());
+		outSnapshot.myAliveEntityCount = entities.free_list();
+
+		SnapshotPool(myRegistry, outSnapshot.myIDs);
+		SnapshotPool(myRegistry, outSnapshot.myNames);
+		SnapshotPool(myRegistry, outSnapshot.myHierarchies);
+		SnapshotPool(myRegistry, outSnapshot.myTransforms);
+		SnapshotPool(myRegistry, outSnapshot.myWorldTransforms);
+		SnapshotPool(myRegistry, outSnapshot.myMeshRenderers);
+
+		outSnapshot.myIDToEntityMap = myIDToEntityMap;
+		outSnapshot.myTransformSystem = myTransformSystem;
+		outSnapshot.myBVH = myBVH;
+		outSnapshot.myHierarchyChanged = myHierarchyChanged;
+	}
+
+	void Scene::Restore(const SceneSnapshot& aSnapshot)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		// Nothing to restore these from, and they would be left pointing at entities that might not exist anymore
+		for (auto [id, pool] : myRegistry.storage())
+		{
+			if (!IsAnyOf<IDComponent, NameComponent, HierarchyComponent, TransformComponent, WorldTransformComponent, MeshRendererComponent>(id))
 			{
-				entity = (bool)aParent ? CreateChildEntity(aParent, node.Name) : CreateEntity(node.Name);
+				pool.clear();
 			}
+		}
+
+		// Pushing the identifiers back as they were keeps the versions of released entities, so old handles stay invalid
+		auto& entities = myRegistry.storage<entt::entity>();
+		const bool sameEntities = entities.size() == aSnapshot.myEntities.size() && entities.free_list() == aSnapshot.myAliveEntityCount
+			&& std::equal(aSnapshot.myEntities.begin(), aSnapshot.myEntities.end(), entities.data());
+		if (!sameEntities)
+		{
+			entities.clear();
+			entities.reserve(aSnapshot.myEntities.size());
+			entities.push(aSnapshot.myEntities.begin(), aSnapshot.myEntities.end());
+			entities.free_list(aSnapshot.myAliveEntityCount);
+		}
+
+		// The BVH is copied as a whole below, rebuilding mesh renderer pools would otherwise queue every entity for reinsertion.
+		// The render proxy table is rebuilt once at the end instead of seeing every component come and go.
+		DisconnectSignals();
+
+		RestorePool(myRegistry, aSnapshot.myIDs);
+		RestorePool(myRegistry, aSnapshot.myNames);
+		RestorePool(myRegistry, aSnapshot.myHierarchies);
+		RestorePool(myRegistry, aSnapshot.myTransforms);
+		RestorePool(myRegistry, aSnapshot.myWorldTransforms);
+		RestorePool(myRegistry, aSnapshot.myMeshRenderers);
+
+		ConnectSignals();
+
+		myIDToEntityMap = aSnapshot.myIDToEntityMap;
+		myTransformSystem = aSnapshot.myTransformSystem;
+		myBVH = aSnapshot.myBVH;
+		myHierarchyChanged = aSnapshot.myHierarchyChanged;
+
+		// Not part of the snapshot, laid out again from the restored pools
+		myRenderProxyTable.Rebuild(myRegistry);
+	}
+
+	Entity Scene::Instantiate(std::shared_ptr<Assets::ModelAsset> aModel)
+	{
+		return InstantiateChild(aModel, {});
+	}
+
+	Entity Scene::InstantiateChild(std::shared_ptr<Assets::ModelAsset> aModel, Entity aParent)
+	{
+		const CU::CompactTransform placement;
+		std::vector<Entity> roots = InstantiateMany(aModel, { &placement, 1 }, aParent);
+		return roots.empty() ? Entity{} : roots[0];
+	}
+
+	std::vector<Entity> Scene::InstantiateMany(std::shared_ptr<Assets::ModelAsset> aModel, std::span<const CU::CompactTransform> aTransforms, Entity aParent)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		const auto& modelData = aModel->GetData();
+
+		if (!modelData.IsValid() || aTransforms.empty()) return {};
+
+		const auto& nodes = modelData.Hierarchy;
+		const size_t nodeCount = nodes.size();
+		const size_t entityCount = nodeCount * aTransforms.size();
+
+		// Decomposed once per node instead of once per entity
+		std::vector<CU::CompactTransform> nodeTransforms;
+		nodeTransforms.reserve(nodeCount);
+		for (const auto& node : nodes)
+		{
+			nodeTransforms.emplace_back(node.LocalTransform);
+		}
+
+		size_t meshNodeCount = 0;
+		for (const auto& node : nodes)
+		{
+			if (node.MeshIndex != UINT32_MAX) ++meshNodeCount;
+		}
 
-			entity.GetComponent<TransformComponent>().LocalTransform = CU::Transform(node.LocalTransform);
+		std::vector<entt::entity> entities(entityCount);
+		myRegistry.create(entities.begin(), entities.end());
 
-			if (node.MeshIndex != UINT32_MAX)
+		auto& ids = myRegistry.storage<IDComponent>();
+		auto& names = myRegistry.storage<NameComponent>();
+		auto& hierarchies = myRegistry.storage<HierarchyComponent>();
+		auto& transforms = myRegistry.storage<TransformComponent>();
+		auto& worlds = myRegistry.storage<WorldTransformComponent>();
+		auto& meshRenderers = myRegistry.storage<MeshRendererComponent>();
+
+		ids.reserve(ids.size() + entityCount);
+		names.reserve(names.size() + entityCount);
+		hierarchies.reserve(hierarchies.size() + entityCount);
+		transforms.reserve(transforms.size() + entityCount);
+		worlds.reserve(worlds.size() + entityCount);
+		meshRenderers.reserve(meshRenderers.size() + meshNodeCount * aTransforms.size());
+		myIDToEntityMap.Reserve(myIDToEntityMap.Size() + entityCount);
+
+		const uint32_t rootDepth = aParent ? aParent.GetDepth() + 1 : 0;
+
+		std::vector<Entity> roots;
+		roots.reserve(aTransforms.size());
+
+		for (size_t instance = 0; instance < aTransforms.size(); ++instance)
+		{
+			const entt::entity* instanceEntities = entities.data() + instance * nodeCount;
+
+			// Nodes are stored parents first, so every parent is linked before its children
+			for (size_t i = 0; i < nodeCount; ++i)
 			{
-				entity.AddComponent<MeshRendererComponent>(modelData.MeshAssets[node.MeshIndex]);
+				const auto& node = nodes[i];
+				const entt::entity entity = instanceEntities[i];
+				const UUID uuid = UUID();
+
+				ids.emplace(entity, uuid);
+				names.emplace(entity, node.Name);
+				hierarchies.emplace(entity);
+				worlds.emplace(entity);
+
+				if (!node.IsRoot())
+				{
+					transforms.emplace(entity, nodeTransforms[i]);
+					AttachChild(entity, instanceEntities[node.Parent]);
+					hierarchies.get(entity).Depth = hierarchies.get(instanceEntities[node.Parent]).Depth + 1;
+				}
+				else
+				{
+					const CU::CompactTransform& placement = aTransforms[instance];
+					transforms.emplace(entity, IsIdentity(node.LocalTransform) ? placement : CU::CompactTransform(node.LocalTransform * placement.GetMatrix()));
+
+					if (aParent)
+					{
+						AttachChild(entity, aParent);
+					}
+					hierarchies.get(entity).Depth = rootDepth;
+				}
+
+				if (node.MeshIndex != UINT32_MAX)
+				{
+					meshRenderers.emplace(entity, modelData.MeshAssets[node.MeshIndex]);
+				}
+
+				myIDToEntityMap.Insert(uuid, entity);
 			}
 
-			entityMap[i] = entity;
+			// The rest of the instance is reached through the root's subtree
+			Entity root{ instanceEntities[0], this };
+			MarkTransformDirty(root);
+			roots.emplace_back(root);
 		}
 
-		return entityMap[0];
+		myHierarchyChanged = true;
+
+		return roots;
 	}
 
 	void Scene::PrintHierarchy()
 	{
-		auto view = myRegistry.view<IDComponent>();
+		auto view = myRegistry.view<HierarchyComponent>();
 		for (auto id : view)
 		{
 			Entity entity{ id, this };
-			if (entity.HasComponent<ParentComponent>()) continue;
+			if (entity.HasParent()) continue;
 			PrintHierarchyRecursive(entity);
 		}
 	}
@@ -151,12 +669,9 @@ namespace Epoch::Scenes
 		}
 		LOG_DEBUG("{}{}", indent, aEntity.GetName());
 
-		if (!aEntity.HasComponent<ChildrenComponent>()) return;
-
-		auto& childrenComponent = aEntity.GetComponent<ChildrenComponent>();
-		for (auto child : childrenComponent.Children)
+		for (Entity child = aEntity.GetFirstChild(); child; child = child.GetNextSibling())
 		{
-			PrintHierarchyRecursive(Entity{ child, this }, aDepth + 1);
+			PrintHierarchyRecursive(child, aDepth + 1);
 		}
 	}
 }
@@ -1,5 +1,13 @@
 #pragma once
+#include <span>
 #include "Entity.h"
+#include "EntityIDMap.h"
+#include "RenderProxy.h"
+#include "RenderProxyTable.h"
+#include "SceneBVH.h"
+#include "SceneSnapshot.h"
+#include "SystemScheduler.h"
+#include "TransformSystem.h"
 
 namespace Epoch::Assets
 {
@@ -14,17 +22,71 @@ namespace Epoch::Scenes
 		Scene();
 		~Scene();
 
+		// The BVH's and render proxy table's signal connections point at this instance
+		Scene(const Scene&) = delete;
+		Scene& operator=(const Scene&) = delete;
+
 		Entity CreateEntity(std::string_view aName = "New Entity");
 		Entity CreateChildEntity(Entity aParent, std::string_view aName = "New Entity");
+		// Destroys the entity and all of its descendants
+		void DestroyEntity(Entity aEntity);
 
 		Entity GetEntityWithUUID(UUID aUUID);
 		Entity TryGetEntityWithUUID(UUID aUUID);
 
+		// aEntity is added as the last child of aParent. If aParent is a descendant of aEntity it takes aEntity's place first.
 		void ParentEntity(Entity aEntity, Entity aParent);
 		void UnparentEntity(Entity aEntity);
 
+		// Call after changing an entity's TransformComponent, its subtree gets new world matrices on the next UpdateWorldTransforms().
+		// Creating and (un)parenting entities marks them automatically.
+		void MarkTransformDirty(Entity aEntity);
+		// Also puts the hierarchy and transform pools back in depth-first order if the hierarchy changed,
+		// component references taken before the call can point to other entities afterwards.
+		// The BVH is brought up to date with the moved entities and the mesh renderers added since the last call.
+		void UpdateWorldTransforms();
+
+		// World space bounds of every entity with a MeshRendererComponent, as of the last UpdateWorldTransforms()
+		const SceneBVH& GetBVH() const { return myBVH; }
+		// Closest entity whose mesh triangles the ray hits, the BVH picks the candidates and their meshes' triangle BVHs are tested in near to far order.
+		// Entities whose mesh isn't loaded can't be hit. Returns an invalid Entity if nothing was hit within aMaxDistance.
+		Entity Raycast(const CU::Ray& aRay, float aMaxDistance, float& outDistance);
+
+		// Fills outList with one proxy per submesh of every entity whose mesh is loaded, sorted by sort key.
+		// The world matrices are the ones of the last UpdateWorldTransforms().
+		void ExtractRenderProxies(RenderProxyList& outList) const;
+		// Same proxies in the same order as ExtractRenderProxies(), copied from the table the scene keeps up to date in UpdateWorldTransforms().
+		// Only the moved entities' rows are copied when the lists of a RenderProxyBuffer are synced in turn every frame.
+		void SyncRenderProxies(RenderProxyList& outList) { myRenderProxyTable.Sync(outList); }
+
+		// aFunction(SystemContext&) runs every Update() with access to the listed components, e.g. RegisterSystem<Read<A>, Write<B>>("Name", ...).
+		// Systems that don't write anything another one touches run at the same time, conflicting ones run in registration order.
+		// They must not create or destroy entities or add and remove components, that's what exclusive systems are for.
+		template<typename ReadList = Read<>, typename WriteList = Write<>, typename Fn>
+		SystemID RegisterSystem(std::string_view aName, Fn&& aFunction);
+		// Runs alone, after the systems registered before it and before the ones registered after it
+		template<typename Fn>
+		SystemID RegisterExclusiveSystem(std::string_view aName, Fn&& aFunction);
+		void UnregisterSystem(SystemID aSystem) { mySystemScheduler.Remove(aSystem); }
+		// Systems running at the same time at most, 1 runs them all on the calling thread. Defaults to the job system's thread count.
+		void SetSystemThreadCount(uint32_t aCount) { mySystemScheduler.SetThreadCount(aCount); }
+
+		// Runs the systems, then UpdateWorldTransforms()
+		void Update(float aDeltaTime);
+
 		Entity Instantiate(std::shared_ptr<Assets::ModelAsset> aModel);
 		Entity InstantiateChild(std::shared_ptr<Assets::ModelAsset> aModel, Entity aParent);
+		// One instance of the model per transform, placed on top of the model's own root transform.
+		// All entities are created in one batch with the pools reserved up front, returns the instance roots.
+		std::vector<Entity> InstantiateMany(std::shared_ptr<Assets::ModelAsset> aModel, std::span<const CU::CompactTransform> aTransforms, Entity aParent = {});
+
+		// Copies the component pools in bulk, a memcpy per page for trivially copyable components.
+		// Restore() only copies the values back into pools that still hold the same entities in the same order and rebuilds the others,
+		// so rolling back a simulation that didn't create or destroy anything is as cheap as taking the snapshot.
+		// Components that aren't part of SceneSnapshot are removed by Restore().
+		SceneSnapshot Snapshot() const;
+		void Snapshot(SceneSnapshot& outSnapshot) const;
+		void Restore(const SceneSnapshot& aSnapshot);
 
 		template<typename... ComponentTypse>
 		auto GetAllEntitiesWith() { return myRegistry.view<ComponentTypse...>(); }
@@ -34,17 +96,50 @@ namespace Epoch::Scenes
 		void PrintHierarchyRecursive(Entity aEntity, uint32_t aDepth = 0);
 
 	private:
+		void ConnectSignals();
+		void DisconnectSignals();
+
+		void AttachChild(entt::entity aEntity, entt::entity aParent);
+		void DetachFromParent(entt::entity aEntity);
+		void SetSubtreeDepth(entt::entity aEntity, uint32_t aDepth);
 
+		// Sorts the pools so iterating them walks every tree parent first, with subtrees contiguous in memory.
+		void SortHierarchy();
 
 	private:
 		entt::registry myRegistry;
+		TransformSystem myTransformSystem;
+		SceneBVH myBVH;
+		RenderProxyTable myRenderProxyTable;
+		SystemScheduler mySystemScheduler;
 
-		std::unordered_map<UUID, entt::entity> myIDToEntityMap;
-		std::unordered_map<entt::entity, UUID> myEntityToIDMap;
+		bool myHierarchyChanged = false;
+		std::vector<entt::entity> myHierarchyOrder;
+
+		EntityIDMap myIDToEntityMap;
+		std::vector<entt::entity> myDestroyQueue;
 
 
 		friend class Entity;
+		friend class SceneSerializer;
 	};
 }
 
 #include "EntityTemplates.h"
+
+namespace Epoch::Scenes
+{
+	template<typename ReadList, typename WriteList, typename Fn>
+	inline SystemID Scene::RegisterSystem(std::string_view aName, Fn&& aFunction)
+	{
+		return mySystemScheduler.Add(aName, SystemAccess::Create<ReadList, WriteList>(), std::forward<Fn>(aFunction));
+	}
+
+	template<typename Fn>
+	inline SystemID Scene::RegisterExclusiveSystem(std::string_view aName, Fn&& aFunction)
+	{
+		SystemAccess access;
+		access.Exclusive = true;
+		return mySystemScheduler.Add(aName, std::move(access), std::forward<Fn>(aFunction));
+	}
+}
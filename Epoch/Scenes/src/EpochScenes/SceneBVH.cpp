@@ -0,0 +1,729 @@
+#include "SceneBVH.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <EpochCore/Assert.h>
+#include <EpochCore/Profiler.h>
+#include <EpochAssets/AssetManager.h>
+#include "Components.h"
+
+namespace Epoch::Scenes
+{
+	namespace
+	{
+		// Leaves are enlarged by this fraction of their extents plus a small absolute margin
+		constexpr float EnlargeFactor = 0.1f;
+		constexpr float MinEnlargeMargin = 0.01f;
+
+		// A leaf whose enlarged box has grown this much bigger than a fresh one would be is reinserted so a shrinking entity doesn't keep a loose box
+		constexpr float MaxEnlargedAreaRatio = 4.0f;
+
+		// How many times the last movement a reinserted leaf's box reaches ahead
+		constexpr float DisplacementFactor = 2.0f;
+
+		// Exact, the tree relies on every box containing the ones below it
+		bool IsSame(const CU::AABB& aA, const CU::AABB& aB)
+		{
+			return
+				aA.min.x == aB.min.x && aA.min.y == aB.min.y && aA.min.z == aB.min.z &&
+				aA.max.x == aB.max.x && aA.max.y == aB.max.y && aA.max.z == aB.max.z;
+		}
+
+		// 10 bits per axis for the Morton codes of the bulk build
+		constexpr float MortonGridSize = 1023.0f;
+
+		uint32_t SpreadBits(uint32_t aValue)
+		{
+			aValue = (aValue * 0x00010001u) & 0xFF0000FFu;
+			aValue = (aValue * 0x00000101u) & 0x0F00F00Fu;
+			aValue = (aValue * 0x00000011u) & 0xC30C30C3u;
+			aValue = (aValue * 0x00000005u) & 0x49249249u;
+			return aValue;
+		}
+
+		uint64_t GetMortonCode(uint32_t aX, uint32_t aY, uint32_t aZ)
+		{
+			return (SpreadBits(aX) << 2) | (SpreadBits(aY) << 1) | SpreadBits(aZ);
+		}
+
+		// LSD radix sort on the upper 32 bits, the code, 8 bits per pass. Sorting the keys with comparisons
+		// costs several times more on a big level because every comparison is a coin flip for the branch predictor.
+		void SortByMortonCode(std::vector<uint64_t>& aKeys)
+		{
+			std::vector<uint64_t> scratch(aKeys.size());
+
+			for (uint32_t shift = 32; shift < 64; shift += 8)
+			{
+				std::array<size_t, 257> offsets{};
+				for (uint64_t key : aKeys)
+				{
+					++offsets[((key >> shift) & 0xFF) + 1];
+				}
+
+				for (size_t i = 1; i < offsets.size(); ++i)
+				{
+					offsets[i] += offsets[i - 1];
+				}
+
+				for (uint64_t key : aKeys)
+				{
+					scratch[offsets[(key >> shift) & 0xFF]++] = key;
+				}
+
+				aKeys.swap(scratch);
+			}
+		}
+
+		// Entry and exit distance of one slab. A ray parallel to the slab with its origin on one of its planes
+		// gives 0 * inf = NaN, it runs along the boundary and the slab doesn't limit it, like a parallel ray inside.
+		void GetSlab(float aMin, float aMax, float aOrigin, float aInverseDirection, float& outNear, float& outFar)
+		{
+			const float t0 = (aMin - aOrigin) * aInverseDirection;
+			const float t1 = (aMax - aOrigin) * aInverseDirection;
+
+			if (std::isnan(t0) || std::isnan(t1))
+			{
+				outNear = -std::numeric_limits<float>::infinity();
+				outFar = std::numeric_limits<float>::infinity();
+				return;
+			}
+
+			outNear = CU::Math::Min(t0, t1);
+			outFar = CU::Math::Max(t0, t1);
+		}
+
+		// Entities without a loaded mesh are kept as a point at their origin
+		CU::AABB GetLocalBounds(const std::shared_ptr<Assets::MeshAsset>& aMesh)
+		{
+			if (aMesh && aMesh->GetBounds().IsValid())
+			{
+				return aMesh->GetBounds();
+			}
+
+			return CU::AABB(CU::Vector3f::Zero, CU::Vector3f::Zero);
+		}
+	}
+
+	void SceneBVH::OnMeshRendererChanged(entt::registry& /*aRegistry*/, entt::entity aEntity)
+	{
+		myPendingEntities.emplace_back(aEntity);
+	}
+
+	void SceneBVH::OnMeshRendererRemoved(entt::registry& /*aRegistry*/, entt::entity aEntity)
+	{
+		Remove(aEntity);
+	}
+
+	void SceneBVH::Update(const entt::registry& aRegistry, std::span<const entt::entity> aMovedEntities)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		if (myPendingEntities.empty() && myLoadingMeshes.empty() && (myLeafCount == 0 || aMovedEntities.empty())) return;
+
+		const auto* worlds = aRegistry.storage<WorldTransformComponent>();
+		const auto* renderers = aRegistry.storage<MeshRendererComponent>();
+
+		if (!worlds || !renderers)
+		{
+			myPendingEntities.clear();
+			myLoadingMeshes.clear();
+			return;
+		}
+
+		RefitLoadedMeshes(aRegistry);
+
+		if (!myPendingEntities.empty())
+		{
+			EPOCH_PROFILE_SCOPE("Insert pending");
+
+			// Looked up once per mesh and update, a reimported mesh is picked up by the entities that change after it
+			std::unordered_map<AssetHandle, CU::AABB> meshBounds;
+
+			myNewLeaves.clear();
+
+			// An empty tree gets at most one internal node per leaf
+			if (myRoot == NullNode)
+			{
+				myNodes.reserve(myNodes.size() + 2 * myPendingEntities.size());
+				myLeafBounds.reserve(myNodes.capacity());
+			}
+
+			for (entt::entity entity : myPendingEntities)
+			{
+				// Destroyed again or the component was removed before the update
+				if (!renderers->contains(entity) || !worlds->contains(entity)) continue;
+
+				const AssetHandle mesh = renderers->get(entity).Mesh;
+				const CU::AABB localBounds = GetMeshBounds(mesh, meshBounds);
+				const CU::Matrix4x4f& world = worlds->get(entity).Matrix;
+
+				if (auto it = myLoadingMeshes.find(mesh); it != myLoadingMeshes.end())
+				{
+					it->second.Entities.emplace_back(entity);
+				}
+
+				if (const int32_t leaf = GetLeaf(entity); leaf != NullNode)
+				{
+					myLeafBounds[leaf].Local = localBounds;
+
+					// Queued twice, the leaf was created earlier in this loop and isn't linked into the tree yet
+					if (leaf != myRoot && myNodes[leaf].Parent == NullNode)
+					{
+						myLeafBounds[leaf].World = localBounds.GetTransformed(world);
+						myNodes[leaf].Bounds = GetEnlarged(myLeafBounds[leaf].World);
+					}
+					else
+					{
+						Refit(leaf, world);
+					}
+				}
+				else
+				{
+					myNewLeaves.emplace_back(CreateLeaf(entity, localBounds, world));
+				}
+			}
+
+			myPendingEntities.clear();
+
+			// Filling an empty tree (loading a level) builds it top-down in one go, inserting one by one
+			// walks the tree from the root for every leaf
+			if (myRoot == NullNode && !myNewLeaves.empty())
+			{
+				myRoot = Build(myNewLeaves);
+			}
+			else
+			{
+				for (int32_t leaf : myNewLeaves)
+				{
+					InsertLeaf(leaf, myRoot);
+				}
+			}
+		}
+
+		if (myLeafCount > 0)
+		{
+			EPOCH_PROFILE_SCOPE("Refit moved");
+
+			for (entt::entity entity : aMovedEntities)
+			{
+				if (const int32_t leaf = GetLeaf(entity); leaf != NullNode)
+				{
+					Refit(leaf, worlds->get(entity).Matrix);
+				}
+			}
+		}
+	}
+
+	void SceneBVH::Clear()
+	{
+		myNodes.clear();
+		myLeafBounds.clear();
+		myEntityToLeaf.clear();
+		myPendingEntities.clear();
+		myNewLeaves.clear();
+		myLoadingMeshes.clear();
+
+		myRoot = NullNode;
+		myFreeList = NullNode;
+		myLeafCount = 0;
+	}
+
+	entt::entity SceneBVH::RaycastClosest(const CU::Ray& aRay, float aMaxDistance, float& outDistance) const
+	{
+		entt::entity closest = entt::null;
+
+		Raycast(aRay, aMaxDistance, [&closest, &outDistance](entt::entity aEntity, float aDistance)
+			{
+				closest = aEntity;
+				outDistance = aDistance;
+				return aDistance;
+			});
+
+		return closest;
+	}
+
+	const CU::AABB& SceneBVH::GetBounds(entt::entity aEntity) const
+	{
+		const int32_t leaf = GetLeaf(aEntity);
+		EPOCH_ASSERT(leaf != NullNode, "Entity is not in the BVH!");
+		return myLeafBounds[leaf].World;
+	}
+
+	SceneBVH::Containment SceneBVH::Classify(const CU::Frustum& aFrustum, const CU::AABB& aAABB)
+	{
+		// Same test as Frustum::Intersects, which also tells when the box is fully in front of every plane
+		const CU::Vector3f center = aAABB.GetCenter();
+		const CU::Vector3f extents = aAABB.GetExtents();
+
+		Containment result = Containment::Inside;
+
+		for (const CU::Plane& plane : aFrustum.planes)
+		{
+			const float radius = extents.x * std::abs(plane.normal.x) + extents.y * std::abs(plane.normal.y) + extents.z * std::abs(plane.normal.z);
+			const float distance = plane.GetSignedDistance(center);
+
+			if (distance < -radius)
+			{
+				return Containment::Outside;
+			}
+
+			if (distance < radius)
+			{
+				result = Containment::Intersecting;
+			}
+		}
+
+		return result;
+	}
+
+	bool SceneBVH::IntersectRay(const CU::Vector3f& aOrigin, const CU::Vector3f& aInverseDirection, const CU::AABB& aAABB, float aMaxDistance, float& outDistance)
+	{
+		float nearX, farX, nearY, farY, nearZ, farZ;
+		GetSlab(aAABB.min.x, aAABB.max.x, aOrigin.x, aInverseDirection.x, nearX, farX);
+		GetSlab(aAABB.min.y, aAABB.max.y, aOrigin.y, aInverseDirection.y, nearY, farY);
+		GetSlab(aAABB.min.z, aAABB.max.z, aOrigin.z, aInverseDirection.z, nearZ, farZ);
+
+		const float tMin = CU::Math::Max(CU::Math::Max(nearX, nearY), nearZ);
+		const float tMax = CU::Math::Min(CU::Math::Min(farX, farY), farZ);
+
+		if (tMax < 0.0f || tMin > tMax || tMin > aMaxDistance)
+		{
+			return false;
+		}
+
+		outDistance = CU::Math::Max(tMin, 0.0f);
+		return true;
+	}
+
+	CU::AABB SceneBVH::GetEnlarged(const CU::AABB& aAABB)
+	{
+		const CU::Vector3f margin = aAABB.GetExtents() * EnlargeFactor + CU::Vector3f(MinEnlargeMargin);
+		return CU::AABB(aAABB.min - margin, aAABB.max + margin);
+	}
+
+	int32_t SceneBVH::GetLeaf(entt::entity aEntity) const
+	{
+		const size_t index = static_cast<size_t>(entt::to_entity(aEntity));
+		if (index >= myEntityToLeaf.size()) return NullNode;
+
+		const int32_t leaf = myEntityToLeaf[index];
+		if (leaf == NullNode || myNodes[leaf].Entity != aEntity) return NullNode;
+
+		return leaf;
+	}
+
+	CU::AABB SceneBVH::GetMeshBounds(AssetHandle aMesh, std::unordered_map<AssetHandle, CU::AABB>& aCache)
+	{
+		if (auto it = aCache.find(aMesh); it != aCache.end())
+		{
+			return it->second;
+		}
+
+		CU::AABB bounds = GetLocalBounds(nullptr);
+
+		// Not waited for, the entities get their bounds in the first update after the load is done
+		if (aMesh != 0 && Assets::AssetManager::GetAssetManager())
+		{
+			auto future = Assets::AssetManager::GetAssetAsync(TypedAssetHandle<Assets::MeshAsset>(aMesh));
+			if (future.IsReady())
+			{
+				bounds = GetLocalBounds(future.Get());
+			}
+			else
+			{
+				myLoadingMeshes.try_emplace(aMesh, LoadingMesh{ std::move(future), {} });
+			}
+		}
+
+		aCache.emplace(aMesh, bounds);
+		return bounds;
+	}
+
+	void SceneBVH::RefitLoadedMeshes(const entt::registry& aRegistry)
+	{
+		if (myLoadingMeshes.empty()) return;
+
+		EPOCH_PROFILE_FUNC();
+
+		const auto& worlds = *aRegistry.storage<WorldTransformComponent>();
+		const auto& renderers = *aRegistry.storage<MeshRendererComponent>();
+
+		for (auto it = myLoadingMeshes.begin(); it != myLoadingMeshes.end();)
+		{
+			if (!it->second.Future.IsReady())
+			{
+				++it;
+				continue;
+			}
+
+			// A failed load keeps the point, it's not requested again
+			const CU::AABB bounds = GetLocalBounds(it->second.Future.Get());
+
+			for (entt::entity entity : it->second.Entities)
+			{
+				// Removed or given another mesh while it loaded
+				const int32_t leaf = GetLeaf(entity);
+				if (leaf == NullNode || !renderers.contains(entity) || renderers.get(entity).Mesh.Get() != it->first) continue;
+
+				myLeafBounds[leaf].Local = bounds;
+				Refit(leaf, worlds.get(entity).Matrix);
+			}
+
+			it = myLoadingMeshes.erase(it);
+		}
+	}
+
+	int32_t SceneBVH::CreateLeaf(entt::entity aEntity, const CU::AABB& aLocalBounds, const CU::Matrix4x4f& aWorld)
+	{
+		const int32_t leaf = AllocateNode();
+
+		LeafBounds& bounds = myLeafBounds[leaf];
+		bounds.Local = aLocalBounds;
+		bounds.World = aLocalBounds.GetTransformed(aWorld);
+
+		Node& node = myNodes[leaf];
+		node.Bounds = GetEnlarged(bounds.World);
+		node.Entity = aEntity;
+		node.Height = 0;
+
+		const size_t index = static_cast<size_t>(entt::to_entity(aEntity));
+		if (index >= myEntityToLeaf.size())
+		{
+			myEntityToLeaf.resize(index + 1, NullNode);
+		}
+		myEntityToLeaf[index] = leaf;
+
+		++myLeafCount;
+		return leaf;
+	}
+
+	void SceneBVH::Remove(entt::entity aEntity)
+	{
+		const int32_t leaf = GetLeaf(aEntity);
+		if (leaf == NullNode) return;
+
+		RemoveLeaf(leaf);
+		FreeNode(leaf);
+
+		myEntityToLeaf[static_cast<size_t>(entt::to_entity(aEntity))] = NullNode;
+		--myLeafCount;
+	}
+
+	void SceneBVH::Refit(int32_t aLeaf, const CU::Matrix4x4f& aWorld)
+	{
+		LeafBounds& bounds = myLeafBounds[aLeaf];
+		const CU::Vector3f oldCenter = bounds.World.GetCenter();
+		bounds.World = bounds.Local.GetTransformed(aWorld);
+
+		// Stretched ahead along the last movement so an entity moving at a steady pace doesn't leave its box every frame
+		CU::AABB fresh = GetEnlarged(bounds.World);
+		const CU::Vector3f displacement = (bounds.World.GetCenter() - oldCenter) * DisplacementFactor;
+		fresh.Encapsulate(CU::AABB(fresh.min + displacement, fresh.max + displacement));
+
+		const CU::AABB& enlarged = myNodes[aLeaf].Bounds;
+		if (enlarged.Contains(bounds.World) && enlarged.GetSurfaceArea() <= fresh.GetSurfaceArea() * MaxEnlargedAreaRatio) return;
+
+		// The search starts at the lowest former ancestor that still encloses the new box instead of the root,
+		// an entity that moved a bit stays in the same part of the tree and only the nodes around it are touched
+		int32_t start = RemoveLeaf(aLeaf);
+		while (start != NullNode && !myNodes[start].Bounds.Contains(fresh))
+		{
+			start = myNodes[start].Parent;
+		}
+
+		myNodes[aLeaf].Bounds = fresh;
+		InsertLeaf(aLeaf, start != NullNode ? start : myRoot);
+	}
+
+	int32_t SceneBVH::AllocateNode()
+	{
+		if (myFreeList == NullNode)
+		{
+			myNodes.emplace_back();
+			myLeafBounds.emplace_back();
+			return static_cast<int32_t>(myNodes.size() - 1);
+		}
+
+		const int32_t index = myFreeList;
+		Node& node = myNodes[index];
+		myFreeList = node.Parent;
+
+		node = Node();
+		return index;
+	}
+
+	void SceneBVH::FreeNode(int32_t aNode)
+	{
+		Node& node = myNodes[aNode];
+		node.Parent = myFreeList;
+		node.Left = NullNode;
+		node.Right = NullNode;
+		node.Height = -1;
+		node.Entity = entt::null;
+		myFreeList = aNode;
+	}
+
+	int32_t SceneBVH::Build(std::span<const int32_t> aLeaves)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		// The leaves sorted along a Morton curve through their centers and that order split in the middle on every level,
+		// gives a balanced tree with spatially coherent subtrees without partitioning anything
+		CU::AABB centers;
+		for (int32_t leaf : aLeaves)
+		{
+			centers.Encapsulate(myNodes[leaf].Bounds.GetCenter());
+		}
+
+		const CU::Vector3f size = centers.GetSize();
+		const CU::Vector3f scale
+		(
+			size.x > 0.0f ? MortonGridSize / size.x : 0.0f,
+			size.y > 0.0f ? MortonGridSize / size.y : 0.0f,
+			size.z > 0.0f ? MortonGridSize / size.z : 0.0f
+		);
+
+		std::vector<uint64_t> keys(aLeaves.size());
+		for (size_t i = 0; i < aLeaves.size(); ++i)
+		{
+			const CU::Vector3f cell = (myNodes[aLeaves[i]].Bounds.GetCenter() - centers.min) * scale;
+			const uint64_t code = GetMortonCode(static_cast<uint32_t>(cell.x), static_cast<uint32_t>(cell.y), static_cast<uint32_t>(cell.z));
+			keys[i] = code << 32 | static_cast<uint32_t>(aLeaves[i]);
+		}
+
+		SortByMortonCode(keys);
+
+		const int32_t root = BuildSubtree(keys);
+		myNodes[root].Parent = NullNode;
+		return root;
+	}
+
+	int32_t SceneBVH::BuildSubtree(std::span<const uint64_t> aSortedLeaves)
+	{
+		if (aSortedLeaves.size() == 1) return static_cast<int32_t>(aSortedLeaves[0] & 0xFFFFFFFF);
+
+		const size_t leftCount = aSortedLeaves.size() / 2;
+		const int32_t left = BuildSubtree(aSortedLeaves.first(leftCount));
+		const int32_t right = BuildSubtree(aSortedLeaves.subspan(leftCount));
+
+		const int32_t index = AllocateNode();
+		Node& node = myNodes[index];
+		node.Left = left;
+		node.Right = right;
+		node.Height = 1 + std::max(myNodes[left].Height, myNodes[right].Height);
+		node.Bounds = myNodes[left].Bounds;
+		node.Bounds.Encapsulate(myNodes[right].Bounds);
+
+		myNodes[left].Parent = index;
+		myNodes[right].Parent = index;
+
+		return index;
+	}
+
+	void SceneBVH::InsertLeaf(int32_t aLeaf, int32_t aStart)
+	{
+		if (myRoot == NullNode)
+		{
+			myRoot = aLeaf;
+			myNodes[aLeaf].Parent = NullNode;
+			return;
+		}
+
+		const CU::AABB leafBounds = myNodes[aLeaf].Bounds;
+
+		// Walk down towards the child that grows the least, stopping where making a new parent for the current node is cheapest
+		int32_t index = aStart;
+		while (!myNodes[index].IsLeaf())
+		{
+			const Node& node = myNodes[index];
+
+			CU::AABB combined = node.Bounds;
+			combined.Encapsulate(leafBounds);
+			const float combinedArea = combined.GetSurfaceArea();
+
+			// Cost of a new parent for this node and the leaf, and the cost every node below pays for this node growing
+			const float cost = 2.0f * combinedArea;
+			const float inheritanceCost = 2.0f * (combinedArea - node.Bounds.GetSurfaceArea());
+
+			auto descendCost = [this, &leafBounds, inheritanceCost](int32_t aChild)
+				{
+					const Node& child = myNodes[aChild];
+					CU::AABB childCombined = child.Bounds;
+					childCombined.Encapsulate(leafBounds);
+
+					if (child.IsLeaf())
+					{
+						return childCombined.GetSurfaceArea() + inheritanceCost;
+					}
+
+					return childCombined.GetSurfaceArea() - child.Bounds.GetSurfaceArea() + inheritanceCost;
+				};
+
+			const float leftCost = descendCost(node.Left);
+			const float rightCost = descendCost(node.Right);
+
+			if (cost < leftCost && cost < rightCost) break;
+
+			index = leftCost < rightCost ? node.Left : node.Right;
+		}
+
+		const int32_t sibling = index;
+		const int32_t oldParent = myNodes[sibling].Parent;
+
+		// Can reallocate myNodes, no node references are held across it
+		const int32_t newParent = AllocateNode();
+
+		Node& parent = myNodes[newParent];
+		parent.Parent = oldParent;
+		parent.Bounds = myNodes[sibling].Bounds;
+		parent.Bounds.Encapsulate(leafBounds);
+		parent.Height = myNodes[sibling].Height + 1;
+		parent.Left = sibling;
+		parent.Right = aLeaf;
+
+		if (oldParent != NullNode)
+		{
+			Node& grandParent = myNodes[oldParent];
+			if (grandParent.Left == sibling) grandParent.Left = newParent;
+			else grandParent.Right = newParent;
+		}
+		else
+		{
+			myRoot = newParent;
+		}
+
+		myNodes[sibling].Parent = newParent;
+		myNodes[aLeaf].Parent = newParent;
+
+		RefitAncestors(newParent);
+	}
+
+	int32_t SceneBVH::RemoveLeaf(int32_t aLeaf)
+	{
+		if (aLeaf == myRoot)
+		{
+			myRoot = NullNode;
+			return NullNode;
+		}
+
+		const int32_t parent = myNodes[aLeaf].Parent;
+		const int32_t grandParent = myNodes[parent].Parent;
+		const int32_t sibling = myNodes[parent].Left == aLeaf ? myNodes[parent].Right : myNodes[parent].Left;
+
+		FreeNode(parent);
+		myNodes[aLeaf].Parent = NullNode;
+
+		if (grandParent == NullNode)
+		{
+			myRoot = sibling;
+			myNodes[sibling].Parent = NullNode;
+			return NullNode;
+		}
+
+		Node& grandParentNode = myNodes[grandParent];
+		if (grandParentNode.Left == parent) grandParentNode.Left = sibling;
+		else grandParentNode.Right = sibling;
+		myNodes[sibling].Parent = grandParent;
+
+		RefitAncestors(grandParent);
+		return myNodes[sibling].Parent;
+	}
+
+	void SceneBVH::RefitAncestors(int32_t aNode)
+	{
+		for (int32_t index = aNode; index != NullNode; index = myNodes[index].Parent)
+		{
+			const int32_t balanced = Balance(index);
+			const bool rotated = balanced != index;
+			index = balanced;
+
+			Node& node = myNodes[index];
+			const Node& left = myNodes[node.Left];
+			const Node& right = myNodes[node.Right];
+
+			const int32_t height = 1 + std::max(left.Height, right.Height);
+			CU::AABB bounds = left.Bounds;
+			bounds.Encapsulate(right.Bounds);
+
+			// Nothing further up depends on anything but this node's height and bounds. aNode itself always goes through,
+			// its children are new and the values it holds might already be what they add up to.
+			if (!rotated && index != aNode && node.Height == height && IsSame(node.Bounds, bounds)) break;
+
+			node.Height = height;
+			node.Bounds = bounds;
+		}
+	}
+
+	int32_t SceneBVH::Balance(int32_t aNode)
+	{
+		Node& a = myNodes[aNode];
+		if (a.IsLeaf() || a.Height < 2) return aNode;
+
+		const int32_t iB = a.Left;
+		const int32_t iC = a.Right;
+		Node& b = myNodes[iB];
+		Node& c = myNodes[iC];
+
+		// Rotates the taller child up into a's place, a takes the shorter of its grandchildren along.
+		// 'up' is the child moving up, 'other' the one staying below a, 'upIsRight' which side 'up' was on.
+		auto rotate = [this, aNode, &a](int32_t aUp, Node& aUpNode, Node& aOther, bool aUpIsRight)
+			{
+				const int32_t iF = aUpNode.Left;
+				const int32_t iG = aUpNode.Right;
+				Node& f = myNodes[iF];
+				Node& g = myNodes[iG];
+
+				aUpNode.Left = aNode;
+				aUpNode.Parent = a.Parent;
+				a.Parent = aUp;
+
+				if (aUpNode.Parent != NullNode)
+				{
+					Node& parent = myNodes[aUpNode.Parent];
+					if (parent.Left == aNode) parent.Left = aUp;
+					else parent.Right = aUp;
+				}
+				else
+				{
+					myRoot = aUp;
+				}
+
+				const bool keepF = f.Height > g.Height;
+				const int32_t iKept = keepF ? iF : iG;
+				const int32_t iMoved = keepF ? iG : iF;
+				Node& kept = myNodes[iKept];
+				Node& moved = myNodes[iMoved];
+
+				aUpNode.Right = iKept;
+				if (aUpIsRight) a.Right = iMoved;
+				else a.Left = iMoved;
+				moved.Parent = aNode;
+
+				a.Bounds = aOther.Bounds;
+				a.Bounds.Encapsulate(moved.Bounds);
+				aUpNode.Bounds = a.Bounds;
+				aUpNode.Bounds.Encapsulate(kept.Bounds);
+
+				a.Height = 1 + std::max(aOther.Height, moved.Height);
+				aUpNode.Height = 1 + std::max(a.Height, kept.Height);
+			};
+
+		const int32_t balance = c.Height - b.Height;
+
+		if (balance > 1)
+		{
+			rotate(iC, c, b, true);
+			return iC;
+		}
+
+		if (balance < -1)
+		{
+			rotate(iB, b, c, false);
+			return iB;
+		}
+
+		return aNode;
+	}
+}
@@ -0,0 +1,323 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include <entt/entt.hpp>
+#include <CommonUtilities/Math/Geometry/Geometry.h>
+#include <EpochAssets/AssetFuture.h>
+#include <EpochAssets/Assets/MeshAsset.h>
+
+namespace Epoch::Scenes
+{
+	// Dynamic AABB tree over the world space bounds of every entity with a MeshRendererComponent, owned and kept up to date by the Scene.
+	// Leaves store a slightly enlarged box so an entity that moves a little only gets its tight bounds updated,
+	// it's reinserted once it leaves its box. Insertion picks the sibling with the lowest surface area cost
+	// and tree rotations on the way back up keep the height logarithmic.
+	// Queries test the enlarged boxes on the way down and the tight bounds at the leaves, so they report the same entities as a brute force loop.
+	// Meshes are requested without waiting for them, an entity whose mesh is still loading is a point at its origin until the load is done.
+	class SceneBVH
+	{
+	public:
+		SceneBVH() = default;
+		~SceneBVH() = default;
+
+		// Connected to the MeshRendererComponent signals by the Scene. Added and changed entities are (re)inserted
+		// on the next Update(), their world matrix isn't computed before that.
+		void OnMeshRendererChanged(entt::registry& aRegistry, entt::entity aEntity);
+		void OnMeshRendererRemoved(entt::registry& aRegistry, entt::entity aEntity);
+
+		// Refits the entities whose mesh finished loading, inserts the pending entities
+		// and refits the ones in aMovedEntities (entities without a leaf are skipped).
+		void Update(const entt::registry& aRegistry, std::span<const entt::entity> aMovedEntities);
+
+		void Clear();
+
+		// aFunction(entt::entity) for every entity whose bounds overlap the volume
+		template<typename Fn> void Query(const CU::AABB& aAABB, Fn&& aFunction) const;
+		template<typename Fn> void Query(const CU::Sphere& aSphere, Fn&& aFunction) const;
+		// Subtrees fully inside the frustum are reported without testing the leaves
+		template<typename Fn> void Query(const CU::Frustum& aFrustum, Fn&& aFunction) const;
+
+		// aFunction(entt::entity, float distance) for every entity whose bounds the ray hits within aMaxDistance, closer subtrees are visited first.
+		// The returned distance clips the ray for the rest of the traversal, return aMaxDistance to get every hit
+		// or the distance of an exact hit against the entity's geometry to only look for closer ones.
+		template<typename Fn> void Raycast(const CU::Ray& aRay, float aMaxDistance, Fn&& aFunction) const;
+		// Closest entity whose bounds the ray hits, entt::null if none
+		entt::entity RaycastClosest(const CU::Ray& aRay, float aMaxDistance, float& outDistance) const;
+
+		bool Contains(entt::entity aEntity) const { return GetLeaf(aEntity) != NullNode; }
+		// Tight world bounds of an entity in the tree
+		const CU::AABB& GetBounds(entt::entity aEntity) const;
+
+		size_t GetEntityCount() const { return myLeafCount; }
+		size_t GetPendingCount() const { return myPendingEntities.size(); }
+		uint32_t GetHeight() const { return myRoot == NullNode ? 0 : static_cast<uint32_t>(myNodes[myRoot].Height); }
+
+	private:
+		static constexpr int32_t NullNode = -1;
+
+		struct Node
+		{
+			CU::AABB Bounds;				// Enlarged for leaves
+			int32_t Parent = NullNode;		// Next free node while on the free list
+			int32_t Left = NullNode;
+			int32_t Right = NullNode;
+			int32_t Height = 0;				// 0 for leaves, -1 for free nodes
+			entt::entity Entity = entt::null;
+
+			bool IsLeaf() const { return Left == NullNode; }
+		};
+
+		struct LeafBounds
+		{
+			CU::AABB Local;
+			CU::AABB World;
+		};
+
+		// The entities that got a point box because the mesh wasn't loaded when they were inserted
+		struct LoadingMesh
+		{
+			Assets::AssetFuture<Assets::MeshAsset> Future;
+			std::vector<entt::entity> Entities;
+		};
+		// Traversal stack that only allocates for trees deeper than any balanced one should get
+		template<typename T>
+		class Stack
+		{
+		public:
+			bool IsEmpty() const { return myCount == 0; }
+			void Push(const T& aValue)
+			{
+				if (myCount < myInline.size()) myInline[myCount] = aValue;
+				else myOverflow.emplace_back(aValue);
+				++myCount;
+			}
+			T Pop()
+			{
+				--myCount;
+				if (myCount < myInline.size()) return myInline[myCount];
+				T value = myOverflow.back();
+				myOverflow.pop_back();
+				return value;
+			}
+
+		private:
+			std::array<T, 64> myInline;
+			std::vector<T> myOverflow;
+			size_t myCount = 0;
+		};
+
+		enum class Containment { Outside, Intersecting, Inside };
+		static Containment Classify(const CU::Frustum& aFrustum, const CU::AABB& aAABB);
+		// Slab test with the inverse direction precomputed, outDistance is clamped to 0 for rays starting inside
+		static bool IntersectRay(const CU::Vector3f& aOrigin, const CU::Vector3f& aInverseDirection, const CU::AABB& aAABB, float aMaxDistance, float& outDistance);
+		static CU::AABB GetEnlarged(const CU::AABB& aAABB);
+
+		int32_t GetLeaf(entt::entity aEntity) const;
+		// Local bounds of the mesh, a point if it isn't loaded. A mesh that's still loading is added to myLoadingMeshes.
+		CU::AABB GetMeshBounds(AssetHandle aMesh, std::unordered_map<AssetHandle, CU::AABB>& aCache);
+		void RefitLoadedMeshes(const entt::registry& aRegistry);
+		// The leaf isn't linked into the tree yet
+		int32_t CreateLeaf(entt::entity aEntity, const CU::AABB& aLocalBounds, const CU::Matrix4x4f& aWorld);
+		void Remove(entt::entity aEntity);
+		// Updates the tight bounds and moves the leaf if they left its enlarged box
+		void Refit(int32_t aLeaf, const CU::Matrix4x4f& aWorld);
+
+		int32_t AllocateNode();
+		void FreeNode(int32_t aNode);
+		// Links the leaves into a new tree and returns its root
+		int32_t Build(std::span<const int32_t> aLeaves);
+		int32_t BuildSubtree(std::span<const uint64_t> aSortedLeaves);
+		// Links the leaf in below aStart, or in its place
+		void InsertLeaf(int32_t aLeaf, int32_t aStart);
+		// Unlinks the leaf and returns the node its sibling now hangs under, NullNode if the sibling became the root
+		int32_t RemoveLeaf(int32_t aLeaf);
+		void RefitAncestors(int32_t aNode);
+		int32_t Balance(int32_t aNode);
+
+	private:
+		std::vector<Node> myNodes;
+		std::vector<LeafBounds> myLeafBounds;	// Same index as myNodes, only used for leaves
+		std::vector<int32_t> myEntityToLeaf;	// Indexed by entity index, the leaf's Entity has to match including the version
+		std::vector<entt::entity> myPendingEntities;
+		std::vector<int32_t> myNewLeaves;	// Kept between updates so a frame doesn't allocate once it has grown
+		std::unordered_map<AssetHandle, LoadingMesh> myLoadingMeshes;
+
+		int32_t myRoot = NullNode;
+		int32_t myFreeList = NullNode;
+		size_t myLeafCount = 0;
+	};
+
+	template<typename Fn>
+	inline void SceneBVH::Query(const CU::AABB& aAABB, Fn&& aFunction) const
+	{
+		if (myRoot == NullNode) return;
+
+		Stack<int32_t> stack;
+		stack.Push(myRoot);
+
+		while (!stack.IsEmpty())
+		{
+			const int32_t index = stack.Pop();
+			const Node& node = myNodes[index];
+
+			if (!node.Bounds.Intersects(aAABB)) continue;
+
+			if (node.IsLeaf())
+			{
+				if (myLeafBounds[index].World.Intersects(aAABB))
+				{
+					aFunction(node.Entity);
+				}
+			}
+			else
+			{
+				stack.Push(node.Right);
+				stack.Push(node.Left);
+			}
+		}
+	}
+
+	template<typename Fn>
+	inline void SceneBVH::Query(const CU::Sphere& aSphere, Fn&& aFunction) const
+	{
+		if (myRoot == NullNode) return;
+
+		const CU::AABB sphereBounds = aSphere.GetAABB();
+
+		Stack<int32_t> stack;
+		stack.Push(myRoot);
+
+		while (!stack.IsEmpty())
+		{
+			const int32_t index = stack.Pop();
+			const Node& node = myNodes[index];
+
+			// The box test rejects most nodes before the more expensive closest point test
+			if (!node.Bounds.Intersects(sphereBounds) || !aSphere.Intersects(node.Bounds)) continue;
+
+			if (node.IsLeaf())
+			{
+				if (aSphere.Intersects(myLeafBounds[index].World))
+				{
+					aFunction(node.Entity);
+				}
+			}
+			else
+			{
+				stack.Push(node.Right);
+				stack.Push(node.Left);
+			}
+		}
+	}
+
+	template<typename Fn>
+	inline void SceneBVH::Query(const CU::Frustum& aFrustum, Fn&& aFunction) const
+	{
+		if (myRoot == NullNode) return;
+
+		struct Entry
+		{
+			int32_t Node;
+			bool Inside;
+		};
+
+		Stack<Entry> stack;
+		stack.Push({ myRoot, false });
+
+		while (!stack.IsEmpty())
+		{
+			const Entry entry = stack.Pop();
+			const Node& node = myNodes[entry.Node];
+
+			bool inside = entry.Inside;
+			if (!inside)
+			{
+				const Containment containment = Classify(aFrustum, node.IsLeaf() ? myLeafBounds[entry.Node].World : node.Bounds);
+				if (containment == Containment::Outside) continue;
+				inside = containment == Containment::Inside;
+			}
+
+			if (node.IsLeaf())
+			{
+				aFunction(node.Entity);
+			}
+			else
+			{
+				stack.Push({ node.Right, inside });
+				stack.Push({ node.Left, inside });
+			}
+		}
+	}
+
+	template<typename Fn>
+	inline void SceneBVH::Raycast(const CU::Ray& aRay, float aMaxDistance, Fn&& aFunction) const
+	{
+		if (myRoot == NullNode) return;
+
+		const CU::Vector3f inverseDirection = aRay.GetInverseDirection();
+
+		struct Entry
+		{
+			int32_t Node;
+			float Distance;
+		};
+
+		float maxDistance = aMaxDistance;
+		float rootDistance;
+		if (!IntersectRay(aRay.origin, inverseDirection, myNodes[myRoot].Bounds, maxDistance, rootDistance)) return;
+
+		Stack<Entry> stack;
+		stack.Push({ myRoot, rootDistance });
+
+		while (!stack.IsEmpty())
+		{
+			const Entry entry = stack.Pop();
+
+			// A closer hit may have clipped the ray since this node was pushed
+			if (entry.Distance > maxDistance) continue;
+
+			const Node& node = myNodes[entry.Node];
+
+			if (node.IsLeaf())
+			{
+				float distance;
+				if (IntersectRay(aRay.origin, inverseDirection, myLeafBounds[entry.Node].World, maxDistance, distance))
+				{
+					const float clipDistance = aFunction(node.Entity, distance);
+					maxDistance = CU::Math::Min(maxDistance, clipDistance);
+				}
+				continue;
+			}
+
+			float leftDistance, rightDistance;
+			const bool hitLeft = IntersectRay(aRay.origin, inverseDirection, myNodes[node.Left].Bounds, maxDistance, leftDistance);
+			const bool hitRight = IntersectRay(aRay.origin, inverseDirection, myNodes[node.Right].Bounds, maxDistance, rightDistance);
+
+			// The far child goes on the stack first so the near one is visited first
+			if (hitLeft && hitRight)
+			{
+				if (leftDistance <= rightDistance)
+				{
+					stack.Push({ node.Right, rightDistance });
+					stack.Push({ node.Left, leftDistance });
+				}
+				else
+				{
+					stack.Push({ node.Left, leftDistance });
+					stack.Push({ node.Right, rightDistance });
+				}
+			}
+			else if (hitLeft)
+			{
+				stack.Push({ node.Left, leftDistance });
+			}
+			else if (hitRight)
+			{
+				stack.Push({ node.Right, rightDistance });
+			}
+		}
+	}
+}
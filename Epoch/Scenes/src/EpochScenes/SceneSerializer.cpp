@@ -1,13 +1,732 @@
 #include "SceneSerializer.h"
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <EpochCore/MappedFile.h>
+#include <EpochCore/Profiler.h>
+#include <EpochSerialization/YAMLHelpers.h>
+#include <yaml-cpp/eventhandler.h>
 
 namespace Epoch::Scenes
 {
+	namespace
+	{
+		// Binary scene layout (little endian):
+		//	SceneFileHeader
+		//	One block per SceneBlock, each starting at a BlockAlignment boundary and indexed by entity
+		//	in depth-first order, so every parent comes before its children and siblings keep their order.
+		// Anything that changes the layout has to bump SceneFileVersion.
+		constexpr uint32_t SceneFileMagic = 0x4E435345; // "ESCN"
+		constexpr uint32_t SceneFileVersion = 1;
+		constexpr uint64_t BlockAlignment = 16;
+		constexpr uint32_t NoParent = UINT32_MAX;
+
+		enum class SceneBlock : uint32_t
+		{
+			IDs,			// uint64_t
+			Names,			// NameEntry
+			Parents,		// uint32_t entity index, NoParent for roots
+			Transforms,		// CU::CompactTransform
+			MeshRenderers,	// MeshRendererEntry, only for the entities that have one
+			Strings,		// char, the names without terminators
+
+			Count
+		};
+
+		struct BlockRange
+		{
+			uint64_t Offset = 0;
+			uint64_t Size = 0;
+		};
+
+		struct SceneFileHeader
+		{
+			uint32_t Magic = SceneFileMagic;
+			uint32_t Version = SceneFileVersion;
+			uint32_t EntityCount = 0;
+			uint32_t MeshRendererCount = 0;
+			BlockRange Blocks[static_cast<size_t>(SceneBlock::Count)];
+		};
+
+		struct NameEntry
+		{
+			uint32_t Offset;
+			uint32_t Length;
+		};
+
+		struct MeshRendererEntry
+		{
+			uint32_t Entity;
+			uint32_t Padding;
+			uint64_t Mesh;
+		};
+
+		static_assert(std::is_trivially_copyable_v<CU::CompactTransform>);
+
+		constexpr uint64_t AlignUp(uint64_t aValue)
+		{
+			return (aValue + BlockAlignment - 1) & ~(BlockAlignment - 1);
+		}
+
+		template<typename T>
+		std::span<const T> GetBlock(const Core::MappedFile& aFile, const SceneFileHeader& aHeader, SceneBlock aBlock, size_t aCount)
+		{
+			const BlockRange& range = aHeader.Blocks[static_cast<size_t>(aBlock)];
+			if (range.Size != aCount * sizeof(T) || range.Offset % BlockAlignment != 0 || range.Offset > aFile.GetSize() || range.Size > aFile.GetSize() - range.Offset)
+			{
+				return {};
+			}
+
+			return { reinterpret_cast<const T*>(aFile.GetData() + range.Offset), aCount };
+		}
+
+		// Text scene layout:
+		//	Version: SceneTextVersion
+		//	Entities:
+		//	  - Entity: <UUID>
+		//	    Name: <string>
+		//	    Parent: <UUID>, left out for roots
+		//	    TransformComponent: { Translation: [x, y, z], Rotation: [x, y, z, w], Scale: [x, y, z] }
+		//	    MeshRendererComponent: { Mesh: <AssetHandle> }, only for the entities that have one
+		constexpr uint32_t SceneTextVersion = 1;
+
+		// One entity of a text scene, handed over as soon as its map ends
+		struct TextEntity
+		{
+			uint64_t ID = 0;
+			uint64_t Parent = 0;
+			std::string Name;
+			CU::CompactTransform Transform;
+			bool HasMeshRenderer = false;
+			uint64_t Mesh = 0;
+		};
+
+		// Turns the parser events into TextEntity entries without building a document. Only the keys of the open
+		// containers are kept, unknown keys and everything nested under them are skipped.
+		template<typename OnEntityFn>
+		class SceneTextReader final : public YAML::EventHandler
+		{
+		public:
+			explicit SceneTextReader(OnEntityFn aOnEntity) : myOnEntity(std::move(aOnEntity)) {}
+
+			const std::string& GetError() const { return myError; }
+
+			void OnDocumentStart(const YAML::Mark&) override {}
+			void OnDocumentEnd() override {}
+
+			void OnNull(const YAML::Mark& aMark, YAML::anchor_t) override
+			{
+				OnValue(aMark, {});
+			}
+
+			void OnAlias(const YAML::Mark& aMark, YAML::anchor_t) override
+			{
+				SetError(aMark, "aliases aren't supported");
+				OnValue(aMark, {});
+			}
+
+			void OnScalar(const YAML::Mark& aMark, const std::string&, YAML::anchor_t, const std::string& aValue) override
+			{
+				OnValue(aMark, aValue);
+			}
+
+			void OnSequenceStart(const YAML::Mark& aMark, const std::string&, YAML::anchor_t, YAML::EmitterStyle::value) override
+			{
+				if (IsInEntities(ComponentDepth))
+				{
+					myVectorMark = aMark;
+					myVectorSize = 0;
+				}
+
+				myFrames.push_back({ false });
+			}
+
+			void OnSequenceEnd() override
+			{
+				myFrames.pop_back();
+
+				if (IsInEntities(ComponentDepth))
+				{
+					EndVector();
+				}
+
+				EndValue();
+			}
+
+			void OnMapStart(const YAML::Mark&, const std::string&, YAML::anchor_t, YAML::EmitterStyle::value) override
+			{
+				if (IsInEntities(EntitiesDepth))
+				{
+					myEntity = TextEntity();
+				}
+				else if (IsInEntities(EntityDepth) && myFrames.back().Key == "MeshRendererComponent")
+				{
+					myEntity.HasMeshRenderer = true;
+				}
+
+				myFrames.push_back({ true });
+			}
+
+			void OnMapEnd() override
+			{
+				myFrames.pop_back();
+
+				if (IsInEntities(EntitiesDepth) && myError.empty())
+				{
+					myOnEntity(myEntity);
+				}
+
+				EndValue();
+			}
+
+		private:
+			// Number of open containers while inside the root map, the entity list, an entity, a component and a vector
+			static constexpr size_t RootDepth = 1;
+			static constexpr size_t EntitiesDepth = 2;
+			static constexpr size_t EntityDepth = 3;
+			static constexpr size_t ComponentDepth = 4;
+			static constexpr size_t VectorDepth = 5;
+
+			struct Frame
+			{
+				bool IsMap;
+				bool HasKey = false;
+				std::string Key;
+			};
+
+			bool IsInEntities(size_t aDepth) const
+			{
+				return myFrames.size() == aDepth && aDepth >= EntitiesDepth && myFrames[0].Key == "Entities" && !myFrames[1].IsMap;
+			}
+
+			void OnValue(const YAML::Mark& aMark, const std::string& aValue)
+			{
+				if (myFrames.empty())
+				{
+					SetError(aMark, "expected a map");
+					return;
+				}
+
+				Frame& frame = myFrames.back();
+				if (frame.IsMap && !frame.HasKey)
+				{
+					frame.Key = aValue;
+					frame.HasKey = true;
+					return;
+				}
+
+				HandleValue(aMark, aValue);
+				EndValue();
+			}
+
+			void EndValue()
+			{
+				if (!myFrames.empty() && myFrames.back().IsMap)
+				{
+					myFrames.back().HasKey = false;
+				}
+			}
+
+			void HandleValue(const YAML::Mark& aMark, const std::string& aValue)
+			{
+				const std::string& key = myFrames.back().Key;
+
+				if (myFrames.size() == RootDepth && key == "Version")
+				{
+					uint32_t version = 0;
+					if (!Decode(aMark, aValue, version)) return;
+
+					if (version != SceneTextVersion)
+					{
+						SetError(aMark, std::format("version {} can't be loaded, only version {}", version, SceneTextVersion));
+					}
+				}
+				else if (IsInEntities(EntityDepth))
+				{
+					if (key == "Entity") Decode(aMark, aValue, myEntity.ID);
+					else if (key == "Name") myEntity.Name = aValue;
+					else if (key == "Parent") Decode(aMark, aValue, myEntity.Parent);
+				}
+				else if (IsInEntities(ComponentDepth))
+				{
+					if (myFrames[2].Key == "MeshRendererComponent" && key == "Mesh") Decode(aMark, aValue, myEntity.Mesh);
+				}
+				else if (IsInEntities(VectorDepth) && myFrames[3].IsMap)
+				{
+					if (myVectorSize < std::size(myVector) && !Decode(aMark, aValue, myVector[myVectorSize])) return;
+					++myVectorSize;
+				}
+			}
+
+			void EndVector()
+			{
+				if (myFrames[2].Key != "TransformComponent") return;
+
+				const std::string& key = myFrames[3].Key;
+				const size_t expectedSize = key == "Rotation" ? 4 : 3;
+				if ((key == "Translation" || key == "Rotation" || key == "Scale") && myVectorSize != expectedSize)
+				{
+					SetError(myVectorMark, std::format("{} needs {} values, got {}", key, expectedSize, myVectorSize));
+					return;
+				}
+
+				if (key == "Translation") myEntity.Transform.SetTranslation({ myVector[0], myVector[1], myVector[2] });
+				else if (key == "Rotation") myEntity.Transform.SetRotation({ myVector[3], myVector[0], myVector[1], myVector[2] });
+				else if (key == "Scale") myEntity.Transform.SetScale({ myVector[0], myVector[1], myVector[2] });
+			}
+
+			template<typename T>
+			bool Decode(const YAML::Mark& aMark, const std::string& aValue, T& outValue)
+			{
+				if (DecodeScalar(aValue, outValue)) return true;
+
+				SetError(aMark, std::format("'{}' isn't a valid {}", aValue, myFrames.back().Key));
+				return false;
+			}
+
+			void SetError(const YAML::Mark& aMark, std::string_view aMessage)
+			{
+				if (myError.empty())
+				{
+					myError = std::format("line {}: {}", aMark.line + 1, aMessage);
+				}
+			}
+
+		private:
+			OnEntityFn myOnEntity;
+
+			std::vector<Frame> myFrames;
+			TextEntity myEntity;
+
+			float myVector[4] = {};
+			size_t myVectorSize = 0;
+			YAML::Mark myVectorMark;
+
+			std::string myError;
+		};
+	}
+
 	void SceneSerializer::SerializeText(const std::filesystem::path& aFilepath)
 	{
+		EPOCH_PROFILE_FUNC();
+
+		Scene& scene = *myScene;
+		if (scene.myHierarchyChanged)
+		{
+			scene.SortHierarchy();
+		}
+
+		std::ofstream stream(aFilepath);
+		if (!stream)
+		{
+			LOG_ERROR("Failed to open '{}' for writing", aFilepath.string());
+			return;
+		}
+
+		auto& registry = scene.myRegistry;
+		const auto& hierarchies = registry.storage<HierarchyComponent>();
+		const auto& ids = registry.storage<IDComponent>();
+		const auto& names = registry.storage<NameComponent>();
+		const auto& transforms = registry.storage<TransformComponent>();
+		const auto& meshRenderers = registry.storage<MeshRendererComponent>();
+
+		// Emits straight into the file, only the state of the open containers is kept
+		YAML::Emitter out(stream);
+		out << YAML::BeginMap;
+		out << YAML::Key << "Version" << YAML::Value << SceneTextVersion;
+		out << YAML::Key << "Entities" << YAML::Value << YAML::BeginSeq;
+
+		for (auto [entity, hierarchy] : hierarchies.each())
+		{
+			out << YAML::BeginMap;
+			out << YAML::Key << "Entity" << YAML::Value << (uint64_t)ids.get(entity).ID;
+			out << YAML::Key << "Name" << YAML::Value << names.get(entity).Name;
+
+			if (hierarchy.Parent != entt::null)
+			{
+				out << YAML::Key << "Parent" << YAML::Value << (uint64_t)ids.get(hierarchy.Parent).ID;
+			}
+
+			const CU::CompactTransform& transform = transforms.get(entity).LocalTransform;
+			const CU::Quatf& rotation = transform.GetRotation();
+			out << YAML::Key << "TransformComponent" << YAML::Value << YAML::BeginMap;
+			out << YAML::Key << "Translation" << YAML::Value << transform.GetTranslation();
+			out << YAML::Key << "Rotation" << YAML::Value << CU::Vector4f(rotation.x, rotation.y, rotation.z, rotation.w);
+			out << YAML::Key << "Scale" << YAML::Value << transform.GetScale();
+			out << YAML::EndMap;
+
+			if (meshRenderers.contains(entity))
+			{
+				out << YAML::Key << "MeshRendererComponent" << YAML::Value << YAML::BeginMap;
+				out << YAML::Key << "Mesh" << YAML::Value << (uint64_t)meshRenderers.get(entity).Mesh.Get();
+				out << YAML::EndMap;
+			}
+
+			out << YAML::EndMap;
+		}
+
+		out << YAML::EndSeq;
+		out << YAML::EndMap;
+
+		if (!out.good() || !stream)
+		{
+			LOG_ERROR("Failed to write scene '{}'\n     {}", aFilepath.string(), out.GetLastError());
+		}
 	}
 
 	bool SceneSerializer::DeserializeText(const std::filesystem::path& aFilepath)
 	{
-		return false;
+		EPOCH_PROFILE_FUNC();
+
+		std::ifstream stream(aFilepath);
+		if (!stream)
+		{
+			LOG_ERROR("Failed to open scene '{}'", aFilepath.string());
+			return false;
+		}
+
+		Scene& scene = *myScene;
+		auto& registry = scene.myRegistry;
+		auto& hierarchies = registry.storage<HierarchyComponent>();
+		auto& worlds = registry.storage<WorldTransformComponent>();
+
+		const bool wasEmpty = hierarchies.empty();
+
+		std::vector<entt::entity> createdEntities;
+		// Parents are looked up by the IDs in the file, an entity that got a new ID is still found by its old one
+		// and an entity already in the scene with the same ID isn't
+		EntityIDMap fileEntities;
+		// Children listed before their parent, only possible in hand edited files
+		std::vector<std::pair<entt::entity, uint64_t>> unresolvedParents;
+
+		auto onEntity = [&](const TextEntity& aEntity)
+			{
+				const entt::entity entity = registry.create();
+				createdEntities.push_back(entity);
+
+				UUID id = aEntity.ID;
+				if (aEntity.ID == 0 || scene.myIDToEntityMap.Contains(id))
+				{
+					LOG_WARNING("Entity '{}' in scene '{}' has a missing or duplicate ID, it gets a new one", aEntity.Name, aFilepath.string());
+					id = UUID();
+				}
+
+				registry.emplace<IDComponent>(entity, id);
+				registry.emplace<NameComponent>(entity, aEntity.Name);
+				registry.emplace<HierarchyComponent>(entity);
+				registry.emplace<TransformComponent>(entity, aEntity.Transform);
+				registry.emplace<WorldTransformComponent>(entity);
+				scene.myIDToEntityMap.Insert(id, entity);
+
+				if (aEntity.ID != 0 && !fileEntities.Contains(aEntity.ID))
+				{
+					fileEntities.Insert(aEntity.ID, entity);
+				}
+
+				if (aEntity.HasMeshRenderer)
+				{
+					registry.emplace<MeshRendererComponent>(entity, AssetHandle(aEntity.Mesh));
+				}
+
+				const entt::entity parent = aEntity.Parent != 0 ? fileEntities.Find(aEntity.Parent) : entt::null;
+				if (parent != entt::null)
+				{
+					scene.AttachChild(entity, parent);
+					hierarchies.get(entity).Depth = hierarchies.get(parent).Depth + 1;
+				}
+				else if (aEntity.Parent != 0)
+				{
+					unresolvedParents.emplace_back(entity, aEntity.Parent);
+				}
+
+				// Children of an entity that is already dirty get their world matrix along with it
+				if (parent == entt::null || !worlds.get(parent).IsDirty)
+				{
+					scene.MarkTransformDirty({ entity, &scene });
+				}
+			};
+
+		SceneTextReader reader(onEntity);
+		std::string error;
+		try
+		{
+			YAML::Parser parser(stream);
+			parser.HandleNextDocument(reader);
+			error = reader.GetError();
+		}
+		catch (const YAML::Exception& e)
+		{
+			error = e.what();
+		}
+
+		if (!error.empty())
+		{
+			LOG_ERROR("Failed to load scene '{}'\n     {}", aFilepath.string(), error);
+
+			// Children first, DestroyEntity takes the whole subtree with it
+			for (auto it = createdEntities.rbegin(); it != createdEntities.rend(); ++it)
+			{
+				if (registry.valid(*it))
+				{
+					scene.DestroyEntity({ *it, &scene });
+				}
+			}
+			return false;
+		}
+
+		for (const auto& [entity, parentID] : unresolvedParents)
+		{
+			const entt::entity parent = fileEntities.Find(parentID);
+			if (parent == entt::null)
+			{
+				LOG_WARNING("Parent {} of entity '{}' in scene '{}' doesn't exist", parentID, registry.get<NameComponent>(entity).Name, aFilepath.string());
+				continue;
+			}
+
+			scene.ParentEntity({ entity, &scene }, { parent, &scene });
+		}
+
+		if (wasEmpty && !createdEntities.empty())
+		{
+			// The pools iterate newest first, put the roots back in file order so saving again gives the same file
+			hierarchies.sort_as(createdEntities.begin(), createdEntities.end());
+			scene.SortHierarchy();
+		}
+		else if (!createdEntities.empty())
+		{
+			scene.myHierarchyChanged = true;
+		}
+
+		return true;
+	}
+
+	bool SceneSerializer::SerializeBinary(const std::filesystem::path& aFilepath)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		Scene& scene = *myScene;
+		if (scene.myHierarchyChanged)
+		{
+			scene.SortHierarchy();
+		}
+
+		auto& registry = scene.myRegistry;
+		const auto& hierarchies = registry.storage<HierarchyComponent>();
+		const auto& ids = registry.storage<IDComponent>();
+		const auto& names = registry.storage<NameComponent>();
+		const auto& transforms = registry.storage<TransformComponent>();
+		const auto& meshRenderers = registry.storage<MeshRendererComponent>();
+
+		const size_t entityCount = hierarchies.size();
+
+		std::vector<uint64_t> idBlock;
+		std::vector<NameEntry> nameBlock;
+		std::vector<uint32_t> parentBlock;
+		std::vector<CU::CompactTransform> transformBlock;
+		std::vector<MeshRendererEntry> meshRendererBlock;
+		std::string stringBlock;
+
+		idBlock.reserve(entityCount);
+		nameBlock.reserve(entityCount);
+		parentBlock.reserve(entityCount);
+		transformBlock.reserve(entityCount);
+		meshRendererBlock.reserve(meshRenderers.size());
+
+		// Entity -> index in the file, the pool is already depth-first so the parent's index is always known
+		std::vector<uint32_t> fileIndices(registry.storage<entt::entity>().size(), NoParent);
+
+		for (auto [entity, hierarchy] : hierarchies.each())
+		{
+			const uint32_t index = static_cast<uint32_t>(idBlock.size());
+			fileIndices[entt::to_entity(entity)] = index;
+
+			const std::string& name = names.get(entity).Name;
+			nameBlock.push_back({ static_cast<uint32_t>(stringBlock.size()), static_cast<uint32_t>(name.size()) });
+			stringBlock.append(name);
+
+			idBlock.push_back(ids.get(entity).ID);
+			parentBlock.push_back(hierarchy.Parent != entt::null ? fileIndices[entt::to_entity(hierarchy.Parent)] : NoParent);
+			transformBlock.push_back(transforms.get(entity).LocalTransform);
+
+			if (meshRenderers.contains(entity))
+			{
+				meshRendererBlock.push_back({ index, 0, meshRenderers.get(entity).Mesh.Get() });
+			}
+		}
+
+		SceneFileHeader header;
+		header.EntityCount = static_cast<uint32_t>(entityCount);
+		header.MeshRendererCount = static_cast<uint32_t>(meshRendererBlock.size());
+
+		const std::pair<const void*, uint64_t> blocks[] =
+		{
+			{ idBlock.data(), idBlock.size() * sizeof(uint64_t) },
+			{ nameBlock.data(), nameBlock.size() * sizeof(NameEntry) },
+			{ parentBlock.data(), parentBlock.size() * sizeof(uint32_t) },
+			{ transformBlock.data(), transformBlock.size() * sizeof(CU::CompactTransform) },
+			{ meshRendererBlock.data(), meshRendererBlock.size() * sizeof(MeshRendererEntry) },
+			{ stringBlock.data(), stringBlock.size() },
+		};
+		static_assert(std::size(blocks) == static_cast<size_t>(SceneBlock::Count));
+
+		uint64_t offset = AlignUp(sizeof(SceneFileHeader));
+		for (size_t i = 0; i < std::size(blocks); ++i)
+		{
+			header.Blocks[i] = { offset, blocks[i].second };
+			offset = AlignUp(offset + blocks[i].second);
+		}
+
+		std::ofstream stream(aFilepath, std::ios::binary | std::ios::trunc);
+		if (!stream)
+		{
+			LOG_ERROR("Failed to open '{}' for writing", aFilepath.string());
+			return false;
+		}
+
+		const char padding[BlockAlignment] = {};
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stream.write(padding, header.Blocks[0].Offset - sizeof(header));
+
+		for (size_t i = 0; i < std::size(blocks); ++i)
+		{
+			stream.write(static_cast<const char*>(blocks[i].first), blocks[i].second);
+			stream.write(padding, AlignUp(blocks[i].second) - blocks[i].second);
+		}
+
+		return stream.good();
+	}
+
+	bool SceneSerializer::DeserializeBinary(const std::filesystem::path& aFilepath)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		Core::MappedFile file(aFilepath);
+		if (!file.IsOpen() || file.GetSize() < sizeof(SceneFileHeader))
+		{
+			LOG_ERROR("Failed to open scene '{}'", aFilepath.string());
+			return false;
+		}
+
+		SceneFileHeader header;
+		std::memcpy(&header, file.GetData(), sizeof(header));
+
+		if (header.Magic != SceneFileMagic)
+		{
+			LOG_ERROR("'{}' is not a binary scene", aFilepath.string());
+			return false;
+		}
+
+		if (header.Version != SceneFileVersion)
+		{
+			LOG_ERROR("Scene '{}' has version {}, only version {} can be loaded", aFilepath.string(), header.Version, SceneFileVersion);
+			return false;
+		}
+
+		const size_t entityCount = header.EntityCount;
+		const auto idBlock = GetBlock<uint64_t>(file, header, SceneBlock::IDs, entityCount);
+		const auto nameBlock = GetBlock<NameEntry>(file, header, SceneBlock::Names, entityCount);
+		const auto parentBlock = GetBlock<uint32_t>(file, header, SceneBlock::Parents, entityCount);
+		const auto transformBlock = GetBlock<CU::CompactTransform>(file, header, SceneBlock::Transforms, entityCount);
+		const auto meshRendererBlock = GetBlock<MeshRendererEntry>(file, header, SceneBlock::MeshRenderers, header.MeshRendererCount);
+		const BlockRange& stringRange = header.Blocks[static_cast<size_t>(SceneBlock::Strings)];
+		const auto stringBlock = GetBlock<char>(file, header, SceneBlock::Strings, stringRange.Size);
+
+		const bool hasAllBlocks = (entityCount == 0 || (idBlock.data() && nameBlock.data() && parentBlock.data() && transformBlock.data()))
+			&& (header.MeshRendererCount == 0 || meshRendererBlock.data()) && (stringRange.Size == 0 || stringBlock.data());
+
+		bool isValid = hasAllBlocks;
+		for (size_t i = 0; isValid && i < entityCount; ++i)
+		{
+			isValid = (parentBlock[i] == NoParent || parentBlock[i] < i) && nameBlock[i].Offset <= stringBlock.size() && nameBlock[i].Length <= stringBlock.size() - nameBlock[i].Offset;
+		}
+		// An entity can only have one mesh renderer
+		std::vector<bool> hasMeshRenderer(isValid ? entityCount : 0);
+		for (size_t i = 0; isValid && i < meshRendererBlock.size(); ++i)
+		{
+			const uint32_t entity = meshRendererBlock[i].Entity;
+			isValid = entity < entityCount && !hasMeshRenderer[entity];
+			if (isValid)
+			{
+				hasMeshRenderer[entity] = true;
+			}
+		}
+
+		if (!isValid)
+		{
+			LOG_ERROR("Scene '{}' is corrupt", aFilepath.string());
+			return false;
+		}
+
+		Scene& scene = *myScene;
+		auto& registry = scene.myRegistry;
+
+		std::vector<entt::entity> entities(entityCount);
+		registry.create(entities.begin(), entities.end());
+
+		auto& ids = registry.storage<IDComponent>();
+		auto& names = registry.storage<NameComponent>();
+		auto& hierarchies = registry.storage<HierarchyComponent>();
+		auto& transforms = registry.storage<TransformComponent>();
+		auto& worlds = registry.storage<WorldTransformComponent>();
+		auto& meshRenderers = registry.storage<MeshRendererComponent>();
+
+		// A scene loaded into an empty one comes out already sorted
+		const bool wasEmpty = hierarchies.empty();
+
+		ids.reserve(ids.size() + entityCount);
+		names.reserve(names.size() + entityCount);
+		hierarchies.reserve(hierarchies.size() + entityCount);
+		transforms.reserve(transforms.size() + entityCount);
+		worlds.reserve(worlds.size() + entityCount);
+		meshRenderers.reserve(meshRenderers.size() + meshRendererBlock.size());
+		scene.myIDToEntityMap.Reserve(scene.myIDToEntityMap.Size() + entityCount);
+
+		// Emplaced back to front, entt iterates pools from the last element so they iterate depth-first
+		for (size_t i = entityCount; i-- > 0;)
+		{
+			const entt::entity entity = entities[i];
+			const NameEntry& nameEntry = nameBlock[i];
+			const std::string_view name(stringBlock.data() + nameEntry.Offset, nameEntry.Length);
+
+			UUID id = idBlock[i];
+			if (idBlock[i] == 0 || scene.myIDToEntityMap.Contains(id))
+			{
+				LOG_WARNING("Entity '{}' in scene '{}' has a missing or duplicate ID, it gets a new one", name, aFilepath.string());
+				id = UUID();
+			}
+
+			ids.emplace(entity, id);
+			names.emplace(entity, name);
+			hierarchies.emplace(entity);
+			transforms.emplace(entity, transformBlock[i]);
+			worlds.emplace(entity);
+
+			scene.myIDToEntityMap.Insert(id, entity);
+		}
+
+		for (size_t i = 0; i < entityCount; ++i)
+		{
+			const uint32_t parent = parentBlock[i];
+			if (parent == NoParent)
+			{
+				scene.MarkTransformDirty({ entities[i], &scene });
+				continue;
+			}
+
+			scene.AttachChild(entities[i], entities[parent]);
+			hierarchies.get(entities[i]).Depth = hierarchies.get(entities[parent]).Depth + 1;
+		}
+
+		for (const MeshRendererEntry& entry : meshRendererBlock)
+		{
+			meshRenderers.emplace(entities[entry.Entity], AssetHandle(entry.Mesh));
+		}
+
+		if (!wasEmpty)
+		{
+			scene.myHierarchyChanged = true;
+		}
+
+		return true;
 	}
 }
@@ -10,9 +10,17 @@ namespace Epoch::Scenes
 	public:
 		SceneSerializer(const std::shared_ptr<Scene>& aScene) : myScene(aScene) {}
 
+		// Diff friendly YAML, one entity per sequence entry in depth-first order with the parent referenced by UUID.
+		// Both directions stream, the writer emits straight to the file and the reader builds entities from the parser events,
+		// so no document tree is ever held in memory. Loading adds to what's already in the scene.
 		void SerializeText(const std::filesystem::path& aFilepath);
 		bool DeserializeText(const std::filesystem::path& aFilepath);
 
+		// Versioned binary format: every component pool is written as one contiguous block and names go into a string table.
+		// Loading maps the file and creates the entities in one batch straight from the blocks, added to what's already in the scene.
+		bool SerializeBinary(const std::filesystem::path& aFilepath);
+		bool DeserializeBinary(const std::filesystem::path& aFilepath);
+
 	private:
 		std::shared_ptr<Scene> myScene;
 	};
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include <entt/entt.hpp>
+#include "Components.h"
+#include "EntityIDMap.h"
+#include "SceneBVH.h"
+#include "TransformSystem.h"
+
+namespace Epoch::Scenes
+{
+	// One component pool in packed order, Components[i] belongs to Entities[i]
+	template<typename T>
+	struct ComponentPoolSnapshot
+	{
+		std::vector<entt::entity> Entities;
+		std::vector<T> Components;
+	};
+
+	// Copy of everything that makes up a Scene, taken by Scene::Snapshot() and put back by Scene::Restore().
+	// Entity handles, the UUID index and the hierarchy links all come back exactly as they were.
+	// Keeping one around and snapshotting into it again reuses its buffers.
+	class SceneSnapshot
+	{
+	public:
+		size_t GetEntityCount() const { return myAliveEntityCount; }
+
+	private:
+		// The entity pool including released entities, so their versions survive too
+		std::vector<entt::entity> myEntities;
+		size_t myAliveEntityCount = 0;
+
+		ComponentPoolSnapshot<IDComponent> myIDs;
+		ComponentPoolSnapshot<NameComponent> myNames;
+		ComponentPoolSnapshot<HierarchyComponent> myHierarchies;
+		ComponentPoolSnapshot<TransformComponent> myTransforms;
+		ComponentPoolSnapshot<WorldTransformComponent> myWorldTransforms;
+		ComponentPoolSnapshot<MeshRendererComponent> myMeshRenderers;
+
+		EntityIDMap myIDToEntityMap;
+		TransformSystem myTransformSystem;
+		SceneBVH myBVH;
+		bool myHierarchyChanged = false;
+
+		friend class Scene;
+	};
+}
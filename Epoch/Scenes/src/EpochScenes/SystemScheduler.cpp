@@ -0,0 +1,228 @@
+#include "SystemScheduler.h"
+#include <algorithm>
+#include <EpochCore/Profiler.h>
+#include "TransformSystem.h"
+
+namespace Epoch::Scenes
+{
+	namespace
+	{
+		bool ContainsAny(const std::vector<entt::id_type>& aTypes, const std::vector<entt::id_type>& aOthers)
+		{
+			for (entt::id_type type : aTypes)
+			{
+				if (std::find(aOthers.begin(), aOthers.end(), type) != aOthers.end()) return true;
+			}
+			return false;
+		}
+	}
+
+	bool SystemAccess::ConflictsWith(const SystemAccess& aOther) const
+	{
+		if (Exclusive || aOther.Exclusive) return true;
+
+		return
+			ContainsAny(Writes, aOther.Writes) ||
+			ContainsAny(Writes, aOther.Reads) ||
+			ContainsAny(Reads, aOther.Writes);
+	}
+
+	bool SystemAccess::CanRead(entt::id_type aType) const
+	{
+		return std::find(Reads.begin(), Reads.end(), aType) != Reads.end() || CanWrite(aType);
+	}
+
+	bool SystemAccess::CanWrite(entt::id_type aType) const
+	{
+		return std::find(Writes.begin(), Writes.end(), aType) != Writes.end();
+	}
+
+	void SystemContext::MarkTransformDirty(entt::entity aEntity)
+	{
+		EPOCH_ASSERT(CanAccess<TransformComponent>(), "The system didn't declare write access to TransformComponent!");
+		myTransformSystem.MarkDirty(myRegistry, aEntity);
+	}
+
+	entt::registry& SystemContext::GetRegistry()
+	{
+		EPOCH_ASSERT(myAccess.Exclusive, "Only exclusive systems have access to the whole registry!");
+		return myRegistry;
+	}
+
+	SystemID SystemScheduler::Add(std::string_view aName, SystemAccess aAccess, SystemFunction aFunction)
+	{
+		const SystemID id = static_cast<SystemID>(mySystems.size());
+		mySystems.push_back({ std::string(aName), std::move(aAccess), std::move(aFunction) });
+		myGraphDirty = true;
+		return id;
+	}
+
+	void SystemScheduler::Remove(SystemID aSystem)
+	{
+		if (aSystem >= mySystems.size() || mySystems[aSystem].Removed) return;
+
+		// The ID isn't reused, the slot only keeps the other IDs stable
+		System& system = mySystems[aSystem];
+		system.Removed = true;
+		system.Access = {};
+		system.Function = nullptr;
+		myGraphDirty = true;
+	}
+
+	void SystemScheduler::SetThreadCount(uint32_t aCount)
+	{
+		myThreadCount = aCount;
+	}
+
+	size_t SystemScheduler::GetSystemCount() const
+	{
+		return static_cast<size_t>(std::count_if(mySystems.begin(), mySystems.end(), [](const System& aSystem) { return !aSystem.Removed; }));
+	}
+
+	std::vector<SystemID> SystemScheduler::GetDependencies(SystemID aSystem) const
+	{
+		std::vector<SystemID> dependencies;
+		if (aSystem >= mySystems.size() || mySystems[aSystem].Removed) return dependencies;
+
+		for (SystemID i = 0; i < aSystem; ++i)
+		{
+			if (!mySystems[i].Removed && mySystems[i].Access.ConflictsWith(mySystems[aSystem].Access))
+			{
+				dependencies.emplace_back(i);
+			}
+		}
+		return dependencies;
+	}
+
+	void SystemScheduler::BuildGraph()
+	{
+		EPOCH_PROFILE_FUNC();
+
+		myNodes.clear();
+		for (uint32_t i = 0; i < mySystems.size(); ++i)
+		{
+			if (!mySystems[i].Removed) myNodes.push_back({ i });
+		}
+
+		// Every conflicting pair gets an edge, also the ones already ordered through a system in between
+		for (uint32_t later = 0; later < myNodes.size(); ++later)
+		{
+			const SystemAccess& access = mySystems[myNodes[later].System].Access;
+			for (uint32_t earlier = 0; earlier < later; ++earlier)
+			{
+				if (mySystems[myNodes[earlier].System].Access.ConflictsWith(access))
+				{
+					myNodes[earlier].Dependents.emplace_back(later);
+					++myNodes[later].DependencyCount;
+				}
+			}
+		}
+
+		myPendingDependencies.resize(myNodes.size());
+		myReadyNodes.reserve(myNodes.size());
+		myGraphDirty = false;
+	}
+
+	void SystemScheduler::Run(entt::registry& aRegistry, TransformSystem& aTransformSystem, float aDeltaTime)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		if (myGraphDirty)
+		{
+			BuildGraph();
+		}
+
+		if (myNodes.empty()) return;
+
+		for (const Node& node : myNodes)
+		{
+			for (auto assure : mySystems[node.System].Access.AssureStorages)
+			{
+				assure(aRegistry);
+			}
+		}
+
+		myRegistry = &aRegistry;
+		myTransformSystem = &aTransformSystem;
+		myDeltaTime = aDeltaTime;
+
+		// Without workers a started job would run right away, with myMutex held
+		const uint32_t threadCount = std::min(myThreadCount > 0 ? myThreadCount : UINT32_MAX, Core::JobSystem::GetThreadCount());
+		myChainLimit = std::min(threadCount, static_cast<uint32_t>(myNodes.size()));
+
+		// Registration order is a valid order, every edge points to a later system
+		if (myChainLimit <= 1)
+		{
+			for (uint32_t i = 0; i < myNodes.size(); ++i)
+			{
+				Execute(i);
+			}
+			return;
+		}
+
+		{
+			std::scoped_lock lock(myMutex);
+
+			myReadyNodes.clear();
+			for (uint32_t i = 0; i < myNodes.size(); ++i)
+			{
+				myPendingDependencies[i] = myNodes[i].DependencyCount;
+				if (myNodes[i].DependencyCount == 0) myReadyNodes.emplace_back(i);
+			}
+			// Popped from the back, the earliest registered system goes first
+			std::reverse(myReadyNodes.begin(), myReadyNodes.end());
+
+			StartChains(0);
+		}
+
+		// The calling thread runs chains too while it waits
+		Core::JobSystem::Wait(myFrameCounter);
+	}
+
+	void SystemScheduler::Execute(uint32_t aNode)
+	{
+		const System& system = mySystems[myNodes[aNode].System];
+
+		EPOCH_PROFILE_SCOPE(system.Name.c_str());
+
+		SystemContext context(*myRegistry, *myTransformSystem, system.Access, myDeltaTime);
+		system.Function(context);
+	}
+
+	void SystemScheduler::StartChains(size_t aClaimed)
+	{
+		while (myRunningChains < myChainLimit && myReadyNodes.size() > myStartingChains + aClaimed)
+		{
+			++myRunningChains;
+			++myStartingChains;
+			Core::JobSystem::Run([this]() { RunChain(); }, &myFrameCounter);
+		}
+	}
+
+	void SystemScheduler::RunChain()
+	{
+		std::unique_lock lock(myMutex);
+		--myStartingChains;
+
+		// Another chain may have taken the system this one was started for
+		while (!myReadyNodes.empty())
+		{
+			const uint32_t node = myReadyNodes.back();
+			myReadyNodes.pop_back();
+
+			lock.unlock();
+			Execute(node);
+			lock.lock();
+
+			for (uint32_t dependent : myNodes[node].Dependents)
+			{
+				if (--myPendingDependencies[dependent] == 0) myReadyNodes.emplace_back(dependent);
+			}
+
+			// This chain goes on with one of the systems it readied, the others get chains of their own
+			StartChains(1);
+		}
+
+		--myRunningChains;
+	}
+}
@@ -0,0 +1,218 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <entt/entt.hpp>
+#include <EpochCore/Assert.h>
+#include <EpochCore/JobSystem.h>
+#include "Components.h"
+
+namespace Epoch::Scenes
+{
+	class TransformSystem;
+
+	// Component lists for Scene::RegisterSystem<Read<...>, Write<...>>()
+	template<typename... Components> struct Read {};
+	template<typename... Components> struct Write {};
+
+	using SystemID = uint32_t;
+	constexpr SystemID NullSystem = UINT32_MAX;
+
+	// The component types a system reads and writes. Two systems conflict if one of them writes a type the other one touches.
+	struct SystemAccess
+	{
+		std::vector<entt::id_type> Reads;
+		std::vector<entt::id_type> Writes;
+		// Creates the component pools before the systems run, the registry itself isn't safe to modify from several threads
+		std::vector<void(*)(entt::registry&)> AssureStorages;
+		// Runs alone with the whole registry, for systems that create or destroy entities or add and remove components
+		bool Exclusive = false;
+
+		template<typename ReadList, typename WriteList>
+		static SystemAccess Create();
+
+		bool ConflictsWith(const SystemAccess& aOther) const;
+		bool CanRead(entt::id_type aType) const;
+		bool CanWrite(entt::id_type aType) const;
+
+	private:
+		template<typename... Components> void AddReads(Read<Components...>);
+		template<typename... Components> void AddWrites(Write<Components...>);
+		template<typename Component> void Add(std::vector<entt::id_type>& outTypes);
+	};
+
+	// What a running system sees. Views and storages are only handed out for the declared components,
+	// read-only components have to be requested as const.
+	class SystemContext
+	{
+	public:
+		float GetDeltaTime() const { return myDeltaTime; }
+
+		template<typename... Components>
+		auto View();
+
+		template<typename Component>
+		auto& GetStorage();
+
+		// Needs write access to TransformComponent, which also gives write access to WorldTransformComponent
+		void MarkTransformDirty(entt::entity aEntity);
+
+		// Only for exclusive systems
+		entt::registry& GetRegistry();
+
+	private:
+		SystemContext(entt::registry& aRegistry, TransformSystem& aTransformSystem, const SystemAccess& aAccess, float aDeltaTime) :
+			myRegistry(aRegistry), myTransformSystem(aTransformSystem), myAccess(aAccess), myDeltaTime(aDeltaTime) {}
+
+		template<typename Component>
+		bool CanAccess() const;
+
+	private:
+		entt::registry& myRegistry;
+		TransformSystem& myTransformSystem;
+		const SystemAccess& myAccess;
+		float myDeltaTime;
+
+		friend class SystemScheduler;
+	};
+
+	// Runs the registered systems every frame. A system depends on every conflicting system registered before it,
+	// so the results are the same as running them one after another in registration order,
+	// while systems without a conflict between them run at the same time on the job system.
+	// The calling thread runs systems too and Run() returns once all of them are done.
+	class SystemScheduler
+	{
+	public:
+		using SystemFunction = std::function<void(SystemContext&)>;
+
+		SystemScheduler() = default;
+		~SystemScheduler() = default;
+
+		SystemScheduler(const SystemScheduler&) = delete;
+		SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+		SystemID Add(std::string_view aName, SystemAccess aAccess, SystemFunction aFunction);
+		void Remove(SystemID aSystem);
+
+		void Run(entt::registry& aRegistry, TransformSystem& aTransformSystem, float aDeltaTime);
+
+		// Systems running at the same time at most, 1 runs everything on the calling thread. Defaults to the job system's thread count.
+		void SetThreadCount(uint32_t aCount);
+
+		size_t GetSystemCount() const;
+		// The systems aSystem waits for every frame
+		std::vector<SystemID> GetDependencies(SystemID aSystem) const;
+
+	private:
+		struct System
+		{
+			std::string Name;
+			SystemAccess Access;
+			SystemFunction Function;
+			bool Removed = false;
+		};
+
+		struct Node
+		{
+			uint32_t System;
+			uint32_t DependencyCount = 0;
+			std::vector<uint32_t> Dependents;	// Node indices
+		};
+
+		void BuildGraph();
+		void Execute(uint32_t aNode);
+		// Starts a job per ready system not yet claimed by one, aClaimed by the calling job, up to the thread count
+		void StartChains(size_t aClaimed);
+		// A job running ready systems one after another until there are none left
+		void RunChain();
+
+	private:
+		std::vector<System> mySystems;	// Indexed by SystemID
+		std::vector<Node> myNodes;		// Live systems in registration order
+		bool myGraphDirty = false;
+
+		uint32_t myThreadCount = 0;
+
+		// Per frame
+		entt::registry* myRegistry = nullptr;
+		TransformSystem* myTransformSystem = nullptr;
+		float myDeltaTime = 0.0f;
+		uint32_t myChainLimit = 0;
+		Core::JobCounter myFrameCounter;
+
+		// Only touched with myMutex held
+		std::vector<uint32_t> myPendingDependencies;
+		std::vector<uint32_t> myReadyNodes;
+		size_t myRunningChains = 0;
+		size_t myStartingChains = 0;	// Started but not yet running a system
+		std::mutex myMutex;
+	};
+
+	template<typename ReadList, typename WriteList>
+	inline SystemAccess SystemAccess::Create()
+	{
+		SystemAccess access;
+		access.AddReads(ReadList{});
+		access.AddWrites(WriteList{});
+		return access;
+	}
+
+	template<typename... Components>
+	inline void SystemAccess::AddReads(Read<Components...>)
+	{
+		(Add<Components>(Reads), ...);
+	}
+
+	template<typename... Components>
+	inline void SystemAccess::AddWrites(Write<Components...>)
+	{
+		(Add<Components>(Writes), ...);
+
+		// Changing a local transform marks the world transform dirty
+		if ((std::is_same_v<std::remove_const_t<Components>, TransformComponent> || ...))
+		{
+			Add<WorldTransformComponent>(Writes);
+		}
+	}
+
+	template<typename Component>
+	inline void SystemAccess::Add(std::vector<entt::id_type>& outTypes)
+	{
+		using Type = std::remove_const_t<Component>;
+		outTypes.emplace_back(entt::type_hash<Type>::value());
+		AssureStorages.emplace_back(+[](entt::registry& aRegistry) { aRegistry.storage<Type>(); });
+	}
+
+	template<typename Component>
+	inline bool SystemContext::CanAccess() const
+	{
+		const entt::id_type type = entt::type_hash<std::remove_const_t<Component>>::value();
+		return myAccess.Exclusive || (std::is_const_v<Component> ? myAccess.CanRead(type) : myAccess.CanWrite(type));
+	}
+
+	template<typename... Components>
+	inline auto SystemContext::View()
+	{
+		EPOCH_ASSERT((CanAccess<Components>() && ...), "The system didn't declare access to all of the view's components!");
+		return myRegistry.view<Components...>();
+	}
+
+	template<typename Component>
+	inline auto& SystemContext::GetStorage()
+	{
+		EPOCH_ASSERT(CanAccess<Component>(), "The system didn't declare access to the component!");
+		if constexpr (std::is_const_v<Component>)
+		{
+			return std::as_const(myRegistry.storage<std::remove_const_t<Component>>());
+		}
+		else
+		{
+			return myRegistry.storage<Component>();
+		}
+	}
+}
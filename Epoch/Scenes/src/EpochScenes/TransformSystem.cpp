@@ -0,0 +1,133 @@
+#include "TransformSystem.h"
+#include <algorithm>
+#include <EpochCore/JobSystem.h>
+#include <EpochCore/Profiler.h>
+#include "Components.h"
+
+namespace Epoch::Scenes
+{
+	namespace
+	{
+		// Fewer entities than this are cheaper to do on the calling thread than to hand out to the job system
+		constexpr uint32_t MinParallelBatchSize = 512;
+	}
+
+	void TransformSystem::MarkDirty(entt::registry& aRegistry, entt::entity aEntity)
+	{
+		auto* world = aRegistry.try_get<WorldTransformComponent>(aEntity);
+		if (!world || world->IsDirty) return;
+
+		world->IsDirty = true;
+		myDirtyEntities.emplace_back(aEntity);
+	}
+
+	void TransformSystem::Update(entt::registry& aRegistry)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		myUpdatedEntities.clear();
+
+		if (myDirtyEntities.empty()) return;
+
+		auto& worlds = aRegistry.storage<WorldTransformComponent>();
+		auto& hierarchies = aRegistry.storage<HierarchyComponent>();
+
+		for (auto& roots : myRootsPerDepth)
+		{
+			roots.clear();
+		}
+
+		// Only the dirty entities without a dirty ancestor start a walk, the rest are reached through their ancestor's subtree.
+		// No root is below another root, so no entity shows up twice on a level.
+		size_t levelCount = 0;
+		{
+			EPOCH_PROFILE_SCOPE("Find dirty roots");
+
+			for (entt::entity entity : myDirtyEntities)
+			{
+				if (!worlds.contains(entity) || !worlds.get(entity).IsDirty) continue;
+
+				bool hasDirtyAncestor = false;
+				for (entt::entity parent = hierarchies.get(entity).Parent; parent != entt::null; parent = hierarchies.get(parent).Parent)
+				{
+					if (worlds.get(parent).IsDirty)
+					{
+						hasDirtyAncestor = true;
+						break;
+					}
+				}
+
+				if (hasDirtyAncestor) continue;
+
+				const size_t depth = hierarchies.get(entity).Depth;
+
+				if (depth >= myRootsPerDepth.size())
+				{
+					myRootsPerDepth.resize(depth + 1);
+				}
+
+				myRootsPerDepth[depth].emplace_back(entity);
+				levelCount = std::max(levelCount, depth + 1);
+			}
+		}
+
+		myDirtyEntities.clear();
+		myLevel.clear();
+
+		for (size_t depth = 0; depth < levelCount || !myLevel.empty(); ++depth)
+		{
+			if (depth < levelCount)
+			{
+				myLevel.insert(myLevel.end(), myRootsPerDepth[depth].begin(), myRootsPerDepth[depth].end());
+			}
+
+			if (myLevel.empty()) continue;
+
+			UpdateLevel(aRegistry, myLevel);
+			myUpdatedEntities.insert(myUpdatedEntities.end(), myLevel.begin(), myLevel.end());
+
+			myNextLevel.clear();
+			for (entt::entity entity : myLevel)
+			{
+				for (entt::entity child = hierarchies.get(entity).FirstChild; child != entt::null; child = hierarchies.get(child).NextSibling)
+				{
+					myNextLevel.emplace_back(child);
+				}
+			}
+
+			std::swap(myLevel, myNextLevel);
+		}
+	}
+
+	void TransformSystem::UpdateLevel(entt::registry& aRegistry, const std::vector<entt::entity>& aLevel)
+	{
+		EPOCH_PROFILE_FUNC();
+
+		// The storages are looked up once here, the registry itself isn't safe to use from several threads
+		const auto& locals = aRegistry.storage<TransformComponent>();
+		const auto& hierarchies = aRegistry.storage<HierarchyComponent>();
+		auto& worlds = aRegistry.storage<WorldTransformComponent>();
+
+		auto update = [&locals, &hierarchies, &worlds](entt::entity aEntity)
+			{
+				WorldTransformComponent& world = worlds.get(aEntity);
+				const CU::Matrix4x4f local = locals.get(aEntity).LocalTransform.GetMatrix();
+
+				if (const entt::entity parent = hierarchies.get(aEntity).Parent; parent != entt::null)
+				{
+					world.Matrix = local * worlds.get(parent).Matrix;
+				}
+				else
+				{
+					world.Matrix = local;
+				}
+
+				world.IsDirty = false;
+			};
+
+		Core::JobSystem::ParallelFor(static_cast<uint32_t>(aLevel.size()), [&aLevel, &update](uint32_t aBegin, uint32_t aEnd)
+			{
+				std::for_each(aLevel.begin() + aBegin, aLevel.begin() + aEnd, update);
+			}, MinParallelBatchSize);
+	}
+}
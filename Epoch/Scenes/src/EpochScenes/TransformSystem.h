@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+#include <entt/entt.hpp>
+
+namespace Epoch::Scenes
+{
+	// Computes WorldTransformComponent::Matrix (local * parent world) for the subtrees below the entities marked dirty,
+	// everything else is never visited.
+	// The subtrees are walked one depth level at a time, an entity only reads its parent's matrix which was finished
+	// on the level above, so all entities on a level are updated in parallel.
+	class TransformSystem
+	{
+	public:
+		TransformSystem() = default;
+		~TransformSystem() = default;
+
+		// The entity and all of its descendants get new world matrices on the next Update().
+		void MarkDirty(entt::registry& aRegistry, entt::entity aEntity);
+
+		void Update(entt::registry& aRegistry);
+
+		size_t GetDirtyCount() const { return myDirtyEntities.size(); }
+		// Every entity that got a new world matrix in the last Update(), parents before their children
+		const std::vector<entt::entity>& GetUpdatedEntities() const { return myUpdatedEntities; }
+
+	private:
+		void UpdateLevel(entt::registry& aRegistry, const std::vector<entt::entity>& aLevel);
+
+	private:
+		std::vector<entt::entity> myDirtyEntities;
+		std::vector<entt::entity> myUpdatedEntities;
+
+		// Kept between updates so a frame doesn't allocate once the buffers have grown
+		std::vector<std::vector<entt::entity>> myRootsPerDepth;
+		std::vector<entt::entity> myLevel;
+		std::vector<entt::entity> myNextLevel;
+	};
+}
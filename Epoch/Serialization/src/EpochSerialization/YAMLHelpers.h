@@ -4,6 +4,9 @@
 #include <yaml-cpp/yaml.h>
 #pragma warning(pop)
 
+#include <charconv>
+#include <limits>
+#include <string_view>
 #include <CommonUtilities/Math/Vector/Vector.h>
 #include <CommonUtilities/Color.h>
 #include <EpochCore/UUID.h>
@@ -178,4 +181,33 @@ namespace Epoch
 		out << YAML::BeginSeq << aColor.r << aColor.g << aColor.b << aColor.a << YAML::EndSeq;
 		return out;
 	}
+
+	// Decodes a plain scalar without building a YAML::Node, for readers that handle the parser events themselves.
+	// Accepts what the emitter writes for arithmetic types, including .nan and .inf for floating point values.
+	template<typename T>
+	inline bool DecodeScalar(std::string_view aValue, T& outValue)
+	{
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			if (aValue == ".nan" || aValue == ".NaN" || aValue == ".NAN")
+			{
+				outValue = std::numeric_limits<T>::quiet_NaN();
+				return true;
+			}
+			if (aValue == ".inf" || aValue == ".Inf" || aValue == ".INF" || aValue == "+.inf")
+			{
+				outValue = std::numeric_limits<T>::infinity();
+				return true;
+			}
+			if (aValue == "-.inf" || aValue == "-.Inf" || aValue == "-.INF")
+			{
+				outValue = -std::numeric_limits<T>::infinity();
+				return true;
+			}
+		}
+
+		const char* end = aValue.data() + aValue.size();
+		const auto [last, error] = std::from_chars(aValue.data(), end, outValue);
+		return error == std::errc() && last == end;
+	}
 }
\ No newline at end of file
@@ -98,6 +98,14 @@ workspace "Epoch"
 		include "Runtime"
 	group ""
 
+	group "Benchmarks"
+		include "Benchmarks/AssetsBench"
+		include "Benchmarks/BenchmarkCore"
+		include "Benchmarks/CommonUtilitiesBench"
+		include "Benchmarks/CoreBench"
+		include "Benchmarks/ScenesBench"
+	group ""
+
 	group "Dependencies"
 		include "CommonUtilities"
 		include "vendor/GLFW"